@@ -1042,7 +1042,11 @@ namespace ngcomp
         << "integrators: " << endl;
   
     for (int i = 0; i < parts.Size(); i++)
-      ost << "  " << parts[i]->Name() << endl;
+      {
+        ost << "  " << parts[i]->Name() << endl;
+        if (auto fallback = parts[i]->GetSimdFallback())
+          ost << "    SIMD fallback in " << fallback->elements << " elements: " << fallback->what << endl;
+      }
   }
 
 
@@ -1702,6 +1706,9 @@ namespace ngcomp
                                        }
                                      catch (ExceptionNOSIMD & e)
                                        {
+                                         // symbolic integrators book their fallback themselves
+                                         if (!bfi.GetSimdFallback())
+                                           SIMDFallbacks::Record ("Assemble, " + bfi.Name(), e);
                                          done = false;
                                        }
                                    }
@@ -4462,6 +4469,148 @@ namespace ngcomp
     
     if (!MixedSpaces())
       {
+        // trace values on facets shared with other ranks are computed and
+        // sent first, the communication overlaps with the local element loops
+        auto comm = ma->GetCommunicator();
+        bool mpi_facets = comm.Size() > 1 && mpi_facet_parts.Size();
+        Array<MPI_Request> reqs;
+        Array<MPI_Request> reqr;
+        Array<int> cnt_in, cnt_per;
+        BitArray fine_facet;
+
+        auto mpi_facet_loop = [&] (int loop)
+          {
+            LocalHeap &lh(clh);
+            HeapReset hr(lh);
+            Array<int> elnums, elnums2, fnums, vnums;
+
+            cnt_in = 0;
+            cnt_per = 0;
+            for(auto facet:Range(ma->GetNFacets())) {
+              if(!fine_facet.Test(facet)) continue;
+              NodeId facet_id(StdNodeType(NT_FACET, ma->GetDimension()), facet);
+              auto fdps = ma->GetDistantProcs(facet_id);
+              //skip non-mpi facets
+              if (fdps.Size() == 0) continue;
+              auto d = fdps[0];
+              HeapReset hr(lh);
+
+              ma->GetFacetSurfaceElements (facet, elnums2);
+              ma->GetFacetElements(facet, elnums);
+              bool periodic_facet = elnums2.Size()!=0;
+              if (periodic_facet) { // dont double up on facets!
+                auto facet2 = ma->GetPeriodicFacet(facet);
+                if (facet>facet2) continue;
+              }
+              if (periodic_facet && !elnums.Size()) // use the identified facet!
+                {
+                  facet = ma->GetPeriodicFacet(facet);
+                  ma->GetFacetElements(facet, elnums);
+                  ma->GetFacetSurfaceElements (facet, elnums2);
+                }
+
+              ElementId eiv(VOL, elnums[0]);
+
+              fnums = ma->GetElFacets(eiv);
+              int facetnr = fnums.Pos(facet);
+
+              const FiniteElement & fel = fespace->GetFE (eiv, lh);
+
+              Array<int> dnums(fel.GetNDof(), lh);
+              vnums = ma->GetElVertices(eiv);
+
+              ElementTransformation & eltrans = ma->GetTrafo (eiv, lh);
+              fespace->GetDofNrs (eiv, dnums);
+
+              for(auto igt:mpi_facet_parts) {
+
+                FlatVector<SCAL> elx(dnums.Size()*this->fespace->GetDimension(), lh);
+                x.GetIndirect(dnums, elx);
+                FlatVector<SCAL> trace_values;
+                dynamic_cast<const FacetBilinearFormIntegrator*>(igt.get())->  
+                  CalcTraceValues(fel,facetnr,eltrans,vnums, trace_values, elx, lh);
+                if (loop == 0) {
+                  os_per[d] += trace_values.Size();
+                  if(periodic_facet) cnt_per[d] += trace_values.Size();
+                  else cnt_in[d] += trace_values.Size();
+                }
+                else if (loop == 1) {
+                  auto offset = periodic_facet ? (os_per[d] + cnt_per[d]) : cnt_in[d];
+                  FlatVector<SCAL> tmp(trace_values.Size(), &( send_table[d][offset] ));
+                  tmp = trace_values;
+                  if(periodic_facet) cnt_per[d] += trace_values.Size();
+                  else cnt_in[d] += trace_values.Size();
+                }
+                else {
+                  auto offset = periodic_facet ? (os_per[d] + cnt_per[d]) : cnt_in[d];
+                  FlatVector<SCAL> trace_other(trace_values.Size(), &( recv_table[d][offset] ));
+                  if(periodic_facet) cnt_per[d] += trace_values.Size();
+                  else cnt_in[d] += trace_values.Size();
+
+                  FlatVector<SCAL> ely(dnums.Size()*this->fespace->GetDimension(), lh);
+                  dynamic_cast<const FacetBilinearFormIntegrator*>(igt.get())->  
+                    ApplyFromTraceValues(fel,facetnr,eltrans,vnums, trace_other,  elx, ely, lh);
+
+                  y.AddIndirect(dnums, ely);
+                }
+              }
+            }
+
+            if(loop==0) {
+              send_table = Table<SCAL> (os_per);
+              recv_table = Table<SCAL> (os_per);
+              os_per = cnt_in;
+              for(auto r:send_table)
+                r = -1;
+              for(auto r:recv_table)
+                r = -2;
+              have_mpi_facet_data = true;
+            }
+            else if(loop==1) {
+              for(auto dp:Range(comm.Size()))
+                if(send_table[dp].Size()) {
+                  reqs.Append(comm.ISend(send_table[dp], dp, MPI_TAG_SOLVE));
+                  reqr.Append(comm.IRecv(recv_table[dp], dp, MPI_TAG_SOLVE));
+                }
+            }
+          };
+
+        if (mpi_facets)
+          {
+            RegionTimer rt(timerDGparallelfacets);
+
+            int mnp = comm.Size();
+            cnt_in.SetSize(mnp);
+            cnt_per.SetSize(mnp);
+            if(!have_mpi_facet_data) {
+              os_per = Array<int>(mnp);
+              os_per = 0;
+            }
+
+            size_t ne = ma->GetNE(VOL);
+            fine_facet.SetSize(ma->GetNFacets());
+            fine_facet.Clear();
+            for (int i = 0; i < ne; ++i) {
+              auto elfacets = ma->GetElFacets(ElementId(VOL,i));
+              for (auto f : elfacets) fine_facet.SetBit(f);
+            }
+            /** 
+                We can have surf-els without elements. If we just skip these, 
+                the order of facets can be jumbled between ranks.
+                So we include facets from surf-els and jump to the identified facet
+                (+ its local vol el) if on mpi-bnd.
+            **/
+            size_t nse = ma->GetNE(BND);
+            for (int i = 0; i < nse; ++i) {
+              auto selfacets = ma->GetElFacets(ElementId(BND, i));
+              for (auto f : selfacets) fine_facet.SetBit(f);
+            }
+
+            // sizes (first call only), then pack and post the messages
+            for (auto loop : (have_mpi_facet_data) ? Range(1,2) : Range(0,2))
+              mpi_facet_loop (loop);
+          }
+
         for (auto vb : { VOL, BND, BBND, BBBND } )
           if (VB_parts[vb].Size())
             {
@@ -4822,145 +4971,14 @@ namespace ngcomp
         }
 
 	
-        // #ifdef PARALLEL
-        auto comm = ma->GetCommunicator();
-	if (comm.Size() > 1 && mpi_facet_parts.Size())
+        // receive the neighbours' trace values and apply the MPI facet terms
+	if (mpi_facets)
 	  {
 	    RegionTimer rt(timerDGparallelfacets);
-        HeapReset hr(clh);
-	    
-	    //cout << "apply parallel DG facets, " << elementwise_skeleton_parts.Size() << " el-bound and " << facetwise_skeleton_parts[VOL].Size() << " facet parts" << ", " << mpi_facet_parts.Size() << " total parts " << endl;
-
-            // int mrank = comm.Rank();
-            int mnp = comm.Size();
-	    Array<int> cnt_in(mnp), cnt_per(mnp);
-	    if(!have_mpi_facet_data) {
-	      os_per = Array<int>(mnp);
-	      os_per = 0;
-	    }
-	    Array<MPI_Request> reqs;
-	    Array<MPI_Request> reqr;
-	    LocalHeap &lh(clh);
-	    Array<int> elnums(2, lh), elnums2(2, lh), fnums(6, lh), vnums(8, lh);
-
-	    size_t ne = ma->GetNE(VOL);
-	    BitArray fine_facet(ma->GetNFacets());
-	    fine_facet.Clear();
-	    Array<int> elfacets;
-	    for (int i = 0; i < ne; ++i) {
-	      auto elfacets = ma->GetElFacets(ElementId(VOL,i));
-	      for (auto f : elfacets) fine_facet.SetBit(f);
-	    }
-	    /** 
-		We can have surf-els without elements. If we just skip these, 
-		the order of facets can be jumbled between ranks.
-		So we include facets from surf-els and jump to the identified facet
-		(+ its local vol el) if on mpi-bnd.
-	    **/
-	    size_t nse = ma->GetNE(BND);
-	    for (int i = 0; i < nse; ++i) {
-	      auto selfacets = ma->GetElFacets(ElementId(BND, i));
-	      for (auto f : selfacets) fine_facet.SetBit(f);
-	    }
-
-	    auto mpi_loop_range = (have_mpi_facet_data)?Range(1,3):Range(0,3);
-	    
-	    for(auto loop:mpi_loop_range) {
-	      cnt_in = 0;
-	      cnt_per = 0;
-	      for(auto facet:Range(ma->GetNFacets())) {
-		if(!fine_facet.Test(facet)) continue;
-		NodeId facet_id(StdNodeType(NT_FACET, ma->GetDimension()), facet);
-		auto fdps = ma->GetDistantProcs(facet_id);
-		//skip non-mpi facets
-		if (fdps.Size() == 0) continue;
-		auto d = fdps[0];
-		HeapReset hr(lh);
-
-		ma->GetFacetSurfaceElements (facet, elnums2);
-		ma->GetFacetElements(facet, elnums);
-		bool periodic_facet = elnums2.Size()!=0;
-		if (periodic_facet) { // dont double up on facets!
-		  auto facet2 = ma->GetPeriodicFacet(facet);
-		  if (facet>facet2) continue;
-		}
-		if (periodic_facet && !elnums.Size()) // use the identified facet!
-		  {
-		    facet = ma->GetPeriodicFacet(facet);
-		    ma->GetFacetElements(facet, elnums);
-		    ma->GetFacetSurfaceElements (facet, elnums2);
-		  }
-
-		ElementId eiv(VOL, elnums[0]);
-
-		fnums = ma->GetElFacets(eiv);
-		int facetnr = fnums.Pos(facet);
-
-		const FiniteElement & fel = fespace->GetFE (eiv, lh);
-		
-		
-		Array<int> dnums(fel.GetNDof(), lh);
-		vnums = ma->GetElVertices(eiv);
-
-		ElementTransformation & eltrans = ma->GetTrafo (eiv, lh);
-		fespace->GetDofNrs (eiv, dnums);
-
-		for(auto igt:mpi_facet_parts) {
-
-		  FlatVector<SCAL> elx(dnums.Size()*this->fespace->GetDimension(), lh);
-		  x.GetIndirect(dnums, elx);
-		  FlatVector<SCAL> trace_values;
-		  dynamic_cast<const FacetBilinearFormIntegrator*>(igt.get())->  
-		    CalcTraceValues(fel,facetnr,eltrans,vnums, trace_values, elx, lh);
-		  if (loop == 0) {
-		    os_per[d] += trace_values.Size();
-		    if(periodic_facet) cnt_per[d] += trace_values.Size();
-		    else cnt_in[d] += trace_values.Size();
-		  }
-		  else if (loop == 1) {
-		    auto offset = periodic_facet ? (os_per[d] + cnt_per[d]) : cnt_in[d];
-		    FlatVector<SCAL> tmp(trace_values.Size(), &( send_table[d][offset] ));
-		    tmp = trace_values;
-		    if(periodic_facet) cnt_per[d] += trace_values.Size();
-		    else cnt_in[d] += trace_values.Size();
-		  }
-		  else {
-		    auto offset = periodic_facet ? (os_per[d] + cnt_per[d]) : cnt_in[d];
-		    FlatVector<SCAL> trace_other(trace_values.Size(), &( recv_table[d][offset] ));
-		    if(periodic_facet) cnt_per[d] += trace_values.Size();
-		    else cnt_in[d] += trace_values.Size();
-
-		    FlatVector<SCAL> ely(dnums.Size()*this->fespace->GetDimension(), lh);
-		    dynamic_cast<const FacetBilinearFormIntegrator*>(igt.get())->  
-		      ApplyFromTraceValues(fel,facetnr,eltrans,vnums, trace_other,  elx, ely, lh);
-			
-		    y.AddIndirect(dnums, ely);
-		  }
-		}		
-	      }
-	      
-	      if(loop==0) {
-		send_table = Table<SCAL> (os_per);
-		recv_table = Table<SCAL> (os_per);
-		os_per = cnt_in;
-		for(auto r:send_table)
-		  r = -1;
-		for(auto r:recv_table)
-		  r = -2;
-		have_mpi_facet_data = true;
-	      }
-	      else if(loop==1) {
-		for(auto dp:Range(mnp))
-		  if(send_table[dp].Size()) {
-		    reqs.Append(comm.ISend(send_table[dp], dp, MPI_TAG_SOLVE));
-		    reqr.Append(comm.IRecv(recv_table[dp], dp, MPI_TAG_SOLVE));
-		  }
-		MyMPI_WaitAll(reqr);
-	      }
-	    }
+	    MyMPI_WaitAll(reqr);
+            mpi_facet_loop (2);
 	    if(reqs.Size()) MyMPI_WaitAll(reqs);
 	  }
-        // #endif
 
         static mutex specelmutex;
         if (specialelements.Size())
@@ -5389,7 +5407,8 @@ namespace ngcomp
                           hhmelxi.Rows(myrange) = melx.Rows(myrange) * hbmatx;
                         });
                       melxi.Append (std::move(hmelxi));
-                      tx.AddFlops (elclass_inds.Size()*hbmatx.Height()*hbmatx.Width());
+                      size_t n = elclass_inds.Size(), k = hbmatx.Height(), m = hbmatx.Width();
+                      AddWork (tx, 2.0*n*k*m, (n*k + k*m + n*m) * sizeof(double));
                     }
                 }
 
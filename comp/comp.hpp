@@ -82,6 +82,7 @@ namespace ngcomp
 #include "facetsurffespace.hpp"
 #include "normalfacetsurfacefespace.hpp"
 #include "fesconvert.hpp"
+#include "explicitdg.hpp"
 
 // #include "bddc.hpp"
 #include "vtkoutput.hpp"
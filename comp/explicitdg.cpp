@@ -0,0 +1,493 @@
+#include <comp.hpp>
+#include "explicitdg.hpp"
+
+namespace ngcomp
+{
+
+  ExplicitDGOperator ::
+  ExplicitDGOperator (shared_ptr<FESpace> afes,
+                      shared_ptr<SumOfIntegrals> igls,
+                      shared_ptr<CoefficientFunction> arho,
+                      bool ainverse_mass,
+                      size_t heapsize)
+    : fes(afes), ma(afes->GetMeshAccess()), rho(arho), inverse_mass(ainverse_mass),
+      lh(heapsize, "ExplicitDGOperator", true)
+  {
+    static Timer t("ExplicitDGOperator - setup"); RegionTimer reg(t);
+
+    if (ma->GetCommunicator().Size() > 1)
+      throw Exception ("ExplicitDGOperator: MPI-parallel spaces not supported");
+    if (fes->IsComplex())
+      throw Exception ("ExplicitDGOperator: complex spaces not supported");
+    if (rho && rho->Dimension() != 1)
+      throw Exception ("ExplicitDGOperator needs a scalar density");
+
+    for (auto icf : igls->icfs)
+      {
+        auto bfi = icf->MakeBilinearFormIntegrator();
+        auto & dx = icf->dx;
+        if (dx.definedon)
+          if (auto definedon_string = get_if<string> (&*dx.definedon); definedon_string)
+            {
+              Region reg(ma, dx.vb, *definedon_string);
+              bfi->SetDefinedOn(reg.Mask());
+            }
+
+        if (bfi->SkeletonForm())
+          {
+            auto fbfi = dynamic_pointer_cast<FacetBilinearFormIntegrator> (bfi);
+            if (!fbfi) throw Exception ("not a FacetBFI");
+            if (bfi->GetDGFormulation().element_boundary)
+              element_boundary_parts += fbfi;
+            else
+              {
+                if (bfi->VB() > BND) throw Exception ("skeletonform makes sense only for VOL or BND");
+                facet_parts[bfi->VB()] += fbfi;
+              }
+          }
+        else
+          {
+            if (bfi->VB() != VOL)
+              throw Exception ("ExplicitDGOperator: boundary terms need skeleton=True");
+            volume_parts += bfi;
+          }
+      }
+
+    size_t ne = ma->GetNE(VOL);
+    int dim = fes->GetDimension();
+
+    // the fused element sweep writes y without atomics
+    Array<int> dofcnt(fes->GetNDof());
+    dofcnt = 0;
+    Array<DofId> dnums;
+    diag_mass = true;
+    for (size_t i = 0; i < ne; i++)
+      {
+        HeapReset hr(lh);
+        ElementId ei(VOL, i);
+        fes->GetDofNrs (ei, dnums);
+        for (auto d : dnums)
+          if (IsRegularDof(d))
+            if (++dofcnt[d] > 1)
+              throw Exception ("ExplicitDGOperator requires element-local (discontinuous) dofs");
+        // only DG elements have orthogonal shapes, e.g. not discontinuous H1
+        auto & fel = fes->GetFE(ei, lh);
+        bool dgel = SwitchET<ET_SEGM,ET_TRIG,ET_QUAD,ET_TET,ET_PRISM,ET_PYRAMID,ET_HEX>
+          (fel.ElementType(), [&fel] (auto et)
+           { return dynamic_cast<const DGFiniteElement<et.ElementType()>*> (&fel) != nullptr; });
+        if (!dgel) diag_mass = false;
+      }
+
+    // facet -> element maps
+    Array<int> elnums, elnums_per, selnums;
+    for (size_t f = 0; f < ma->GetNFacets(); f++)
+      {
+        ma->GetFacetElements (f, elnums);
+        if (elnums.Size() == 0) continue;  // coarse facets
+
+        FacetInfo fi;
+        fi.facet = f;
+        fi.el1 = elnums[0];
+        fi.facnr1 = ma->GetElFacets(ElementId(VOL, fi.el1)).Pos(f);
+        fi.el2 = -1;
+        fi.facnr2 = -1;
+        fi.sel = -1;
+
+        int facet2 = f;
+        if (elnums.Size() < 2)
+          {
+            facet2 = ma->GetPeriodicFacet(f);
+            if (facet2 < int(f)) continue;   // handled from the periodic partner
+            if (facet2 > int(f))
+              {
+                ma->GetFacetElements (facet2, elnums_per);
+                if (elnums_per.Size() > 1)
+                  throw Exception("ExplicitDGOperator: invalid periodicity");
+                elnums.Append (elnums_per[0]);
+              }
+          }
+
+        if (elnums.Size() == 2)
+          {
+            fi.el2 = elnums[1];
+            fi.facnr2 = ma->GetElFacets(ElementId(VOL, fi.el2)).Pos(facet2);
+          }
+        else
+          {
+            ma->GetFacetSurfaceElements (f, selnums);
+            if (selnums.Size()) fi.sel = selnums[0];
+          }
+        facets.Append (fi);
+      }
+
+    TableCreator<int> creator(ne);
+    for ( ; !creator.Done(); creator++)
+      for (auto i : Range(facets))
+        {
+          creator.Add (facets[i].el1, i);
+          if (facets[i].el2 != -1)
+            creator.Add (facets[i].el2, i);
+        }
+    element_facets = creator.MoveTable();
+
+    // facet buffer: one block of element size per (facet, element) pair
+    auto elsize = [&] (int el)
+      {
+        fes->GetDofNrs (ElementId(VOL, el), dnums);
+        return dnums.Size() * dim;
+      };
+
+    size_t bufsize = 0;
+    if (facet_parts[VOL].Size() || facet_parts[BND].Size())
+      for (auto & fi : facets)
+        {
+          fi.offset1 = bufsize;
+          bufsize += elsize(fi.el1);
+          fi.offset2 = bufsize;
+          if (fi.el2 != -1)
+            bufsize += elsize(fi.el2);
+        }
+    facet_buffer.SetSize(bufsize);
+
+    if (inverse_mass && !diag_mass)
+      {
+        if (rho)
+          throw Exception ("ExplicitDGOperator: density only supported for DG elements");
+        auto massbfi = fes->GetIntegrator(VOL);
+        if (!massbfi)
+          throw Exception ("ExplicitDGOperator: space provides no mass integrator");
+
+        first_invmass.SetSize(ne+1);
+        first_invmass[0] = 0;
+        for (size_t i = 0; i < ne; i++)
+          first_invmass[i+1] = first_invmass[i] + sqr(elsize(i));
+        invmass.SetSize(first_invmass[ne]);
+
+        ParallelForRange
+          (ne, [&] (IntRange r)
+           {
+             LocalHeap slh = lh.Split();
+             for (auto i : r)
+               {
+                 HeapReset hr(slh);
+                 ElementId ei(VOL, i);
+                 auto & fel = fes->GetFE(ei, slh);
+                 auto & trafo = ma->GetTrafo(ei, slh);
+                 size_t n = first_invmass[i+1]-first_invmass[i];
+                 n = size_t(sqrt(double(n))+0.5);
+                 FlatMatrix<double> elmat(n, n, &invmass[first_invmass[i]]);
+                 massbfi->CalcElementMatrix (fel, trafo, elmat, slh);
+                 CalcInverse (elmat);
+               }
+           });
+      }
+  }
+
+
+  AutoVector ExplicitDGOperator :: CreateRowVector () const
+  {
+    return CreateBaseVector(fes->GetNDof(), fes->IsComplex(), fes->GetDimension());
+  }
+
+  AutoVector ExplicitDGOperator :: CreateColVector () const
+  {
+    return CreateBaseVector(fes->GetNDof(), fes->IsComplex(), fes->GetDimension());
+  }
+
+
+  void ExplicitDGOperator :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    y = 0.0;
+    MultAdd (1, x, y);
+  }
+
+
+  void ExplicitDGOperator :: MultAdd (double val, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("ExplicitDGOperator::MultAdd"); RegionTimer reg(t);
+    HeapReset hr(lh);
+    ApplyFacets (x, lh);
+    ApplyElements (val, x, y, lh);
+  }
+
+
+  void ExplicitDGOperator :: ApplyFacets (const BaseVector & x, LocalHeap & clh) const
+  {
+    if (facet_buffer.Size() == 0) return;
+    static Timer t("ExplicitDGOperator - facets"); RegionTimer reg(t);
+
+    int dim = fes->GetDimension();
+    FlatVector<double> fb(facet_buffer.Size(), facet_buffer.Data());
+
+    ParallelForRange
+      (facets.Size(), [&] (IntRange r)
+       {
+         LocalHeap lh = clh.Split();
+         Array<int> vnums1, vnums2;
+         for (auto i : r)
+           {
+             HeapReset hr(lh);
+             auto & fi = facets[i];
+             ElementId ei1(VOL, fi.el1);
+             auto & fel1 = fes->GetFE (ei1, lh);
+             auto & trafo1 = ma->GetTrafo (ei1, lh);
+             Array<DofId> dnums1(fel1.GetNDof(), lh);
+             fes->GetDofNrs (ei1, dnums1);
+             vnums1 = ma->GetElVertices (ei1);
+             size_t n1 = dnums1.Size()*dim;
+
+             if (fi.el2 == -1)
+               {
+                 auto ely = fb.Range(fi.offset1, fi.offset1+n1);
+                 ely = 0.0;
+                 if (fi.sel == -1 || facet_parts[BND].Size() == 0) continue;
+
+                 ElementId sei(BND, fi.sel);
+                 auto & strafo = ma->GetTrafo (sei, lh);
+                 vnums2 = ma->GetElVertices (sei);
+
+                 FlatVector<double> elx(n1, lh), hely(n1, lh);
+                 x.GetIndirect (dnums1, elx);
+                 fes->TransformVec (ei1, elx, TRANSFORM_SOL);
+
+                 for (auto & bfi : facet_parts[BND])
+                   {
+                     if (!bfi->DefinedOn (strafo.GetElementIndex())) continue;
+                     if (!bfi->DefinedOnElement (fi.facet)) continue;
+                     auto & mapped_trafo = trafo1.AddDeformation(bfi->GetDeformation().get(), lh);
+                     auto & mapped_strafo = strafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                     bfi->ApplyFacetMatrix (fel1, fi.facnr1, mapped_trafo, vnums1,
+                                            mapped_strafo, vnums2, elx, hely, lh);
+                     ely += hely;
+                   }
+                 fes->TransformVec (ei1, ely, TRANSFORM_RHS);
+                 continue;
+               }
+
+             ElementId ei2(VOL, fi.el2);
+             auto & fel2 = fes->GetFE (ei2, lh);
+             auto & trafo2 = ma->GetTrafo (ei2, lh);
+             Array<DofId> dnums2(fel2.GetNDof(), lh);
+             fes->GetDofNrs (ei2, dnums2);
+             vnums2 = ma->GetElVertices (ei2);
+             size_t n2 = dnums2.Size()*dim;
+
+             auto ely1 = fb.Range(fi.offset1, fi.offset1+n1);
+             auto ely2 = fb.Range(fi.offset2, fi.offset2+n2);
+             ely1 = 0.0;
+             ely2 = 0.0;
+             if (facet_parts[VOL].Size() == 0) continue;
+
+             FlatVector<double> elx(n1+n2, lh), ely(n1+n2, lh);
+             x.GetIndirect (dnums1, elx.Range(0, n1));
+             x.GetIndirect (dnums2, elx.Range(n1, n1+n2));
+             fes->TransformVec (ei1, elx.Range(0, n1), TRANSFORM_SOL);
+             fes->TransformVec (ei2, elx.Range(n1, n1+n2), TRANSFORM_SOL);
+
+             for (auto & bfi : facet_parts[VOL])
+               {
+                 if (!bfi->DefinedOn (trafo1.GetElementIndex())) continue;
+                 if (!bfi->DefinedOn (trafo2.GetElementIndex())) continue;
+                 if (!bfi->DefinedOnElement (fi.facet)) continue;
+
+                 auto & mapped_trafo1 = trafo1.AddDeformation(bfi->GetDeformation().get(), lh);
+                 auto & mapped_trafo2 = trafo2.AddDeformation(bfi->GetDeformation().get(), lh);
+                 bfi->ApplyFacetMatrix (fel1, fi.facnr1, mapped_trafo1, vnums1,
+                                        fel2, fi.facnr2, mapped_trafo2, vnums2, elx, ely, lh);
+                 ely1 += ely.Range(0, n1);
+                 ely2 += ely.Range(n1, n1+n2);
+               }
+             fes->TransformVec (ei1, ely1, TRANSFORM_RHS);
+             fes->TransformVec (ei2, ely2, TRANSFORM_RHS);
+           }
+       });
+  }
+
+
+  void ExplicitDGOperator :: ApplyElements (double val, const BaseVector & x, BaseVector & y,
+                                            LocalHeap & clh) const
+  {
+    static Timer t("ExplicitDGOperator - elements"); RegionTimer reg(t);
+
+    int dim = fes->GetDimension();
+    FlatVector<double> fb(facet_buffer.Size(), facet_buffer.Data());
+
+    ParallelForRange
+      (ma->GetNE(VOL), [&] (IntRange r)
+       {
+         LocalHeap lh = clh.Split();
+         Array<int> vnums1, vnums2;
+         for (auto el : r)
+           {
+             HeapReset hr(lh);
+             ElementId ei(VOL, el);
+             auto & fel = fes->GetFE (ei, lh);
+             auto & trafo = ma->GetTrafo (ei, lh);
+             Array<DofId> dnums(fel.GetNDof(), lh);
+             fes->GetDofNrs (ei, dnums);
+             size_t n = dnums.Size()*dim;
+
+             FlatVector<double> elx(n, lh), ely(n, lh), sum(n, lh);
+             x.GetIndirect (dnums, elx);
+             fes->TransformVec (ei, elx, TRANSFORM_SOL);
+             sum = 0.0;
+
+             for (auto & bfi : volume_parts)
+               {
+                 if (!bfi->DefinedOn (trafo.GetElementIndex())) continue;
+                 if (!bfi->DefinedOnElement (el)) continue;
+                 auto & mapped_trafo = trafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                 bfi->ApplyElementMatrix (fel, mapped_trafo, elx, ely, 0, lh);
+                 sum += ely;
+               }
+
+             if (element_boundary_parts.Size())
+               {
+                 vnums1 = ma->GetElVertices (ei);
+                 for (auto k : element_facets[el])
+                   {
+                     HeapReset hrf(lh);
+                     auto & fi = facets[k];
+                     bool first = (fi.el1 == el);
+                     int facnr1 = first ? fi.facnr1 : fi.facnr2;
+
+                     if (fi.el2 == -1)
+                       {
+                         if (fi.sel == -1) continue;
+                         ElementId sei(BND, fi.sel);
+                         auto & strafo = ma->GetTrafo (sei, lh);
+                         vnums2 = ma->GetElVertices (sei);
+                         for (auto & bfi : element_boundary_parts)
+                           {
+                             if (!bfi->DefinedOn (strafo.GetElementIndex())) continue;
+                             if (!bfi->DefinedOnElement (el)) continue;
+                             auto & mapped_trafo = trafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                             auto & mapped_strafo = strafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                             bfi->ApplyFacetMatrix (fel, facnr1, mapped_trafo, vnums1,
+                                                    mapped_strafo, vnums2, elx, ely, lh);
+                             sum += ely;
+                           }
+                         continue;
+                       }
+
+                     ElementId ei2(VOL, first ? fi.el2 : fi.el1);
+                     int facnr2 = first ? fi.facnr2 : fi.facnr1;
+                     auto & fel2 = fes->GetFE (ei2, lh);
+                     auto & trafo2 = ma->GetTrafo (ei2, lh);
+                     Array<DofId> dnums2(fel2.GetNDof(), lh);
+                     fes->GetDofNrs (ei2, dnums2);
+                     vnums2 = ma->GetElVertices (ei2);
+                     size_t n2 = dnums2.Size()*dim;
+
+                     FlatVector<double> elx12(n+n2, lh), ely12(n+n2, lh);
+                     elx12.Range(0, n) = elx;
+                     x.GetIndirect (dnums2, elx12.Range(n, n+n2));
+                     fes->TransformVec (ei2, elx12.Range(n, n+n2), TRANSFORM_SOL);
+
+                     for (auto & bfi : element_boundary_parts)
+                       {
+                         if (!bfi->DefinedOn (trafo.GetElementIndex())) continue;
+                         if (!bfi->DefinedOn (trafo2.GetElementIndex())) continue;
+                         if (!bfi->DefinedOnElement (el)) continue;
+
+                         auto & mapped_trafo1 = trafo.AddDeformation(bfi->GetDeformation().get(), lh);
+                         auto & mapped_trafo2 = trafo2.AddDeformation(bfi->GetDeformation().get(), lh);
+                         bfi->ApplyFacetMatrix (fel, facnr1, mapped_trafo1, vnums1,
+                                                fel2, facnr2, mapped_trafo2, vnums2, elx12, ely12, lh);
+                         sum += ely12.Range(0, n);
+
+                         if (bfi->GetDGFormulation().neighbor_testfunction)
+                           {
+                             FlatVector<double> swap_elx(n+n2, lh);
+                             swap_elx.Range(0, n2) = elx12.Range(n, n+n2);
+                             swap_elx.Range(n2, n+n2) = elx;
+                             bfi->ApplyFacetMatrix (fel2, facnr2, mapped_trafo2, vnums2,
+                                                    fel, facnr1, mapped_trafo1, vnums1, swap_elx, ely12, lh);
+                             sum += ely12.Range(n2, n+n2);
+                           }
+                       }
+                   }
+               }
+
+             // gather contributions of the facet sweep
+             if (fb.Size())
+               for (auto k : element_facets[el])
+                 {
+                   auto & fi = facets[k];
+                   size_t offset = (fi.el1 == el) ? fi.offset1 : fi.offset2;
+                   sum += fb.Range(offset, offset+n);
+                 }
+
+             fes->TransformVec (ei, sum, TRANSFORM_RHS);
+             if (inverse_mass)
+               SolveElementMass (ei, fel, trafo, sum, lh);
+             sum *= val;
+             y.AddIndirect (dnums, sum);
+           }
+       });
+  }
+
+
+  void ExplicitDGOperator :: SolveElementMass (ElementId ei, const FiniteElement & bfel,
+                                               const ElementTransformation & trafo,
+                                               FlatVector<double> elx, LocalHeap & lh) const
+  {
+    if (!diag_mass)
+      {
+        size_t n = elx.Size();
+        FlatMatrix<double> minv(n, n, const_cast<double*>(&invmass[first_invmass[ei.Nr()]]));
+        FlatVector<double> hx(n, lh);
+        hx = minv * elx;
+        elx = hx;
+        return;
+      }
+
+    // same as L2HighOrderFESpace::SolveM, but for one element
+    auto & fel = static_cast<const BaseScalarFiniteElement&>(bfel);
+    int dim = fes->GetDimension();
+    auto melx = elx.AsMatrix(fel.GetNDof(), dim);
+
+    FlatVector<double> diag_mass(fel.GetNDof(), lh);
+    fel.GetDiagMassMatrix (diag_mass);
+
+    bool curved = trafo.IsCurvedElement();
+    if (rho && !rho->ElementwiseConstant()) curved = true;
+
+    if (!curved)
+      {
+        IntegrationRule ir(fel.ElementType(), 0);
+        BaseMappedIntegrationRule & mir = trafo(ir, lh);
+        double jac = mir[0].GetMeasure();
+        if (rho) jac *= rho->Evaluate(mir[0]);
+        diag_mass *= jac;
+        for (int i = 0; i < melx.Height(); i++)
+          melx.Row(i) /= diag_mass(i);
+        return;
+      }
+
+    SIMD_IntegrationRule ir(fel.ElementType(), 2*fel.Order());
+    auto & mir = trafo(ir, lh);
+    FlatVector<SIMD<double>> pntvals(ir.Size(), lh);
+    FlatMatrix<SIMD<double>> rhovals(1, ir.Size(), lh);
+    if (rho) rho->Evaluate (mir, rhovals);
+
+    for (int i = 0; i < melx.Height(); i++)
+      melx.Row(i) /= diag_mass(i);
+    for (int comp = 0; comp < dim; comp++)
+      {
+        fel.Evaluate (ir, melx.Col(comp), pntvals);
+        if (rho)
+          for (size_t i = 0; i < ir.Size(); i++)
+            pntvals(i) *= ir[i].Weight() / (mir[i].GetMeasure() * rhovals(0,i));
+        else
+          for (size_t i = 0; i < ir.Size(); i++)
+            pntvals(i) *= ir[i].Weight() / mir[i].GetMeasure();
+
+        melx.Col(comp) = 0.0;
+        fel.AddTrans (ir, pntvals, melx.Col(comp));
+      }
+    for (int i = 0; i < melx.Height(); i++)
+      melx.Row(i) /= diag_mass(i);
+  }
+
+}
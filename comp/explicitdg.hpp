@@ -0,0 +1,82 @@
+#ifndef FILE_EXPLICITDG
+#define FILE_EXPLICITDG
+
+/*
+  Matrix-free operator for explicit DG time-stepping.
+
+  Computes  y += val * M^{-1} A x  for the operator A given by a
+  SumOfIntegrals consisting of volume terms and facet (skeleton) terms.
+
+  The facet terms are evaluated face by face, using the precomputed
+  facet -> (element, local facet number) maps.  Their element
+  contributions go to a facet buffer, which is gathered in the element
+  sweep together with the volume terms and the element-wise inverse
+  mass matrix. Thus there are no write conflicts and no coloring is
+  needed.
+*/
+
+namespace ngcomp
+{
+
+  class NGS_DLL_HEADER ExplicitDGOperator : public BaseMatrix
+  {
+    struct FacetInfo
+    {
+      int facet;               // facet number
+      int el1, el2;            // el2 = -1 for boundary facets
+      int facnr1, facnr2;      // local facet numbers
+      int sel;                 // surface element for boundary facets
+      size_t offset1, offset2; // position of element contributions in facet buffer
+    };
+
+    shared_ptr<FESpace> fes;
+    shared_ptr<MeshAccess> ma;
+    shared_ptr<CoefficientFunction> rho;
+    bool inverse_mass;
+    mutable LocalHeap lh;   // own heap, MultAdd must not reset the caller's heap
+
+    Array<shared_ptr<BilinearFormIntegrator>> volume_parts;
+    Array<shared_ptr<FacetBilinearFormIntegrator>> facet_parts[2];          // skeleton, VOL and BND
+    Array<shared_ptr<FacetBilinearFormIntegrator>> element_boundary_parts;
+
+    Array<FacetInfo> facets;
+    Table<int> element_facets;        // facets of element, index into facets
+    mutable Array<double> facet_buffer;
+
+    // dense inverse mass matrices unless all elements are DG elements with diagonal mass
+    Array<size_t> first_invmass;
+    Array<double> invmass;
+    bool diag_mass;
+
+  public:
+    ExplicitDGOperator (shared_ptr<FESpace> afes,
+                        shared_ptr<SumOfIntegrals> igls,
+                        shared_ptr<CoefficientFunction> arho,
+                        bool ainverse_mass,
+                        size_t heapsize);
+
+    virtual ~ExplicitDGOperator() { ; }
+
+    virtual bool IsComplex() const override { return false; }
+    virtual int VHeight() const override { return fes->GetNDof(); }
+    virtual int VWidth() const override { return fes->GetNDof(); }
+
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double val, const BaseVector & x, BaseVector & y) const override;
+
+    size_t GetNFacets() const { return facets.Size(); }
+
+  private:
+    void ApplyFacets (const BaseVector & x, LocalHeap & lh) const;
+    void ApplyElements (double val, const BaseVector & x, BaseVector & y, LocalHeap & lh) const;
+    void SolveElementMass (ElementId ei, const FiniteElement & fel,
+                           const ElementTransformation & trafo,
+                           FlatVector<double> elx, LocalHeap & lh) const;
+  };
+
+}
+
+#endif
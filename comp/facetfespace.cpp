@@ -59,10 +59,13 @@ namespace ngcomp
           fel_facet.Facet(facetnr).CalcShape(mir.IR(), 
                                              mat.Rows(fel_facet.GetFacetDofs(facetnr)));
         }
-      else
+      else if (mir.IR()[0].VB() == BND)
         {
-          throw ExceptionNOSIMD("facet-simd-bnd not ready");
+          const BaseScalarFiniteElement & fel_bnd = static_cast<const BaseScalarFiniteElement&> (fel);
+          fel_bnd.CalcShape (mir.IR(), mat);
         }
+      else
+        throw Exception("cannot evaluate facet-fe inside element, simd");
     }
 
     
@@ -73,12 +76,14 @@ namespace ngcomp
       const FacetVolumeFiniteElement<D> & fel_facet = static_cast<const FacetVolumeFiniteElement<D>&> (bfel);
 
       int facetnr = mir.IR()[0].FacetNr();
-      if (facetnr < 0)
-        throw Exception("cannot evaluate facet-fe inside element, apply simd");
-      else
+      if (facetnr >= 0)
         fel_facet.Facet(facetnr).Evaluate(mir.IR(),
                                           x.Range(fel_facet.GetFacetDofs(facetnr)),
                                           y.Row(0));
+      else if (mir.IR()[0].VB() == BND)
+        static_cast<const BaseScalarFiniteElement&> (bfel).Evaluate (mir.IR(), x, y.Row(0));
+      else
+        throw Exception("cannot evaluate facet-fe inside element, apply simd");
     }
 
     using DiffOp<DiffOpIdFacet<D>>::AddTransSIMDIR;          
@@ -88,12 +93,14 @@ namespace ngcomp
       const FacetVolumeFiniteElement<D> & fel_facet = static_cast<const FacetVolumeFiniteElement<D>&> (bfel);
 
       int facetnr = mir.IR()[0].FacetNr();
-      if (facetnr < 0)
-        throw Exception("cannot evaluate facet-fe inside element, add trans simd");
-      else
+      if (facetnr >= 0)
         fel_facet.Facet(facetnr).AddTrans(mir.IR(),
                                           y.Row(0),
                                           x.Range(fel_facet.GetFacetDofs(facetnr)));
+      else if (mir.IR()[0].VB() == BND)
+        static_cast<const BaseScalarFiniteElement&> (bfel).AddTrans (mir.IR(), y.Row(0), x);
+      else
+        throw Exception("cannot evaluate facet-fe inside element, add trans simd");
     }
 
     static shared_ptr<CoefficientFunction>
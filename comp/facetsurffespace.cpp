@@ -54,6 +54,63 @@ namespace ngcomp
         }
     }
 
+    static void GenerateMatrixSIMDIR (const FiniteElement & fel,
+                                      const SIMD_BaseMappedIntegrationRule & mir,
+                                      BareSliceMatrix<SIMD<double>> mat)
+    {
+      int facetnr = mir.IR()[0].FacetNr();
+      if (facetnr >= 0)
+        {
+          mat.AddSize(fel.GetNDof(), mir.Size()) = 0.0;
+          const FacetVolumeFiniteElement<D> & fel_facet = static_cast<const FacetVolumeFiniteElement<D>&> (fel);
+          fel_facet.Facet(facetnr).CalcShape(mir.IR(), 
+                                             mat.Rows(fel_facet.GetFacetDofs(facetnr)));
+        }
+      else if (mir.IR()[0].VB() == BND)
+        {
+          const BaseScalarFiniteElement & fel_bnd = static_cast<const BaseScalarFiniteElement&> (fel);
+          fel_bnd.CalcShape (mir.IR(), mat);
+        }
+      else
+        throw Exception("cannot evaluate facet-fe inside element, simd");
+    }
+
+    using DiffOp<DiffOpIdFacet_<D>>::ApplySIMDIR;          
+    static void ApplySIMDIR (const FiniteElement & bfel, const SIMD_BaseMappedIntegrationRule & mir,
+                             BareSliceVector<double> x, BareSliceMatrix<SIMD<double>> y)
+    {
+      int facetnr = mir.IR()[0].FacetNr();
+      if (facetnr >= 0)
+        {
+          const FacetVolumeFiniteElement<D> & fel_facet = static_cast<const FacetVolumeFiniteElement<D>&> (bfel);
+          fel_facet.Facet(facetnr).Evaluate(mir.IR(),
+                                            x.Range(fel_facet.GetFacetDofs(facetnr)),
+                                            y.Row(0));
+        }
+      else if (mir.IR()[0].VB() == BND)
+        static_cast<const BaseScalarFiniteElement&> (bfel).Evaluate (mir.IR(), x, y.Row(0));
+      else
+        throw Exception("cannot evaluate facet-fe inside element, apply simd");
+    }
+
+    using DiffOp<DiffOpIdFacet_<D>>::AddTransSIMDIR;          
+    static void AddTransSIMDIR (const FiniteElement & bfel, const SIMD_BaseMappedIntegrationRule & mir,
+                                BareSliceMatrix<SIMD<double>> y, BareSliceVector<double> x)
+    {
+      int facetnr = mir.IR()[0].FacetNr();
+      if (facetnr >= 0)
+        {
+          const FacetVolumeFiniteElement<D> & fel_facet = static_cast<const FacetVolumeFiniteElement<D>&> (bfel);
+          fel_facet.Facet(facetnr).AddTrans(mir.IR(),
+                                            y.Row(0),
+                                            x.Range(fel_facet.GetFacetDofs(facetnr)));
+        }
+      else if (mir.IR()[0].VB() == BND)
+        static_cast<const BaseScalarFiniteElement&> (bfel).AddTrans (mir.IR(), y.Row(0), x);
+      else
+        throw Exception("cannot evaluate facet-fe inside element, add trans simd");
+    }
+
     static shared_ptr<CoefficientFunction>
     DiffShape (shared_ptr<CoefficientFunction> proxy,
                shared_ptr<CoefficientFunction> dir,
@@ -109,9 +166,7 @@ namespace ngcomp
                                              mat.Rows(fel_facet.GetFacetDofs(facetnr)));
         }
       else
-        {
-          throw ExceptionNOSIMD("facet-simd-bnd not ready");
-        }
+        throw Exception("cannot evaluate facet-fe inside element, simd");
     }
 
     
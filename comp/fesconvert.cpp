@@ -518,6 +518,269 @@ namespace ngcomp
 
 
 
+  shared_ptr<BaseMatrix> MeshTransferOperator (shared_ptr<FESpace> space_a, shared_ptr<FESpace> space_b,
+                                               LocalHeap & clh, bool conservative, int bonus_intorder)
+  {
+    static Timer t ("MeshTransferOperator");
+    RegionTimer regt(t);
+
+    /** Maps gfa on the mesh of space_a to gfb on the mesh of space_b, the meshes need not match **/
+
+    if ( space_a->IsComplex() != space_b->IsComplex() )
+      { throw Exception("Cannot convert between complex and non-complex space!"); }
+    if ( space_a->IsParallel() || space_b->IsParallel() )
+      { throw Exception("MeshTransferOperator: distributed spaces are not supported!"); }
+    if ( (space_a->GetDimension() != 1) || (space_b->GetDimension() != 1) )
+      { throw Exception("MeshTransferOperator: multidim spaces are not supported!"); }
+
+    auto ma_a = space_a->GetMeshAccess();
+    auto eval_a = space_a->GetEvaluator(VOL), eval_b = space_b->GetEvaluator(VOL);
+    if ( !eval_a || !eval_b )
+      { throw Exception("MeshTransferOperator: spaces need volume evaluators!"); }
+    if ( (eval_a->Dim() != eval_b->Dim()) || (ma_a->GetDimension() != space_b->GetMeshAccess()->GetDimension()) )
+      { throw Exception(string("Cannot transfer from ") + space_a->GetClassName() + string(" to ") + space_b->GetClassName() +
+                        string(" - dimensions mismatch!")); }
+    int dim = eval_b->Dim();
+
+    { // the search tree is built by the first, sequential lookup
+      Vector<> p(ma_a->GetDimension());
+      p = 0.0;
+      IntegrationPoint rip;
+      ma_a->FindElementOfPoint (p, rip, true);
+    }
+
+    /** Element-wise L2 projection of the source function, shared dofs are averaged as in Set.
+        The conservative version assembles the mixed mass matrix and applies the global mass inverse. **/
+    Array<int> rows, cols, mrows, mcols;
+    Array<double> vals, mvals;
+    Array<int> cnt_b(space_b->GetNDof());
+    cnt_b = 0;
+    mutex triplet_mutex;
+
+    IterateElements
+      (*space_b, VOL, clh,
+       [&] (FESpace::Element el, LocalHeap & lh)
+       {
+         const FiniteElement & fel_b = el.GetFE();
+         auto dnums_b = el.GetDofs();
+         size_t nd_b = fel_b.GetNDof();
+         IntegrationRule ir(fel_b.ElementType(), 2*fel_b.Order() + bonus_intorder);
+         auto & mir = el.GetTrafo()(ir, lh);
+
+         /** Locate the points in the source mesh, collect the source dofs **/
+         FlatArray<int> elnrs(ir.Size(), lh);
+         Array<IntegrationPoint> rips(ir.Size());
+         Array<DofId> dnums_a, dofs_a;
+         for (size_t q = 0; q < ir.Size(); q++)
+           {
+             elnrs[q] = ma_a->FindElementOfPoint (mir[q].GetPoint(), rips[q], true);
+             if (elnrs[q] == -1)
+               { continue; }
+             ElementId ei_a(VOL, elnrs[q]);
+             if (!space_a->DefinedOn(ei_a))
+               { elnrs[q] = -1; continue; }
+             space_a->GetDofNrs (ei_a, dnums_a);
+             for (auto d : dnums_a)
+               if (IsRegularDof(d) && !dofs_a.Contains(d))
+                 { dofs_a.Append(d); }
+           }
+
+         FlatMatrix<> mbb(nd_b, nd_b, lh), mba(nd_b, dofs_a.Size(), lh);
+         FlatMatrix<double,ColMajor> bmat_b(dim, nd_b, lh);
+         mbb = 0.0;
+         mba = 0.0;
+         for (size_t q = 0; q < ir.Size(); q++)
+           {
+             HeapReset hr(lh);
+             double w = mir[q].GetWeight();
+             eval_b->CalcMatrix (fel_b, mir[q], bmat_b, lh);
+             mbb += w * Trans(bmat_b) * bmat_b;
+             if (elnrs[q] == -1)
+               { continue; }
+
+             ElementId ei_a(VOL, elnrs[q]);
+             const FiniteElement & fel_a = space_a->GetFE (ei_a, lh);
+             const ElementTransformation & trafo_a = ma_a->GetTrafo (ei_a, lh);
+             space_a->GetDofNrs (ei_a, dnums_a);
+             FlatMatrix<double,ColMajor> bmat_a(dim, fel_a.GetNDof(), lh);
+             eval_a->CalcMatrix (fel_a, trafo_a(rips[q], lh), bmat_a, lh);
+             FlatMatrix<> contrib(nd_b, fel_a.GetNDof(), lh);
+             contrib = w * Trans(bmat_b) * bmat_a;
+             for (size_t j = 0; j < dnums_a.Size(); j++)
+               if (IsRegularDof(dnums_a[j]))
+                 { mba.Col(dofs_a.Pos(dnums_a[j])) += contrib.Col(j); }
+           }
+
+         if (!conservative)
+           {
+             CalcInverse (mbb);
+             FlatMatrix<> emb(nd_b, dofs_a.Size(), lh);
+             emb = mbb * mba;
+             mba = emb;
+           }
+
+         lock_guard<mutex> guard(triplet_mutex);
+         for (size_t i = 0; i < nd_b; i++)
+           {
+             if (!IsRegularDof(dnums_b[i]))
+               { continue; }
+             cnt_b[dnums_b[i]]++;
+             for (size_t j = 0; j < dofs_a.Size(); j++)
+               {
+                 rows.Append (dnums_b[i]);
+                 cols.Append (dofs_a[j]);
+                 vals.Append (mba(i,j));
+               }
+             if (conservative)
+               for (size_t j = 0; j < nd_b; j++)
+                 if (IsRegularDof(dnums_b[j]))
+                   {
+                     mrows.Append (dnums_b[i]);
+                     mcols.Append (dnums_b[j]);
+                     mvals.Append (mbb(i,j));
+                   }
+           }
+       });
+
+    size_t ndof_a = space_a->GetNDof(), ndof_b = space_b->GetNDof();
+    shared_ptr<BaseMatrix> op;
+    if (conservative)
+      {
+        auto mass = dynamic_pointer_cast<SparseMatrix<double>>
+          (SparseMatrix<double>::CreateFromCOO (mrows, mcols, mvals, ndof_b, ndof_b));
+        auto used = make_shared<BitArray> (ndof_b);
+        used->Clear();
+        for (size_t i = 0; i < ndof_b; i++)
+          if (cnt_b[i])
+            { used->SetBit(i); }
+        mass->SetInverseType (SPARSECHOLESKY);
+        op = make_shared<ProductMatrix> (mass->InverseMatrix(used),
+                                         SparseMatrix<double>::CreateFromCOO (rows, cols, vals, ndof_b, ndof_a));
+      }
+    else
+      {
+        for (size_t k = 0; k < rows.Size(); k++)
+          { vals[k] /= cnt_b[rows[k]]; }
+        op = SparseMatrix<double>::CreateFromCOO (rows, cols, vals, ndof_b, ndof_a);
+      }
+
+    if (space_b->IsComplex())
+      { op = make_shared<Real2ComplexMatrix<double,Complex>> (op); }
+    return op;
+  } // MeshTransferOperator
+
+
+
+  /** changes when a vertex moves or the deformation of the mesh is modified,
+      the mesh timestamp does not **/
+  static size_t GeometryHash (const MeshAccess & ma)
+  {
+    size_t hash = ma.GetNV();
+    auto combine = [&hash] (double v)
+      { hash ^= std::hash<double>()(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    for (size_t v = 0; v < ma.GetNV(); v++)
+      for (double c : ma.GetPoint<3>(v))
+        combine (c);
+    if (auto def = ma.GetDeformation())
+      for (double d : def->GetVector().FVDouble())
+        combine (d);
+    return hash;
+  }
+
+
+  struct MeshTransferCacheEntry
+  {
+    weak_ptr<FESpace> space_a, space_b;
+    size_t ndof_a, ndof_b, timestamp_a, timestamp_b, geometry_a, geometry_b;
+    int bonus_intorder;
+    shared_ptr<BaseMatrix> op;
+    /// dofs of space_b in an element, the others are not written
+    shared_ptr<BitArray> covered;
+  };
+
+  bool SetFromOtherMesh (shared_ptr<CoefficientFunction> coef, GridFunction & u, LocalHeap & lh, int bonus_intorder)
+  {
+    static Timer t("SetFromOtherMesh"); RegionTimer reg(t);
+    static mutex cache_mutex;
+    static Array<MeshTransferCacheEntry> cache;
+
+    auto gf = dynamic_pointer_cast<GridFunction> (coef);
+    if (!gf) return false;
+    auto space_a = gf->GetFESpace(), space_b = u.GetFESpace();
+    auto ma_a = space_a->GetMeshAccess(), ma_b = space_b->GetMeshAccess();
+    if ( (ma_a == ma_b) || (gf->GetLevelUpdated() != ma_a->GetNLevels()) ||
+         (gf->GetDifferentialOperator(VOL) != space_a->GetEvaluator(VOL)) ||
+         space_a->IsParallel() || space_b->IsParallel() ||
+         (space_a->GetDimension() != 1) || (space_b->GetDimension() != 1) ||
+         (space_a->IsComplex() != space_b->IsComplex()) )
+      { return false; }
+
+    size_t ts_a = ma_a->GetTimeStamp(), ts_b = ma_b->GetTimeStamp();
+    size_t geo_a = GeometryHash(*ma_a), geo_b = GeometryHash(*ma_b);
+    shared_ptr<BaseMatrix> op;
+    shared_ptr<BitArray> covered;
+    {
+      lock_guard<mutex> guard(cache_mutex);
+      for (size_t i = cache.Size(); i-- > 0; )
+        {
+          auto & entry = cache[i];
+          if (entry.space_a.expired() || entry.space_b.expired())
+            { cache.DeleteElement(i); continue; }
+          if (entry.space_b.lock() != space_b)
+            { continue; }
+          if ( (entry.space_a.lock() == space_a) && (entry.bonus_intorder == bonus_intorder) &&
+               (entry.ndof_a == space_a->GetNDof()) && (entry.ndof_b == space_b->GetNDof()) &&
+               (entry.timestamp_a == ts_a) && (entry.timestamp_b == ts_b) &&
+               (entry.geometry_a == geo_a) && (entry.geometry_b == geo_b) )
+            {
+              op = entry.op;
+              covered = entry.covered;
+            }
+          else // outdated, or another source: one transfer per target space is kept
+            { cache.DeleteElement(i); }
+        }
+    }
+
+    if (!op)
+      {
+        op = MeshTransferOperator (space_a, space_b, lh, false, bonus_intorder);
+        covered = make_shared<BitArray> (space_b->GetNDof());
+        covered->Clear();
+        Array<DofId> dnums;
+        for (auto el : ma_b->Elements(VOL))
+          if (space_b->DefinedOn(el))
+            {
+              space_b->GetDofNrs (el, dnums);
+              for (auto d : dnums)
+                if (IsRegularDof(d))
+                  { covered->SetBit(d); }
+            }
+
+        lock_guard<mutex> guard(cache_mutex);
+        cache.Append (MeshTransferCacheEntry { space_a, space_b, space_a->GetNDof(), space_b->GetNDof(),
+                                               ts_a, ts_b, geo_a, geo_b, bonus_intorder, op, covered });
+      }
+
+    auto hv = u.GetVector().CreateVector();
+    hv = *op * gf->GetVector();
+    auto & vec = u.GetVector();
+    if (vec.IsComplex())
+      {
+        auto fv = vec.FVComplex(), fhv = hv.FVComplex();
+        for (size_t i = 0; i < fv.Size(); i++)
+          if (covered->Test(i)) fv(i) = fhv(i);
+      }
+    else
+      {
+        auto fv = vec.FVDouble(), fhv = hv.FVDouble();
+        for (size_t i = 0; i < fv.Size(); i++)
+          if (covered->Test(i)) fv(i) = fhv(i);
+      }
+    return true;
+  } // SetFromOtherMesh
+
+
+
   shared_ptr<BaseMatrix> ConvertOperator (shared_ptr<FESpace> space_a, shared_ptr<FESpace> space_b, VorB vb, LocalHeap & lh,
 					  shared_ptr<DifferentialOperator> diffop, shared_ptr<CoefficientFunction> trial_cf, const Region * reg,
 					  shared_ptr<BitArray> range_dofs, bool localop, bool parmat, bool use_simd,
@@ -526,6 +789,12 @@ namespace ngcomp
     if ( space_a->IsComplex() != space_b->IsComplex() ) // b complex and a real could work in principle (?)
       { throw Exception("Cannot convert between complex and non-complex space!"); }
 
+    if ( space_a->GetMeshAccess() != space_b->GetMeshAccess() ) {
+      if ( (vb != VOL) || diffop || trial_cf || reg || range_dofs || geom_free )
+	{ throw Exception("ConvertOperator between different meshes supports only the plain VOL conversion!"); }
+      return MeshTransferOperator(space_a, space_b, lh, false, bonus_intorder_ab);
+    }
+
     shared_ptr<BaseMatrix> op;
 
     // This is a workaround because nested Switch does not work with gcc 7
@@ -9,6 +9,16 @@ namespace ngcomp
 					  const Region * reg = NULL, shared_ptr<BitArray> range_dofs = nullptr, bool localop = false, bool parmat = true,
 					  bool use_simd = true, int bonus_intorder_ab = 0, int bonus_intorder_bb = 0, bool geom_free = false);
 
+  /** Transfer between spaces on different, non-matching meshes. Points are located once,
+      the result is a sparse matrix (or mass-inverse times mixed mass matrix if conservative) **/
+  shared_ptr<BaseMatrix> MeshTransferOperator (shared_ptr<FESpace> spacea, shared_ptr<FESpace> spaceb, LocalHeap & lh,
+                                               bool conservative = false, int bonus_intorder = 0);
+
+  /** Set u from a GridFunction on another mesh with a cached MeshTransferOperator, only dofs of elements are written.
+      The operator is rebuilt when a space, a mesh or its geometry changes. False if coef is no such GridFunction **/
+  bool SetFromOtherMesh (shared_ptr<CoefficientFunction> coef, GridFunction & u, LocalHeap & lh,
+                         int bonus_intorder = 0);
+
 } // namespace ngcomp
 
 #endif
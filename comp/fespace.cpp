@@ -829,6 +829,38 @@ lot of new non-zero entries in the matrix!\n" << endl;
                    << " for " << ((vb == VOL) ? "vol" : "bnd") << endl;
       }
       }
+
+    // within a color, elements of the same type, region and number of dofs
+    // follow each other, such that the assembly loops see long runs of
+    // identical finite elements, integration rules and integrators.
+    // A coloring copied from the low order space is sorted by the dofs of this space
+    for (auto vb : { VOL, BND, BBND, BBBND })
+      {
+        Array<int> elndof(ma->GetNE(vb));
+        ParallelForRange (elndof.Size(), [&] (IntRange myrange)
+          {
+            Array<DofId> dofs;
+            for (size_t nr : myrange)
+              {
+                ElementId el(vb, nr);
+                elndof[nr] = 0;
+                if (!DefinedOn(el)) continue;
+                GetDofNrs (el, dofs);
+                elndof[nr] = dofs.Size();
+              }
+          });
+
+        Table<int> & coloring = element_coloring[vb];
+        ParallelFor (coloring.Size(), [&] (size_t c)
+          {
+            auto key = [&] (int nr)
+              {
+                ElementId ei(vb, nr);
+                return make_tuple (ma->GetElType(ei), ma->GetElIndex(ei), elndof[nr], nr);
+              };
+            QuickSort (coloring[c], [&] (int a, int b) { return key(a) < key(b); });
+          });
+      }
     
     // invalidate facet_coloring
     facet_coloring = Table<int>();
@@ -126,8 +126,10 @@ namespace ngcomp
                                    FlatArray<INT<2>> e2v,
                                    FlatArray<double> edge_weights,
                                    FlatArray<double> vertex_weights,
-                                   size_t level)
-  : mat(amat)
+                                   size_t level,
+                                   shared_ptr<ParallelDofs> apardofs,
+                                   int achebyshev_degree)
+  : mat(amat), pardofs(apardofs), chebyshev_degree(achebyshev_degree)
   {
       static Timer t("H1AMG"); RegionTimer reg(t);
 
@@ -138,6 +140,15 @@ namespace ngcomp
 
       size = mat->Height();
 
+      // Under MPI, interface vertices survive as coarse vertices, or collapse
+      // with an interface vertex of the same distant procs as decided by the
+      // master rank, such that prolongation rows of interface vertices are
+      // identical on all ranks. Interior vertices may collapse into interface
+      // vertices.
+      Array<bool> interface(num_vertices);
+      for (auto i : Range(num_vertices))
+        interface[i] = pardofs && pardofs->GetDistantProcs(i).Size() > 0;
+
       Array<double> edge_collapse_weights(num_edges);
       Array<double> sum_vertex_weights(num_vertices);
       for (auto i : Range(num_vertices))
@@ -148,6 +159,7 @@ namespace ngcomp
                      for (size_t j = 0; j < 2; j++)
                        AtomicAdd(sum_vertex_weights[e2v[i][j]], edge_weights[i]);
                    });
+      AllReduceDofData (sum_vertex_weights, MPI_SUM, pardofs);
 
       ParallelFor (num_edges, [&] (size_t i)
                    {
@@ -222,7 +234,7 @@ namespace ngcomp
       BitArray isolated_verts(num_vertices);
       isolated_verts.Clear();
       for (size_t i = 0; i < num_vertices; i++)
-        if (sum_vertex_weights[i] <= 1.1 * vertex_weights[i] ||
+        if ((!interface[i] && sum_vertex_weights[i] <= 1.1 * vertex_weights[i]) ||
             (*freedofs)[i] == false)
           isolated_verts.SetBit(i);
 
@@ -233,7 +245,8 @@ namespace ngcomp
                                auto v0 = e2v[edgenr][0];
                                auto v1 = e2v[edgenr][1];
                                if (edge_collapse_weights[edgenr] >= 0.01 && !vertex_collapse[v0] && !vertex_collapse[v1]
-                                   && !isolated_verts[v0] && !isolated_verts[v1])
+                                   && !isolated_verts[v0] && !isolated_verts[v1]
+                                   && !(interface[v0] && interface[v1]))
                                  // && (*freedofs)[v0] && (*freedofs)[v1])
                                  {
                                    edge_collapse[edgenr] = true;
@@ -243,15 +256,84 @@ namespace ngcomp
                              });
       edge_dag = Table<int>();
 
-      // collapse the larger vertex
+      // Interface vertices with the same distant procs may collapse with each
+      // other, otherwise the coarse problem stalls at the size of the
+      // interface. The master rank matches them, and sends the partner as
+      // position among the interface vertices of this proc set, which is the
+      // same on all ranks.
+      Array<int> interface_target(num_vertices);
+      interface_target = -1;
+      if (pardofs)
+        {
+          auto compare_procs = [&] (int v1, int v2)
+            {
+              auto p1 = pardofs->GetDistantProcs(v1);
+              auto p2 = pardofs->GetDistantProcs(v2);
+              if (p1.Size() != p2.Size()) return p1.Size() < p2.Size() ? -1 : 1;
+              for (auto j : Range(p1))
+                if (p1[j] != p2[j]) return p1[j] < p2[j] ? -1 : 1;
+              return 0;
+            };
+
+          Array<int> ivs;
+          for (auto i : Range(num_vertices))
+            if (interface[i]) ivs.Append(i);
+          QuickSort (ivs, [&] (int v1, int v2)
+                     {
+                       int c = compare_procs(v1, v2);
+                       return (c != 0) ? (c < 0) : (v1 < v2);
+                     });
+
+          Array<int> class_start(num_vertices), position(num_vertices);
+          for (auto k : Range(ivs))
+            {
+              bool first = (k == 0) || compare_procs(ivs[k-1], ivs[k]) != 0;
+              class_start[ivs[k]] = first ? k : class_start[ivs[k-1]];
+              position[ivs[k]] = k - class_start[ivs[k]];
+            }
+
+          Array<int> partner(num_vertices);
+          partner = -1;
+          for (size_t e = 0; e < num_edges; e++)
+            {
+              auto v0 = e2v[e][0];
+              auto v1 = e2v[e][1];
+              if (interface[v0] && interface[v1] && pardofs->IsMasterDof(v0)
+                  && compare_procs(v0, v1) == 0
+                  && partner[v0] == -1 && partner[v1] == -1
+                  && !vertex_collapse[v0] && !vertex_collapse[v1]
+                  && !isolated_verts[v0] && !isolated_verts[v1]
+                  && edge_collapse_weights[e] >= 0.01)
+                {
+                  partner[v0] = position[v1];
+                  partner[v1] = position[v0];
+                }
+            }
+          ScatterDofData (partner, pardofs);
+
+          // the vertex at the later position collapses
+          for (auto v : ivs)
+            if (partner[v] != -1 && partner[v] < position[v])
+              interface_target[v] = ivs[class_start[v] + partner[v]];
+        }
+
+      // collapse the larger vertex, or the interior one
+      auto collapsed_vertex = [&] (size_t e)
+        {
+          auto v0 = e2v[e][0];
+          auto v1 = e2v[e][1];
+          if (interface[v0] != interface[v1])
+            return interface[v0] ? v1 : v0;
+          return max2(v0,v1);
+        };
+      
       vertex_collapse = false;
       for (int e = 0; e < num_edges; e++)
         if (edge_collapse[e])
-          {
-            auto v0 = e2v[e][0];
-            auto v1 = e2v[e][1];
-            vertex_collapse[max2(v0,v1)] = true;
-          }
+          vertex_collapse[collapsed_vertex(e)] = true;
+      for (size_t i = 0; i < num_vertices; i++)
+        if (interface_target[i] != -1)
+          vertex_collapse[i] = true;
 
 
       // vertex 2 coarse vertex
@@ -261,15 +343,33 @@ namespace ngcomp
       for (size_t i = 0; i < num_vertices; i++)
         if (!vertex_collapse[i] && !isolated_verts.Test(i))
           v2cv[i] = num_coarse_vertices++;
+      // before interior vertices, they may collapse into a collapsed interface vertex
+      for (size_t i = 0; i < num_vertices; i++)
+        if (interface_target[i] != -1)
+          v2cv[i] = v2cv[interface_target[i]];
       for (size_t e = 0; e < num_edges; e++)
         if (edge_collapse[e])
           {
-            auto v0 = e2v[e][0];
-            auto v1 = e2v[e][1];
-            if (v0 > v1) Swap (v0,v1);
-            v2cv[v1] = v2cv[v0];
+            auto vc = collapsed_vertex(e);
+            auto vs = e2v[e][0]+e2v[e][1]-vc;
+            v2cv[vc] = v2cv[vs];
           }
 
+      // coarse vertices inherit the distant procs of surviving interface
+      // vertices, they are numbered in the order of fine vertices on all ranks
+      shared_ptr<ParallelDofs> coarse_pardofs;
+      if (pardofs)
+        {
+          TableCreator<int> cdist_procs_creator(num_coarse_vertices);
+          for ( ; !cdist_procs_creator.Done(); cdist_procs_creator++)
+            for (size_t i = 0; i < num_vertices; i++)
+              if (interface[i] && v2cv[i] != -1 && interface_target[i] == -1)
+                for (auto p : pardofs->GetDistantProcs(i))
+                  cdist_procs_creator.Add (v2cv[i], p);
+          coarse_pardofs = make_shared<ParallelDofs> (pardofs->GetCommunicator(), cdist_procs_creator.MoveTable(),
+                                                      1, is_same<SCAL,Complex>());
+        }
+
       // edge to coarse edge
 
       Array<size_t> e2ce(num_edges);
@@ -368,8 +468,33 @@ namespace ngcomp
                          smoothing_blocks_creator.Add (v2cv[v], v);
                      });
 
-      auto blocks = make_shared<Table<int>> (smoothing_blocks_creator.MoveTable());
-      smoother = mat->CreateBlockJacobiPrecond(blocks);
+      if (chebyshev_degree > 0 && !is_same<SCAL,double>::value)
+        throw Exception ("H1AMG: Chebyshev smoothing needs a real matrix");
+
+      if (!pardofs)
+        {
+          if (chebyshev_degree > 0)
+            cheby = make_shared<ChebyshevSmoother> (mat, CreateInverseDiagonal (*mat, freedofs), chebyshev_degree);
+          else
+            {
+              auto blocks = make_shared<Table<int>> (smoothing_blocks_creator.MoveTable());
+              smoother = mat->CreateBlockJacobiPrecond(blocks);
+            }
+        }
+      else
+        {
+          inv_l1diag.SetSize(size);
+          ParallelFor (size, [&] (size_t i)
+                       {
+                         double sum = 0;
+                         for (auto val : mat->GetRowValues(i))
+                           sum += abs(val);
+                         inv_l1diag[i] = sum;
+                       });
+          AllReduceDofData (inv_l1diag, MPI_SUM, pardofs);
+          for (auto i : Range(size))
+            inv_l1diag[i] = ((*freedofs)[i] && inv_l1diag[i] > 0) ? 1.0/inv_l1diag[i] : 0.0;
+        }
 
       // build prolongation
       Array<int> nne(num_vertices);
@@ -402,6 +527,13 @@ namespace ngcomp
                  }
                (*smoothprol)(i, i) = 0.0;
 
+               // interface rows must stay consistent over ranks
+               if (interface[i])
+                 {
+                   (*smoothprol)(i, i) = 1.0;
+                   return;
+                 }
+               
                for (auto e : v2e[i])
                  {
                    auto v2 = e2v[e][0]+e2v[e][1]-i;
@@ -423,25 +555,85 @@ namespace ngcomp
                       coarse_freedofs->SetBitAtomic(v2cv[v]);
                   });
 
-      if ( (num_coarse_vertices < 10) || (num_coarse_vertices == num_vertices) )
-	{
-	  coarsemat->SetInverseType(SPARSECHOLESKY);
-	  coarse_precond = coarsemat->InverseMatrix(coarse_freedofs);
-	}
-      else
-        coarse_precond = make_shared<H1AMG_Matrix> (dynamic_pointer_cast<SparseMatrixTM<SCAL>> (coarsemat), coarse_freedofs,
-                                                    coarse_e2v, coarse_edge_weights, coarse_vertex_weights, level+1);
-
       // restriction = TransposeMatrix (*prolongation);
       restriction = dynamic_pointer_cast<SparseMatrixTM<double>>(prolongation->CreateTranspose());
+
+      if (!pardofs)
+        {
+          if ( (num_coarse_vertices < 10) || (num_coarse_vertices == num_vertices) )
+            {
+              coarsemat->SetInverseType(SPARSECHOLESKY);
+              coarse_precond = coarsemat->InverseMatrix(coarse_freedofs);
+            }
+          else
+            coarse_precond = make_shared<H1AMG_Matrix> (dynamic_pointer_cast<SparseMatrixTM<SCAL>> (coarsemat), coarse_freedofs,
+                                                        coarse_e2v, coarse_edge_weights, coarse_vertex_weights, level+1,
+                                                        nullptr, chebyshev_degree);
+          return;
+        }
+
+      // distributed: x cumulated, b and residuals distributed
+      parmat = make_shared<ParallelMatrix> (mat, pardofs, pardofs, C2D);
+      parprolongation = make_shared<ParallelMatrix> (prolongation, coarse_pardofs, pardofs, C2C);
+      parrestriction = make_shared<ParallelMatrix> (restriction, pardofs, coarse_pardofs, D2D);
+
+      if (chebyshev_degree > 0)
+        {
+          // Jacobi scaling with the l1 row sums, consistent over ranks
+          auto dinv = CreateParallelVector (pardofs, CUMULATED);
+          dinv.FVDouble() = FlatVector<double> (size, inv_l1diag.Data());
+          cheby = make_shared<ChebyshevSmoother> (parmat, dinv, chebyshev_degree);
+        }
+
+      // if coarsening stalls nevertheless, the coarse problem is agglomerated
+      // and solved directly (MUMPS or master-rank inverse)
+      size_t num_global = pardofs->GetNDofGlobal();
+      size_t num_coarse_global = coarse_pardofs->GetNDofGlobal();
+      cout << IM(3) << "H1AMG: level = " << level << ", global nv = " << num_global
+           << ", global coarse nv = " << num_coarse_global << endl;
+      
+      if ( (num_coarse_global < 10) || (num_coarse_global > 0.9 * num_global) )
+        {
+          auto parcoarsemat = make_shared<ParallelMatrix> (coarsemat, coarse_pardofs, coarse_pardofs, C2D);
+          coarse_precond = parcoarsemat->InverseMatrix(coarse_freedofs);
+        }
+      else
+        coarse_precond = make_shared<H1AMG_Matrix> (dynamic_pointer_cast<SparseMatrixTM<SCAL>> (coarsemat), coarse_freedofs,
+                                                    coarse_e2v, coarse_edge_weights, coarse_vertex_weights, level+1,
+                                                    coarse_pardofs, chebyshev_degree);
     }
 
+  template <typename SCAL>
+  AutoVector H1AMG_Matrix<SCAL>::CreateRowVector () const
+  {
+    if (pardofs)
+      return CreateParallelVector (pardofs, DISTRIBUTED);
+    return mat->CreateColVector();
+  }
+
+  template <typename SCAL>
+  AutoVector H1AMG_Matrix<SCAL>::CreateColVector () const
+  {
+    if (pardofs)
+      return CreateParallelVector (pardofs, CUMULATED);
+    return mat->CreateRowVector();
+  }
+
   template <typename SCAL>
   void H1AMG_Matrix<SCAL>::Mult (const BaseVector & b, BaseVector & x) const
   {
+      if (pardofs)
+        {
+          MultParallel (b, x);
+          return;
+        }
+    
       static Timer t("H1AMG::Mult"); RegionTimer reg(t);
       x = 0;
-      smoother->GSSmooth(x, b, smoothing_steps);
+      if (cheby)
+        cheby->Smooth(x, b, smoothing_steps);
+      else
+        smoother->GSSmooth(x, b, smoothing_steps);
       auto residuum = b.CreateVector();
       residuum = b - (*mat) * x;
       
@@ -452,7 +644,53 @@ namespace ngcomp
       coarse_precond->Mult(coarse_residuum, coarse_x);
 
       x += *prolongation * coarse_x;
-      smoother->GSSmoothBack (x, b, smoothing_steps);
+      if (cheby)
+        cheby->Smooth(x, b, smoothing_steps);
+      else
+        smoother->GSSmoothBack (x, b, smoothing_steps);
+  }
+
+  template <typename SCAL>
+  void H1AMG_Matrix<SCAL>::SmoothParallel (BaseVector & x, const BaseVector & b, BaseVector & res) const
+  {
+    if (cheby)
+      {
+        cheby->Smooth (x, b, smoothing_steps);
+        return;
+      }
+    for (int k = 0; k < smoothing_steps; k++)
+      {
+        res = b - (*parmat) * x;
+        res.Cumulate();
+        auto fx = x.FV<SCAL>();
+        auto fres = res.FV<SCAL>();
+        ParallelFor (fx.Size(), [&] (size_t i)
+                     {
+                       fx(i) += inv_l1diag[i] * fres(i);
+                     });
+      }
+  }
+  
+  template <typename SCAL>
+  void H1AMG_Matrix<SCAL>::MultParallel (const BaseVector & b, BaseVector & x) const
+  {
+      static Timer t("H1AMG::Mult parallel"); RegionTimer reg(t);
+
+      x = 0;
+      x.SetParallelStatus (CUMULATED);
+      auto residuum = parmat->CreateColVector();
+
+      SmoothParallel (x, b, residuum);
+      residuum = b - (*parmat) * x;
+      
+      auto coarse_residuum = coarse_precond->CreateRowVector();
+      coarse_residuum = *parrestriction * residuum;
+
+      auto coarse_x = coarse_precond->CreateColVector();
+      coarse_precond->Mult(coarse_residuum, coarse_x);
+
+      x += *parprolongation * coarse_x;
+      SmoothParallel (x, b, residuum);
   }
 
   template <class SCAL>
@@ -463,6 +701,7 @@ namespace ngcomp
 
     ParallelHashTable<INT<2>,double> edge_weights_ht;
     ParallelHashTable<INT<1>,double> vertex_weights_ht;
+    int chebyshev_degree = 0;
 
   public:
 
@@ -483,6 +722,8 @@ namespace ngcomp
                           const string aname = "H1AMG_cprecond")
       : Preconditioner (abfa, aflags, aname)
     {
+      if (flags.GetStringFlag ("smoother", "gs") == "chebyshev")
+        chebyshev_degree = int(flags.GetNumFlag ("chebyshevdegree", 3));
       if (is_same<SCAL,double>::value)
         cout << IM(3) << "Create H1AMG" << endl;
       else
@@ -502,7 +743,17 @@ namespace ngcomp
 
     virtual void FinalizeLevel (const BaseMatrix * matrix) override
     {
-      auto smat = dynamic_pointer_cast<SparseMatrixTM<SCAL>> (const_cast<BaseMatrix*>(matrix)->shared_from_this());
+      shared_ptr<BaseMatrix> locmat = const_cast<BaseMatrix*>(matrix)->shared_from_this();
+      shared_ptr<ParallelDofs> pardofs;
+#ifdef PARALLEL
+      if (auto parmat = dynamic_pointer_cast<ParallelMatrix> (locmat))
+        {
+          locmat = parmat->GetMatrix();
+          pardofs = parmat->GetRowParallelDofs();
+          matrix = locmat.get();
+        }
+#endif
+      auto smat = dynamic_pointer_cast<SparseMatrixTM<SCAL>> (locmat);
       if (!smat)
         throw Exception(string("H1AMG: expected a matrix of type ") + typeid(SparseMatrixTM<SCAL>).name()
                         + ", but got a matrix of type "+typeid(*matrix).name());
@@ -529,7 +780,7 @@ namespace ngcomp
          });
       vertex_weights_ht = ParallelHashTable<INT<1>,double>();
 
-      mat = make_shared<H1AMG_Matrix<SCAL>> (smat, freedofs, e2v, edge_weights, vertex_weights, 0);
+      mat = make_shared<H1AMG_Matrix<SCAL>> (smat, freedofs, e2v, edge_weights, vertex_weights, 0, pardofs, chebyshev_degree);
     }
 
 
@@ -14,6 +14,15 @@ namespace ngcomp
     std::shared_ptr<ngla::SparseMatrixTM<double>> prolongation, restriction;
     std::shared_ptr<ngla::BaseMatrix> coarse_precond;
     int smoothing_steps = 1;
+    // Chebyshev-Jacobi smoothing instead of Gauss-Seidel if degree > 0
+    int chebyshev_degree = 0;
+    std::shared_ptr<ngla::ChebyshevSmoother> cheby;
+
+    // distributed memory: local matrices are wrapped by ParallelMatrix,
+    // smoothing by l1-Jacobi with the cumulated l1 row sums
+    std::shared_ptr<ngla::ParallelDofs> pardofs;
+    std::shared_ptr<ngla::BaseMatrix> parmat, parprolongation, parrestriction;
+    ngcore::Array<double> inv_l1diag;
 
   public:
     H1AMG_Matrix (std::shared_ptr<ngla::SparseMatrixTM<SCAL>> amat,
@@ -21,16 +30,22 @@ namespace ngcomp
                   ngcore::FlatArray<ngcore::INT<2>> e2v,
                   ngcore::FlatArray<double> edge_weights,
                   ngcore::FlatArray<double> vertex_weights,
-                  size_t level);
+                  size_t level,
+                  std::shared_ptr<ngla::ParallelDofs> apardofs = nullptr,
+                  int achebyshev_degree = 0);
 
     virtual int VHeight() const override { return size; }
     virtual int VWidth() const override { return size; }
     virtual bool IsComplex() const override { return is_same<SCAL,Complex>(); }
     
-    virtual AutoVector CreateRowVector () const override { return mat->CreateColVector(); }
-    virtual AutoVector CreateColVector () const override { return mat->CreateRowVector(); }
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
 
     virtual void Mult (const ngla::BaseVector & b, ngla::BaseVector & x) const override;
+
+  private:
+    void MultParallel (const ngla::BaseVector & b, ngla::BaseVector & x) const;
+    void SmoothParallel (ngla::BaseVector & x, const ngla::BaseVector & b, ngla::BaseVector & res) const;
   };
 }
 
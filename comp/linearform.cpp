@@ -18,6 +18,7 @@ namespace ngcomp
     allocated = false;
     initialassembling = true;
     checksum = flags.GetDefineFlag ("checksum");
+    overlap = flags.GetDefineFlag ("overlap");
     cacheblocksize = 1;
   }
 
@@ -37,7 +38,11 @@ namespace ngcomp
     ost << "on space " << GetFESpace()->GetName() << endl
 	<< "integrators: " << endl;
     for (int i = 0; i < parts.Size(); i++)
-      ost << "  " << parts[i]->Name() << endl;
+      {
+        ost << "  " << parts[i]->Name() << endl;
+        if (auto fallback = parts[i]->GetSimdFallback())
+          ost << "    SIMD fallback in " << fallback->elements << " elements: " << fallback->what << endl;
+      }
   }
 
   Array<MemoryUsage> LinearForm :: GetMemoryUsage () const
@@ -197,6 +202,27 @@ namespace ngcomp
 	
 	timer1.Stop();
 
+	// with the overlap flag, elements touching dofs shared with other ranks are
+	// assembled first, and these dofs are sent while the interior elements are assembled
+	auto parvec = dynamic_cast<ParallelBaseVector*> (&this->GetVector());
+	bool overlap_comm = overlap && parvec && fespace->GetParallelDofs() &&
+	  !pnteval.Size() && !hasskeletonparts[BND];
+	for (auto & lfi : parts)
+	  if (lfi->IntegrationAlongCurve()) overlap_comm = false;
+
+	BitArray exdofs;
+	if (overlap_comm)
+	  {
+	    auto pardofs = fespace->GetParallelDofs();
+	    exdofs.SetSize (fespace->GetNDof());
+	    exdofs.Clear();
+	    for (size_t d = 0; d < exdofs.Size(); d++)
+	      if (pardofs->GetDistantProcs(d).Size())
+		exdofs.SetBit(d);
+	  }
+
+	for (int pass : Range(overlap_comm ? 2 : 1))
+	  {
 	for(VorB vb : {VOL,BND,BBND,BBBND})
 	  {
 	    if(hasparts[vb])
@@ -205,11 +231,18 @@ namespace ngcomp
 		// string vb_str = vb==VOL ? "VOL" : (vb==BND ? "BND" : "BBND");
 		// ProgressOutput progress (ma, string("assemble ") + vb_str + string(" element"),ne);
                 ProgressOutput progress (ma, string("assemble ") + ToString(vb) + string(" element"),ne);
-		gcnt += ne;
+		if (pass == 0) gcnt += ne;
 		IterateElements
 		  (*fespace,vb,clh,[&] (FESpace::Element el, LocalHeap &lh)
 		   {
 		     // RegionTimer reg2(timer2);
+		     if (overlap_comm)
+		       {
+			 bool interface = false;
+			 for (auto d : el.GetDofs())
+			   if (IsRegularDof(d) && exdofs.Test(d)) interface = true;
+			 if (interface != (pass == 0)) return;
+		       }
 		     progress.Update();
 
 		     auto & fel = el.GetFE();
@@ -248,6 +281,11 @@ namespace ngcomp
 	  }
 
         
+
+	    if (overlap_comm && pass == 0)
+	      parvec->StartCumulate();
+	  }
+
         for (auto pe : pnteval)
           {
             LocalHeap & lh = clh;
@@ -508,6 +546,9 @@ namespace ngcomp
 	  }
 	
 	
+	if (overlap_comm)
+	  parvec->FinishCumulate();
+
 	if (print)
 	  {
 	    (*testout) << "Linearform " << GetName() << ": " << endl;
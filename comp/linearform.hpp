@@ -41,6 +41,8 @@ namespace ngcomp
     int cacheblocksize;
     /// output of norm of matrix entries
     bool checksum;
+    /// assemble elements at the MPI interface first and cumulate while assembling the rest
+    bool overlap;
 
   public:
     ///
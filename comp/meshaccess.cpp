@@ -479,7 +479,9 @@ namespace ngcomp
 
     virtual SIMD_BaseMappedIntegrationRule & operator() (const SIMD_IntegrationRule & ir, Allocator & lh) const
     {
-      throw ExceptionNOSIMD("PML-trafo operator() (SIMD_IntegrationRule & ir) not overloaded");
+      // there are no SIMD mapped rules with complex points and jacobians,
+      // elements in a PML region are integrated with scalar rules
+      throw ExceptionNOSIMD("PML-trafo: no SIMD mapped rules for complex coordinates");
       // return *new (lh) SIMD_MappedIntegrationRule<DIMS,DIMR> (ir, *this, lh);
     }
 
@@ -499,11 +501,19 @@ namespace ngcomp
       const PML_TransformationDim<DIMR> & dimpml = 
             static_cast<const PML_TransformationDim<DIMR>&> (pml_global_trafo);
 
+      // the real geometry of all points in one call, then the complex stretching point by point
+      STACK_ARRAY(double, mipmem, ir.Size()*sizeof(MappedIntegrationPoint<DIMS,DIMR>)/sizeof(double)+1);
+      FlatArray<MappedIntegrationPoint<DIMS,DIMR>> mips(ir.Size(), reinterpret_cast<MappedIntegrationPoint<DIMS,DIMR>*>(&mipmem[0]));
+      for (size_t i = 0; i < ir.Size(); i++)
+        new (&mips[i]) MappedIntegrationPoint<DIMS,DIMR> (ir[i], *this, -1);
+      MappedIntegrationRule<DIMS,DIMR> mir_real(ir, *this, mips);
+      BASE::CalcMultiPointJacobian (ir, mir_real);
+
       Vec<DIMR,Complex> point;
       Mat<DIMR,DIMR,Complex> tjac;
       for (int i = 0; i < ir.Size(); i++)
         {
-          MappedIntegrationPoint<DIMS,DIMR> mip(ir[i], *this);
+          auto & mip = mir_real[i];
           Mat<DIMS,DIMR> hjac(mip.Jacobian());
           dimpml.MapIntegrationPoint (mip, point, tjac);
                     
@@ -516,7 +526,7 @@ namespace ngcomp
     virtual void CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const
     {
-      throw ExceptionNOSIMD ("pml - trafo cannot calc simd_rule");
+      throw ExceptionNOSIMD ("PML-trafo: no SIMD mapped rules for complex coordinates");
     }
   };
   
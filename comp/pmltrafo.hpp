@@ -28,6 +28,89 @@ namespace ngcomp
     
     virtual void MapPointV(FlatVector<double> hpoint, FlatVector<Complex> point, FlatMatrix<Complex> jac) const = 0;
 
+    // mapped points and row-major jacobians of a SIMD rule
+    // the default maps lane by lane, radial, cartesian, halfspace and brick PMLs map vectorized
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const
+    {
+      constexpr size_t SW = SIMD<double>::Size();
+      STACK_ARRAY(double, hmem, dim);
+      STACK_ARRAY(Complex, cmem, dim+dim*dim);
+      STACK_ARRAY(double, lanemem, 2*(dim+dim*dim)*SW);
+      FlatVector<> hpoint(dim, hmem);
+      FlatVector<Complex> point(dim, cmem);
+      FlatMatrix<Complex> jac(dim, dim, cmem+dim);
+      FlatVector<Complex> all(dim+dim*dim, cmem);
+      FlatMatrix<> re(dim+dim*dim, SW, lanemem), im(dim+dim*dim, SW, lanemem+(dim+dim*dim)*SW);
+
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto simd_point = mir[i].GetPoint();
+          for (size_t lane = 0; lane < SW; lane++)
+            {
+              for (int k = 0; k < dim; k++)
+                hpoint(k) = simd_point(k)[lane];
+              MapPointV (hpoint, point, jac);
+              for (size_t k = 0; k < all.Size(); k++)
+                {
+                  re(k,lane) = all(k).real();
+                  im(k,lane) = all(k).imag();
+                }
+            }
+          for (int k = 0; k < dim; k++)
+            points(k,i) = SIMD<Complex> (SIMD<double>(&re(k,0)), SIMD<double>(&im(k,0)));
+          for (int k = 0; k < dim*dim; k++)
+            jacs(k,i) = SIMD<Complex> (SIMD<double>(&re(dim+k,0)), SIMD<double>(&im(dim+k,0)));
+        }
+    }
+
+    // SIMD evaluation of the PML coefficient functions, func(point, jac, res) fills ncomp values of one SIMD point
+    template <typename FUNC>
+    void EvaluateSIMD (const SIMD_BaseMappedIntegrationRule & mir, size_t ncomp,
+                       BareSliceMatrix<SIMD<Complex>> values, FUNC func) const
+    {
+      STACK_ARRAY(SIMD<Complex>, simdmem, (dim+dim*dim)*mir.Size());
+      FlatMatrix<SIMD<Complex>> points(dim, mir.Size(), simdmem);
+      FlatMatrix<SIMD<Complex>> jacs(dim*dim, mir.Size(), simdmem+dim*mir.Size());
+      MapSIMD (mir, points, jacs);
+
+      STACK_ARRAY(SIMD<Complex>, mem, dim+dim*dim+ncomp);
+      FlatVector<SIMD<Complex>> point(dim, mem);
+      FlatMatrix<SIMD<Complex>> jac(dim, dim, mem+dim);
+      FlatVector<SIMD<Complex>> res(ncomp, mem+dim+dim*dim);
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          point = points.Col(i);
+          jac.AsVector() = jacs.Col(i);
+          func (point, jac, res);
+          for (size_t k = 0; k < ncomp; k++)
+            values(k,i) = res(k);
+        }
+    }
+
+    static SIMD<Complex> DetSIMD (FlatMatrix<SIMD<Complex>> m)
+    {
+      switch (m.Height())
+        {
+        case 1: return m(0,0);
+        case 2: return m(0,0)*m(1,1)-m(0,1)*m(1,0);
+        default:
+          return m(0,0)*(m(1,1)*m(2,2)-m(1,2)*m(2,1))
+            + m(0,1)*(m(1,2)*m(2,0)-m(1,0)*m(2,2))
+            + m(0,2)*(m(1,0)*m(2,1)-m(1,1)*m(2,0));
+        }
+    }
+
+    static void InverseSIMD (FlatMatrix<SIMD<Complex>> m)
+    {
+      Switch<3> (m.Height()-1, [&] (auto DM1)
+        {
+          constexpr int D = DM1.value+1;
+          Mat<D,D,SIMD<Complex>> hm = m;
+          Mat<D,D,SIMD<Complex>> inv = Inv(hm);
+          m = inv;
+        });
+    }
   };
 
 
@@ -71,6 +154,10 @@ namespace ngcomp
       else 
         pmltrafo->MapPointV(ip,values,jac);
     }
+    void Evaluate(const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values) const override
+    {
+      pmltrafo->EvaluateSIMD (ir, dim, values, [](auto point, auto jac, auto res) { res = point; });
+    }
   };
   
     class PML_Jac : public CoefficientFunction
@@ -108,6 +195,10 @@ namespace ngcomp
         pmltrafo->MapPointV(ip,vec,jac);
       values = jac.AsVector();
     }
+    void Evaluate(const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values) const override
+    {
+      pmltrafo->EvaluateSIMD (ir, dim*dim, values, [](auto point, auto jac, auto res) { res = jac.AsVector(); });
+    }
   };
     class PML_JacInv : public CoefficientFunction
   {
@@ -146,6 +237,14 @@ namespace ngcomp
       CalcInverse(jac);
       values=jac.AsVector();
     }
+    void Evaluate(const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values) const override
+    {
+      pmltrafo->EvaluateSIMD (ir, dim*dim, values, [](auto point, auto jac, auto res)
+                              {
+                                PML_Transformation::InverseSIMD(jac);
+                                res = jac.AsVector();
+                              });
+    }
   };
     class PML_Det : public CoefficientFunction
   {
@@ -197,6 +296,11 @@ namespace ngcomp
         pmltrafo->MapPointV(ip,vec,jac);
       value = Det(jac);
     }
+    void Evaluate(const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values) const override
+    {
+      pmltrafo->EvaluateSIMD (ir, 1, values, [](auto point, auto jac, auto res)
+                              { res(0) = PML_Transformation::DetSIMD(jac); });
+    }
   };
 
   template <int DIM>
@@ -289,6 +393,34 @@ namespace ngcomp
       }
 
     }
+
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const override
+    {
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto hpoint = mir[i].GetPoint();
+          Vec<DIM,SIMD<double>> rel_point;
+          SIMD<double> abs2 = 0.0;
+          for (int k = 0; k < DIM; k++)
+            {
+              rel_point(k) = hpoint(k)-origin(k);
+              abs2 += rel_point(k)*rel_point(k);
+            }
+          SIMD<double> abs_x = sqrt(abs2);
+          // identity inside the radius
+          SIMD<double> s = IfPos(abs_x-rad, 1.0-rad/abs_x, SIMD<double>(0.0));
+          SIMD<double> t = IfPos(abs_x-rad, rad/(abs2*abs_x), SIMD<double>(0.0));
+          SIMD<Complex> g = SIMD<Complex>(1.0) + s*SIMD<Complex>(alpha);
+          SIMD<Complex> h = t*SIMD<Complex>(alpha);
+          for (int k = 0; k < DIM; k++)
+            {
+              points(k,i) = SIMD<Complex>(origin(k)) + g*rel_point(k);
+              for (int l = 0; l < DIM; l++)
+                jacs(k*DIM+l,i) = (rel_point(k)*rel_point(l))*h + ((k==l) ? g : SIMD<Complex>(0.0));
+            }
+        }
+    }
   };
   template <int DIM>
   class CartesianPML_Transformation : public PML_TransformationDim<DIM>
@@ -335,6 +467,27 @@ namespace ngcomp
           }
       }
     }
+
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const override
+    {
+      SIMD<double> zero(0.0), one(1.0);
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto hpoint = mir[i].GetPoint();
+          for (int k = 0; k < DIM*DIM; k++)
+            jacs(k,i) = SIMD<Complex>(0.0);
+          for (int j = 0; j < DIM; j++)
+            {
+              SIMD<double> x = hpoint(j);
+              SIMD<double> below = bounds(j,0)-x, above = x-bounds(j,1);
+              SIMD<double> dist = IfPos(below, -below, IfPos(above, above, zero));
+              SIMD<double> inside = IfPos(below, one, IfPos(above, one, zero));
+              points(j,i) = SIMD<Complex>(x) + dist*SIMD<Complex>(alpha);
+              jacs(j*DIM+j,i) = SIMD<Complex>(1.0) + inside*SIMD<Complex>(alpha);
+            }
+        }
+    }
   };
 
 
@@ -378,6 +531,27 @@ namespace ngcomp
         jac += alpha*normal*Trans(normal);        
       }
     }
+
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const override
+    {
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto hpoint = mir[i].GetPoint();
+          SIMD<double> dot = 0.0;
+          for (int k = 0; k < DIM; k++)
+            dot += (hpoint(k)-point(k))*normal(k);
+          SIMD<double> active = IfPos(dot, SIMD<double>(1.0), SIMD<double>(0.0));
+          dot = IfPos(dot, dot, SIMD<double>(0.0));
+          for (int k = 0; k < DIM; k++)
+            {
+              points(k,i) = SIMD<Complex>(hpoint(k)) + (dot*normal(k))*SIMD<Complex>(alpha);
+              for (int l = 0; l < DIM; l++)
+                jacs(k*DIM+l,i) = (active*(normal(k)*normal(l)))*SIMD<Complex>(alpha)
+                  + SIMD<Complex>((k==l) ? 1.0 : 0.0);
+            }
+        }
+    }
   };
   template <int DIM>
   class BrickRadialPML_Transformation : public PML_TransformationDim<DIM>
@@ -438,6 +612,40 @@ namespace ngcomp
         jac += alpha * (scal*Id<DIM>() + rel_point * Trans(tmpvec));
       }
     }
+
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const override
+    {
+      SIMD<double> zero(0.0);
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto hpoint = mir[i].GetPoint();
+          Vec<DIM,SIMD<double>> rel_point, tmpvec;
+          SIMD<double> scal = 0.0;
+          for (int j = 0; j < DIM; j++)
+            {
+              rel_point(j) = hpoint(j)-origin(j);
+              tmpvec(j) = 0.0;
+            }
+          // the coordinate with the largest relative distance to the brick wins
+          for (int j = 0; j < DIM; j++)
+            {
+              SIMD<double> below = bounds(j,0)-hpoint(j), above = hpoint(j)-bounds(j,1);
+              SIMD<double> tmp = IfPos(below, -below/rel_point(j), IfPos(above, above/rel_point(j), zero));
+              SIMD<double> larger = tmp-scal;
+              for (int m = 0; m < DIM; m++)
+                tmpvec(m) = IfPos(larger, (m==j) ? (1.0-tmp)/rel_point(j) : zero, tmpvec(m));
+              scal = IfPos(larger, tmp, scal);
+            }
+          for (int k = 0; k < DIM; k++)
+            {
+              points(k,i) = SIMD<Complex>(hpoint(k)) + (scal*rel_point(k))*SIMD<Complex>(alpha);
+              for (int l = 0; l < DIM; l++)
+                jacs(k*DIM+l,i) = (rel_point(k)*tmpvec(l) + ((k==l) ? scal : zero))*SIMD<Complex>(alpha)
+                  + SIMD<Complex>((k==l) ? 1.0 : 0.0);
+            }
+        }
+    }
   };
 
 
@@ -482,6 +690,13 @@ namespace ngcomp
     {
       throw Exception("CustomPML_Transformation::MapPoint: can only map integration Points");
     }
+
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const override
+    {
+      trafo->Evaluate(mir,points);
+      jac->Evaluate(mir,jacs);
+    }
   };
 
   template <int DIM>
@@ -527,6 +742,24 @@ namespace ngcomp
       point+=point2-hpoint;
       jac+=jac2-Id<DIM>();
     }
+
+    virtual void MapSIMD (const SIMD_BaseMappedIntegrationRule & mir, BareSliceMatrix<SIMD<Complex>> points,
+                          BareSliceMatrix<SIMD<Complex>> jacs) const override
+    {
+      STACK_ARRAY(SIMD<Complex>, mem, (DIM+DIM*DIM)*mir.Size());
+      FlatMatrix<SIMD<Complex>> points2(DIM, mir.Size(), mem);
+      FlatMatrix<SIMD<Complex>> jacs2(DIM*DIM, mir.Size(), mem+DIM*mir.Size());
+      pml1->MapSIMD(mir,points,jacs);
+      pml2->MapSIMD(mir,points2,jacs2);
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto hpoint = mir[i].GetPoint();
+          for (int k = 0; k < DIM; k++)
+            points(k,i) += points2(k,i)-SIMD<Complex>(hpoint(k));
+          for (int k = 0; k < DIM*DIM; k++)
+            jacs(k,i) += jacs2(k,i)-SIMD<Complex>((k%(DIM+1)==0) ? 1.0 : 0.0);
+        }
+    }
   };
 
   template <int DIM, int DIMA, int DIMB>
@@ -0,0 +1,286 @@
+#include <pmultigrid.hpp>
+#include <h1amg.hpp>
+
+#include <comp.hpp>
+using namespace ngcomp;
+
+
+namespace ngcomp
+{
+
+  shared_ptr<SparseMatrix<double>>
+  CreateEmbeddingMatrix (const FESpace & fine, const FESpace & coarse, LocalHeap & lh)
+  {
+    static Timer t("PMultigrid - embedding"); RegionTimer reg(t);
+
+    auto ma = fine.GetMeshAccess();
+    auto evf = fine.GetEvaluator(VOL);
+    auto evc = coarse.GetEvaluator(VOL);
+    if (!evf || !evc || evf->Dim() != evc->Dim())
+      throw Exception ("CreateEmbeddingMatrix: spaces need compatible evaluators");
+
+    // a dof shared by several elements gets its row from the first one
+    Array<int> owner(fine.GetNDof());
+    owner = -1;
+    Array<DofId> dnums;
+    for (size_t i = 0; i < ma->GetNE(VOL); i++)
+      {
+        fine.GetDofNrs (ElementId(VOL, i), dnums);
+        for (auto d : dnums)
+          if (IsRegularDof(d) && owner[d] == -1)
+            owner[d] = i;
+      }
+
+    Array<int> rows, cols;
+    Array<double> vals;
+    mutex triplet_mutex;
+
+    IterateElements
+      (fine, VOL, lh,
+       [&] (FESpace::Element el, LocalHeap & lh)
+       {
+         auto fdnums = el.GetDofs();
+         Array<DofId> cdnums;
+         coarse.GetDofNrs (ElementId(el), cdnums);
+
+         const FiniteElement & felf = el.GetFE();
+         const FiniteElement & felc = coarse.GetFE (ElementId(el), lh);
+         size_t ndf = felf.GetNDof(), ndc = felc.GetNDof();
+         int dim = evf->Dim();
+
+         // local L2 projection of the coarse basis onto the fine basis
+         const IntegrationRule & ir = SelectIntegrationRule (felf.ElementType(), 2*felf.Order());
+         auto & mir = el.GetTrafo()(ir, lh);
+         FlatMatrix<> mff(ndf, ndf, lh), mfc(ndf, ndc, lh);
+         FlatMatrix<double,ColMajor> bf(dim, ndf, lh), bc(dim, ndc, lh);
+         mff = 0.0;
+         mfc = 0.0;
+         for (size_t i = 0; i < mir.Size(); i++)
+           {
+             evf->CalcMatrix (felf, mir[i], bf, lh);
+             evc->CalcMatrix (felc, mir[i], bc, lh);
+             double w = mir[i].GetWeight();
+             mff += w * Trans(bf) * bf;
+             mfc += w * Trans(bf) * bc;
+           }
+         CalcInverse (mff);
+         FlatMatrix<> emb(ndf, ndc, lh);
+         emb = mff * mfc;
+
+         double eps = 1e-8 * max(1.0, MaxNorm(emb));
+         lock_guard<mutex> guard(triplet_mutex);
+         for (size_t i = 0; i < ndf; i++)
+           if (IsRegularDof(fdnums[i]) && owner[fdnums[i]] == int(el.Nr()))
+             for (size_t j = 0; j < ndc; j++)
+               if (IsRegularDof(cdnums[j]) && fabs(emb(i,j)) > eps)
+                 {
+                   rows.Append (fdnums[i]);
+                   cols.Append (cdnums[j]);
+                   vals.Append (emb(i,j));
+                 }
+       });
+
+    return dynamic_pointer_cast<SparseMatrix<double>>
+      (SparseMatrix<double>::CreateFromCOO (rows, cols, vals, fine.GetNDof(), coarse.GetNDof()));
+  }
+
+
+  // H1AMG for a lowest order H1 matrix, the weights are taken from the matrix entries
+  static shared_ptr<BaseMatrix> CreateMatrixH1AMG (shared_ptr<BaseSparseMatrix> bmat,
+                                                   shared_ptr<BitArray> freedofs)
+  {
+    auto smat = dynamic_pointer_cast<SparseMatrixTM<double>> (bmat);
+    if (!smat)
+      throw Exception ("PMultigrid: coarsetype 'h1amg' needs a real matrix");
+    bool symmetric = dynamic_pointer_cast<SparseMatrixSymmetric<double>> (bmat) != nullptr;
+
+    size_t n = smat->Height();
+    Array<INT<2>> e2v;
+    Array<double> edge_weights;
+    Array<double> vertex_weights(n);
+    vertex_weights = 0.0;
+    for (size_t i = 0; i < n; i++)
+      {
+        auto cols = smat->GetRowIndices(i);
+        auto vals = smat->GetRowValues(i);
+        for (size_t j = 0; j < cols.Size(); j++)
+          {
+            size_t c = cols[j];
+            vertex_weights[i] += vals[j];
+            if (c == i) continue;
+            if (symmetric)
+              vertex_weights[c] += vals[j];
+            else if (c < i)
+              continue;
+            e2v.Append (INT<2> (min(i,c), max(i,c)));
+            edge_weights.Append (fabs(vals[j]));
+          }
+      }
+    // the row sum is the zero-order part of the vertex
+    for (auto & w : vertex_weights)
+      w = max(w, 0.0);
+
+    return make_shared<H1AMG_Matrix<double>> (smat, freedofs, e2v, edge_weights, vertex_weights, 0);
+  }
+
+
+  PMultigrid_Matrix :: PMultigrid_Matrix (shared_ptr<FESpace> afes,
+                                          shared_ptr<BaseSparseMatrix> amat,
+                                          shared_ptr<BitArray> freedofs,
+                                          const PMultigrid_Parameters & param)
+    : size(amat->Height()), fes(afes), mat(amat), smoothing_steps(param.smoothing_steps)
+  {
+    static Timer t("PMultigrid setup"); RegionTimer reg(t);
+
+    int order = fes->GetOrder();
+    cout << IM(4) << "PMultigrid: order " << order << ", ndof = " << size << endl;
+
+    if (order <= param.coarse_order)
+      {
+        if (param.coarse_type == "h1amg")
+          coarse_precond = CreateMatrixH1AMG (mat, freedofs);
+        else if (param.coarse_type == "direct")
+          {
+            mat->SetInverseType (param.inverse_type);
+            coarse_precond = mat->InverseMatrix (freedofs);
+          }
+        else
+          throw Exception ("PMultigrid: unknown coarsetype '" + param.coarse_type + "'");
+        return;
+      }
+
+    smoother = mat->CreateBlockJacobiPrecond (fes->CreateSmoothingBlocks (param.block_flags),
+                                              nullptr, true, freedofs);
+
+    int corder = (param.order_step > 0) ? order - param.order_step : order / 2;
+    corder = max(corder, param.coarse_order);
+
+    Flags cflags = fes->GetFlags();
+    cflags.SetFlag ("order", corder);
+    auto cfes = CreateFESpace (fes->type, fes->GetMeshAccess(), cflags);
+    cfes->Update();
+    cfes->FinalizeUpdate();
+
+    LocalHeap lh(10*1000*1000, "PMultigrid");
+    auto prol = CreateEmbeddingMatrix (*fes, *cfes, lh);
+    auto rest = dynamic_pointer_cast<SparseMatrixTM<double>> (prol->CreateTranspose());
+    auto cmat = mat->Restrict (*prol);
+    if (cmat->Height() != cfes->GetNDof())
+      throw Exception ("PMultigrid: coarse space is not embedded in the fine space");
+
+    if (mat->IsComplex())
+      {
+        prolongation = make_shared<Real2ComplexMatrix<double,Complex>> (prol);
+        restriction = make_shared<Real2ComplexMatrix<double,Complex>> (rest);
+      }
+    else
+      {
+        prolongation = prol;
+        restriction = rest;
+      }
+
+    coarse_precond = make_shared<PMultigrid_Matrix> (cfes, cmat, cfes->GetFreeDofs(), param);
+  }
+
+
+  void PMultigrid_Matrix :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    static Timer t("PMultigrid::Mult"); RegionTimer reg(t);
+    if (!smoother)
+      {
+        coarse_precond->Mult (b, x);
+        return;
+      }
+
+    x = 0;
+    smoother->GSSmooth (x, b, smoothing_steps);
+
+    auto residuum = b.CreateVector();
+    residuum = b - (*mat) * x;
+
+    auto coarse_residuum = coarse_precond->CreateColVector();
+    coarse_residuum = *restriction * residuum;
+
+    auto coarse_x = coarse_precond->CreateColVector();
+    coarse_precond->Mult (coarse_residuum, coarse_x);
+
+    x += *prolongation * coarse_x;
+    smoother->GSSmoothBack (x, b, smoothing_steps);
+  }
+
+  int PMultigrid_Matrix :: GetNLevels () const
+  {
+    if (auto coarse_pmg = dynamic_pointer_cast<PMultigrid_Matrix> (coarse_precond))
+      return 1 + coarse_pmg->GetNLevels();
+    return 1;
+  }
+
+
+
+  class PMultigrid_Preconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BitArray> freedofs;
+    shared_ptr<PMultigrid_Matrix> mat;
+    PMultigrid_Parameters param;
+
+  public:
+    PMultigrid_Preconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                               const string aname = "pmultigrid")
+      : Preconditioner (abfa, aflags, aname), bfa(abfa)
+    {
+      param.coarse_order = int(flags.GetNumFlag ("coarseorder", param.coarse_order));
+      param.order_step = int(flags.GetNumFlag ("orderstep", param.order_step));
+      param.smoothing_steps = int(flags.GetNumFlag ("smoothingsteps", param.smoothing_steps));
+      param.coarse_type = flags.GetStringFlag ("coarsetype", param.coarse_type);
+      param.inverse_type = flags.GetStringFlag ("inverse", param.inverse_type);
+      param.block_flags = flags;
+      cout << IM(3) << "Create PMultigrid" << endl;
+    }
+
+    PMultigrid_Preconditioner (const PDE & pde, const Flags & aflags, const string & aname)
+      : PMultigrid_Preconditioner (pde.GetBilinearForm (aflags.GetStringFlag ("bilinearform")),
+                                   aflags, aname)
+    { ; }
+
+    virtual void InitLevel (shared_ptr<BitArray> _freedofs) override
+    {
+      freedofs = _freedofs;
+    }
+
+    virtual void FinalizeLevel (const BaseMatrix * matrix) override
+    {
+      static Timer t("PMultigrid_Preconditioner setup"); RegionTimer reg(t);
+
+      if (bfa->UsesEliminateInternal())
+        throw Exception ("PMultigrid: static condensation is not supported");
+      auto smat = dynamic_pointer_cast<BaseSparseMatrix> (const_cast<BaseMatrix*>(matrix)->shared_from_this());
+      if (!smat)
+        throw Exception (string("PMultigrid: expected a sparse matrix, but got a matrix of type ")
+                         + typeid(*matrix).name());
+
+      mat = make_shared<PMultigrid_Matrix> (bfa->GetFESpace(), smat, freedofs, param);
+      cout << IM(3) << "PMultigrid: levels = " << mat->GetNLevels() << endl;
+    }
+
+    virtual void Update () override { ; }
+
+    virtual const BaseMatrix & GetMatrix() const override
+    {
+      if (!mat)
+        ThrowPreconditionerNotReady();
+      return *mat;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const override
+    {
+      return bfa->GetMatrix();
+    }
+
+    virtual const char * ClassName() const override
+    { return "PMultigrid Preconditioner"; }
+  };
+
+
+  static RegisterPreconditioner<PMultigrid_Preconditioner> init_pmultigrid ("pmultigrid");
+}
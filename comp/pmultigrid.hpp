@@ -0,0 +1,67 @@
+#ifndef PMULTIGRID_HPP_
+#define PMULTIGRID_HPP_
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+  struct PMultigrid_Parameters
+  {
+    /// order of the coarsest level
+    int coarse_order = 1;
+    /// order reduction per level, 0 halves the order
+    int order_step = 0;
+    int smoothing_steps = 1;
+    /// solver on the coarsest level, "direct" or "h1amg"
+    std::string coarse_type = "direct";
+    std::string inverse_type = "sparsecholesky";
+    /// passed to CreateSmoothingBlocks of the spaces
+    Flags block_flags;
+  };
+
+
+  /*
+    p-version multigrid on a fixed mesh.
+
+    The next coarser level is a copy of the space with reduced order. The
+    prolongation is the embedding of the coarse space into the fine one,
+    computed by element-wise L2 projection. For hierarchical bases it is an
+    injection. Coarse matrices are Galerkin projections, smoothing is block
+    Gauss-Seidel with the blocks of CreateSmoothingBlocks.
+  */
+  class NGS_DLL_HEADER PMultigrid_Matrix : public ngla::BaseMatrix
+  {
+    size_t size;
+    std::shared_ptr<FESpace> fes;
+    std::shared_ptr<ngla::BaseSparseMatrix> mat;
+    std::shared_ptr<ngla::BaseBlockJacobiPrecond> smoother;
+    std::shared_ptr<ngla::BaseMatrix> prolongation, restriction;
+    std::shared_ptr<ngla::BaseMatrix> coarse_precond;
+    int smoothing_steps = 1;
+
+  public:
+    PMultigrid_Matrix (std::shared_ptr<FESpace> afes,
+                       std::shared_ptr<ngla::BaseSparseMatrix> amat,
+                       std::shared_ptr<ngcore::BitArray> freedofs,
+                       const PMultigrid_Parameters & param);
+
+    virtual int VHeight() const override { return size; }
+    virtual int VWidth() const override { return size; }
+    virtual bool IsComplex() const override { return mat->IsComplex(); }
+
+    virtual AutoVector CreateRowVector () const override { return mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateRowVector(); }
+
+    virtual void Mult (const ngla::BaseVector & b, ngla::BaseVector & x) const override;
+
+    /// number of levels including the coarse solver
+    int GetNLevels () const;
+  };
+
+
+  /// embedding of coarse into fine, coarse must be a subspace of fine
+  NGS_DLL_HEADER shared_ptr<SparseMatrix<double>>
+  CreateEmbeddingMatrix (const FESpace & fine, const FESpace & coarse, LocalHeap & lh);
+}
+
+#endif // PMULTIGRID_HPP_
@@ -469,6 +469,7 @@ namespace ngcomp
         u.GetVector(mdcomp) = 0.0;
         
         ProgressOutput progress (ma, "setvalues element", ma->GetNE(vb));
+        SIMDFallbackCounter simd_fallback("SetValues");
         IterateElements 
           (*fes, vb, clh, 
            [&] (FESpace::Element ei, LocalHeap & lh)
@@ -567,8 +568,10 @@ namespace ngcomp
 		     for (auto bfi : bli)
 		       { bfi->SetSimdEvaluate(false); }
 		     cout << IM(4) << "Warning: switching to std evalution in SetValues since: " << e.What() << endl;
+                     simd_fallback.Fallback (e);
                    }
                } // ( use_simd )
+             simd_fallback.CountScalarElement();
              
 	     /** Calc RHS **/
              /*
@@ -690,6 +693,7 @@ namespace ngcomp
         u.GetVector(mdcomp) = 0.0;
         
         ProgressOutput progress (ma, "setvalues element", ma->GetNE(vb));
+        SIMDFallbackCounter simd_fallback("SetValues");
         
         auto cachecfs = FindCacheCF (*coef);
         IterateElements 
@@ -793,9 +797,11 @@ namespace ngcomp
                    {
                      use_simd = false;
                      cout << IM(4) << "Warning: switching to std evalution in SetValues since: " << e.What() << endl;
+                     simd_fallback.Fallback (e);
                    }
                }
              
+             simd_fallback.CountScalarElement();
              IntegrationRule ir(fel.ElementType(), 2*fel.Order() + bonus_intorder);
              FlatMatrix<SCAL> mfluxi(ir.GetNIP(), dimflux, lh);
              
@@ -927,6 +933,287 @@ namespace ngcomp
 
 
 
+  InterpolationOperator :: InterpolationOperator (shared_ptr<FESpace> afes, VorB avb, const Region * reg,
+                                                  LocalHeap & clh, int abonus_intorder)
+    : fes(afes), vb(avb), bonus_intorder(abonus_intorder)
+  {
+    static Timer t("InterpolationOperator setup"); RegionTimer rt(t);
+
+    auto ma = afes->GetMeshAccess();
+    auto diffop = afes->GetEvaluator(vb);
+    if (!diffop)
+      throw Exception(afes->GetClassName()+string(" does not have an evaluator for ")+ToString(vb)+string("!"));
+    dimflux = diffop->Dim();
+    int dim = afes->GetDimension();
+    ndof = afes->GetNDof();
+    timestamp = ma->GetTimeStamp();
+
+    size_t ne = ma->GetNE(vb);
+    Array<int> sizes(ne);
+    nip.SetSize(ne);
+    intorder.SetSize(ne);
+    sizes = 0;
+    nip = 0;
+    intorder = 0;
+
+    // the same elements as in SetValues
+    auto used = [&] (ElementId ei)
+      {
+        if (!afes->DefinedOn(ei)) return false;
+        int index = ma->GetElIndex(ei);
+        if (reg) return reg->Mask().Test(index);
+        return vb != BND || afes->IsDirichletBoundary(index);
+      };
+
+    ParallelForRange
+      (ne, [&] (IntRange r)
+       {
+         LocalHeap lh = clh.Split();
+         for (auto i : r)
+           {
+             HeapReset hr(lh);
+             ElementId ei(vb, i);
+             if (!used(ei)) continue;
+             const FiniteElement & fel = afes->GetFE (ei, lh);
+             intorder[i] = 2*fel.Order() + bonus_intorder;
+             nip[i] = SelectIntegrationRule (fel.ElementType(), intorder[i]).Size();
+             sizes[i] = fel.GetNDof()*dim * nip[i]*dimflux;
+           }
+       });
+
+    proj = Table<double> (sizes);
+
+    // P = M^{-1} B^T W, the columns are ordered by integration point, then component
+    ParallelForRange
+      (ne, [&] (IntRange r)
+       {
+         LocalHeap lh = clh.Split();
+         for (auto i : r)
+           {
+             if (!sizes[i]) continue;
+             HeapReset hr(lh);
+             ElementId ei(vb, i);
+             const FiniteElement & fel = afes->GetFE (ei, lh);
+             const ElementTransformation & trafo = ma->GetTrafo (ei, lh);
+             const IntegrationRule & ir = SelectIntegrationRule (fel.ElementType(), intorder[i]);
+             auto & mir = trafo(ir, lh);
+
+             size_t nd = fel.GetNDof()*dim;
+             FlatMatrix<> mass(nd, nd, lh), bw(nd, nip[i]*dimflux, lh);
+             FlatMatrix<double,ColMajor> bmat(dimflux, nd, lh);
+             mass = 0.0;
+             for (size_t q = 0; q < ir.Size(); q++)
+               {
+                 HeapReset hr(lh);
+                 diffop->CalcMatrix (fel, mir[q], bmat, lh);
+                 double w = mir[q].GetWeight();
+                 mass += w * Trans(bmat) * bmat;
+                 bw.Cols(q*dimflux, (q+1)*dimflux) = w * Trans(bmat);
+               }
+             CalcInverse (mass);
+             FlatMatrix<> p(nd, nip[i]*dimflux, proj[i].Data());
+             p = mass * bw;
+           }
+       });
+
+    cnti.SetSize(ndof);
+    cnti = 0;
+    Array<DofId> dnums;
+    for (size_t i = 0; i < ne; i++)
+      if (sizes[i])
+        {
+          afes->GetDofNrs (ElementId(vb, i), dnums);
+          for (auto d : dnums)
+            if (IsRegularDof(d)) cnti[d]++;
+        }
+#ifdef PARALLEL
+    AllReduceDofData (cnti, MPI_SUM, afes->GetParallelDofs());
+#endif
+  }
+
+  bool InterpolationOperator :: IsUpToDate () const
+  {
+    auto sp = fes.lock();
+    return sp && sp->GetNDof() == ndof && sp->GetMeshAccess()->GetTimeStamp() == timestamp;
+  }
+
+  static INLINE double GetLane (SIMD<double> a, int i) { return a[i]; }
+  static INLINE Complex GetLane (SIMD<Complex> a, int i) { return Complex(a.real()[i], a.imag()[i]); }
+
+  template <class SCAL>
+  void InterpolationOperator :: T_Set (CoefficientFunction & coef, GridFunction & u, LocalHeap & clh,
+                                       bool use_simd, int mdcomp) const
+  {
+    static Timer t("InterpolationOperator::Set"); RegionTimer reg(t);
+
+    if (!IsUpToDate())
+      throw Exception("InterpolationOperator: mesh or space changed since construction");
+    auto fes = u.GetFESpace();
+    if (fes != this->fes.lock())
+      throw Exception("InterpolationOperator: gridfunction is not on the space of the operator");
+    if (coef.Dimension() != dimflux)
+      throw Exception(string("Error in InterpolationOperator: gridfunction-dim = ") + ToString(dimflux) +
+                      ", but coefficient-dim = " + ToString(coef.Dimension()));
+
+    u.GetVector(mdcomp) = 0.0;
+    SIMDFallbackCounter simd_fallback("InterpolationOperator::Set");
+    // cleared by the first element without SIMD evaluation, read by all threads
+    atomic<bool> try_simd(use_simd);
+    auto cachecfs = FindCacheCF (coef);
+    constexpr int W = SIMD<double>::Size();
+
+    IterateElements
+      (*fes, vb, clh,
+       [&] (FESpace::Element ei, LocalHeap & lh)
+       {
+         auto p = proj[ei.Nr()];
+         if (!p.Size()) return;
+
+         const ElementTransformation & trafo = ei.GetTrafo();
+         const IntegrationRule & ir = SelectIntegrationRule (trafo.GetElementType(), intorder[ei.Nr()]);
+         FlatMatrix<SCAL> values(ir.Size(), dimflux, lh);
+         ProxyUserData ud;
+         const_cast<ElementTransformation&>(trafo).userdata = &ud;
+
+         bool simd_element = try_simd.load(memory_order_relaxed);
+         if (simd_element)
+           {
+             try
+               {
+                 SIMD_IntegrationRule simd_ir(ir, lh);
+                 auto & mir = trafo(simd_ir, lh);
+                 PrecomputeCacheCF (cachecfs, mir, lh);
+                 FlatMatrix<SIMD<SCAL>> simd_values(dimflux, simd_ir.Size(), lh);
+                 coef.Evaluate (mir, simd_values);
+                 for (size_t q = 0; q < ir.Size(); q++)
+                   for (int k = 0; k < dimflux; k++)
+                     values(q,k) = GetLane (simd_values(k, q/W), q%W);
+               }
+             catch (const ExceptionNOSIMD& e)
+               {
+                 simd_element = false;
+                 try_simd = false;
+                 cout << IM(4) << "Warning: switching to std evalution in InterpolationOperator since: " << e.What() << endl;
+                 simd_fallback.Fallback (e);
+               }
+           }
+         if (!simd_element)
+           {
+             simd_fallback.CountScalarElement();
+             auto & mir = trafo(ir, lh);
+             PrecomputeCacheCF (cachecfs, mir, lh);
+             coef.Evaluate (mir, values);
+           }
+
+         size_t nd = p.Size() / (ir.Size()*dimflux);
+         FlatMatrix<> pmat(nd, ir.Size()*dimflux, p.Data());
+         FlatVector<SCAL> elvec(nd, lh), elold(nd, lh);
+         elvec = pmat * values.AsVector();
+
+         fes->TransformVec (ei, elvec, TRANSFORM_SOL_INVERSE);
+         u.GetElementVector (mdcomp, ei.GetDofs(), elold);
+         elvec += elold;
+         u.SetElementVector (mdcomp, ei.GetDofs(), elvec);
+       });
+
+#ifdef PARALLEL
+    u.GetVector(mdcomp).SetParallelStatus(DISTRIBUTED);
+    u.GetVector(mdcomp).Cumulate();
+#endif
+
+    int dim = fes->GetDimension();
+    ParallelForRange
+      (cnti.Size(), [&] (IntRange r)
+       {
+         VectorMem<10,SCAL> fluxi(dim);
+         ArrayMem<int,1> dnums(1);
+         for (auto i : r)
+           if (cnti[i] > 1)
+             {
+               dnums[0] = i;
+               u.GetElementVector (mdcomp, dnums, fluxi);
+               fluxi /= double (cnti[i]);
+               u.SetElementVector (mdcomp, dnums, fluxi);
+             }
+       });
+  }
+
+  void InterpolationOperator :: Set (shared_ptr<CoefficientFunction> coef, GridFunction & u, LocalHeap & lh,
+                                     bool use_simd, int mdcomp) const
+  {
+    if (u.GetFESpace()->IsComplex())
+      T_Set<Complex> (*coef, u, lh, use_simd, mdcomp);
+    else
+      T_Set<double> (*coef, u, lh, use_simd, mdcomp);
+  }
+
+
+  struct InterpolationCacheEntry
+  {
+    weak_ptr<FESpace> fes;
+    VorB vb;
+    int bonus_intorder;
+    /// region mask, empty for the default elements
+    shared_ptr<BitArray> mask;
+    shared_ptr<InterpolationOperator> op;
+  };
+
+  static mutex interpolation_cache_mutex;
+  static Array<InterpolationCacheEntry> interpolation_cache;
+
+  size_t InterpolationCacheSize ()
+  {
+    lock_guard<mutex> guard(interpolation_cache_mutex);
+    for (size_t i = interpolation_cache.Size(); i-- > 0; )
+      if (interpolation_cache[i].fes.expired())
+        interpolation_cache.DeleteElement(i);
+    return interpolation_cache.Size();
+  }
+
+  shared_ptr<InterpolationOperator>
+  GetInterpolationOperator (shared_ptr<FESpace> fes, VorB vb, const Region * reg,
+                            LocalHeap & lh, int bonus_intorder)
+  {
+    auto & cache_mutex = interpolation_cache_mutex;
+    auto & cache = interpolation_cache;
+
+    if (reg) vb = reg->VB();
+    auto same_mask = [reg] (const shared_ptr<BitArray> & mask)
+      {
+        if (!reg || !mask) return !reg && !mask;
+        const BitArray & rmask = reg->Mask();
+        if (rmask.Size() != mask->Size()) return false;
+        for (size_t i = 0; i < rmask.Size(); i++)
+          if (rmask.Test(i) != mask->Test(i)) return false;
+        return true;
+      };
+
+    {
+      lock_guard<mutex> guard(cache_mutex);
+      for (size_t i = cache.Size(); i-- > 0; )
+        {
+          auto & entry = cache[i];
+          if (entry.fes.expired())
+            { cache.DeleteElement(i); continue; }
+          if ( (entry.fes.lock() != fes) || (entry.vb != vb) ||
+               (entry.bonus_intorder != bonus_intorder) || !same_mask(entry.mask) )
+            { continue; }
+          if (entry.op->IsUpToDate())
+            { return entry.op; }
+          cache.DeleteElement(i); // outdated
+        }
+    }
+
+    auto op = make_shared<InterpolationOperator> (fes, vb, reg, lh, bonus_intorder);
+
+    lock_guard<mutex> guard(cache_mutex);
+    cache.Append (InterpolationCacheEntry { fes, vb, bonus_intorder,
+                                            reg ? make_shared<BitArray> (reg->Mask()) : nullptr, op });
+    return op;
+  }
+
+
+
 
   template <class SCAL>
   void CalcError (const S_GridFunction<SCAL> & u,
@@ -1506,6 +1793,191 @@ namespace ngcomp
 			      S_BaseVector<double> & vech1);
 
 */
+
+
+  
+  template <typename TSCAL>
+  Array<Vector<TSCAL>> IntegrateBatch (const MeshAccess & ma,
+                                       FlatArray<BatchIntegrand> integrands)
+  {
+    static Timer t("IntegrateBatch"); RegionTimer reg(t);
+
+    auto same_mask = [] (const BitArray & a, const BitArray & b)
+      {
+        if (a.Size() != b.Size()) return false;
+        for (size_t i = 0; i < a.Size(); i++)
+          if (a.Test(i) != b.Test(i)) return false;
+        return true;
+      };
+
+    // integrands with the same domain and order are evaluated together
+    struct Group
+    {
+      const BatchIntegrand * domain;
+      Array<int> members;
+      Array<shared_ptr<CoefficientFunction>> cfs;
+      shared_ptr<CoefficientFunction> cf;
+      size_t first;              // first component in the total sum
+      int nr;
+    };
+    Array<Group> groups;
+    Array<int> group_of(integrands.Size());
+
+    for (auto i : Range(integrands))
+      {
+        auto & in = integrands[i];
+        int g = -1;
+        for (auto j : Range(groups))
+          {
+            auto & d = *groups[j].domain;
+            if (d.vb == in.vb && d.order == in.order && d.deformation == in.deformation &&
+                d.elements == in.elements && same_mask(d.regions, in.regions))
+              g = j;
+          }
+        if (g == -1)
+          {
+            g = groups.Size();
+            groups.Append (Group{ &in });
+            groups[g].nr = g;
+          }
+        groups[g].members.Append (i);
+        groups[g].cfs.Append (in.cf);
+        group_of[i] = g;
+      }
+
+    size_t total = 0;
+    for (auto & g : groups)
+      {
+        g.first = total;
+        g.cf = g.cfs.Size() == 1 ? g.cfs[0] : MakeVectorialCoefficientFunction (Array<shared_ptr<CoefficientFunction>>(g.cfs));
+        g.cf = Compile (g.cf);
+        total += g.cf->Dimension();
+      }
+
+    // per-thread partial sums, no atomics in the element loop
+    Array<Vector<TSCAL>> thread_sums(TaskManager::GetMaxThreads());
+    for (auto & ts : thread_sums)
+      {
+        ts.SetSize(total);
+        ts = TSCAL(0.0);
+      }
+
+    // SIMD state per group, cleared by any thread of the element loop.
+    // The fallback entry is set before the flag is cleared, so a scalar element is always counted
+    Array<atomic<bool>> group_simd(groups.Size());
+    for (auto & gs : group_simd)
+      gs = true;
+    Array<unique_ptr<SIMDFallbackCounter>> group_fallback;
+    for (size_t i = 0; i < groups.Size(); i++)
+      group_fallback.Append (make_unique<SIMDFallbackCounter> ("IntegrateBatch"));
+
+    LocalHeap glh(10000000, "integrate-batch-lh");
+
+    // one sweep per VorB and deformation
+    Array<bool> done(groups.Size());
+    done = false;
+    for (auto gi : Range(groups))
+      {
+        if (done[gi]) continue;
+        VorB vb = groups[gi].domain->vb;
+        auto deformation = groups[gi].domain->deformation;
+
+        Array<Group*> sweep;
+        for (auto gj : Range(groups))
+          if (!done[gj] && groups[gj].domain->vb == vb && groups[gj].domain->deformation == deformation)
+            {
+              sweep.Append (&groups[gj]);
+              done[gj] = true;
+            }
+        // same order next to each other, to reuse the mapped rule
+        QuickSort (sweep, [] (Group * a, Group * b) { return a->domain->order < b->domain->order; });
+
+        ma.IterateElements
+          (vb, glh, [&] (Ngs_Element el, LocalHeap & lh)
+           {
+             auto & trafo1 = ma.GetTrafo (el, lh);
+             auto & trafo = trafo1.AddDeformation(deformation.get(), lh);
+             auto et = trafo.GetElementType();
+             FlatVector<TSCAL> mysum = thread_sums[TaskManager::GetThreadId()];
+
+             int simd_order = -1, order = -1;
+             SIMD_BaseMappedIntegrationRule * simd_mir = nullptr;
+             BaseMappedIntegrationRule * mir = nullptr;
+             
+             for (Group * g : sweep)
+               {
+                 auto & d = *g->domain;
+                 if (d.regions.Size() && !d.regions.Test(el.GetIndex())) continue;
+                 if (d.elements && !d.elements->Test(el.Nr())) continue;
+                 int dim = g->cf->Dimension();
+
+                 if (group_simd[g->nr])
+                   {
+                     try
+                       {
+                         if (simd_order != d.order)
+                           {
+                             simd_mir = &trafo(SIMD_SelectIntegrationRule(et, d.order), lh);
+                             simd_order = d.order;
+                           }
+                         FlatMatrix<SIMD<TSCAL>> values(dim, simd_mir->Size(), lh);
+                         g->cf -> Evaluate (*simd_mir, values);
+                         for (size_t j = 0; j < dim; j++)
+                           {
+                             SIMD<TSCAL> vsum = TSCAL(0.0);
+                             for (size_t i = 0; i < values.Width(); i++)
+                               vsum += (*simd_mir)[i].GetWeight() * values(j,i);
+                             mysum(g->first+j) += HSum(vsum);
+                           }
+                         continue;
+                       }
+                     catch (const ExceptionNOSIMD & e)
+                       {
+                         group_fallback[g->nr]->Fallback (e);
+                         group_simd[g->nr] = false;
+                       }
+                   }
+                 
+                 group_fallback[g->nr]->CountScalarElement();
+                 if (order != d.order)
+                   {
+                     mir = &trafo(SelectIntegrationRule(et, d.order), lh);
+                     order = d.order;
+                   }
+                 FlatMatrix<TSCAL> values(mir->Size(), dim, lh);
+                 g->cf -> Evaluate (*mir, values);
+                 for (size_t i = 0; i < values.Height(); i++)
+                   mysum.Range(g->first, g->first+dim) += (*mir)[i].GetWeight() * values.Row(i);
+               }
+           });
+      }
+
+    Vector<TSCAL> sum(total);
+    sum = TSCAL(0.0);
+    for (auto & ts : thread_sums)
+      sum += ts;
+#ifdef PARALLEL
+    if (ma.GetCommunicator().Size() > 1 && total > 0)
+      MPI_Allreduce(MPI_IN_PLACE, &sum(0), total, MPI_typetrait<TSCAL>::MPIType(), MPI_SUM, ma.GetCommunicator());
+#endif
+
+    Array<Vector<TSCAL>> results(integrands.Size());
+    Array<size_t> offset(groups.Size());
+    for (auto i : Range(groups))
+      offset[i] = groups[i].first;
+    for (auto i : Range(integrands))
+      {
+        size_t dim = integrands[i].cf->Dimension();
+        int g = group_of[i];
+        results[i].SetSize(dim);
+        results[i] = sum.Range(offset[g], offset[g]+dim);
+        offset[g] += dim;
+      }
+    return results;
+  }
+
+  template Array<Vector<double>> IntegrateBatch<double> (const MeshAccess & ma, FlatArray<BatchIntegrand> integrands);
+  template Array<Vector<Complex>> IntegrateBatch<Complex> (const MeshAccess & ma, FlatArray<BatchIntegrand> integrands);
   
 }
 
@@ -1523,6 +1995,7 @@ namespace ngfem
   {
     LocalHeap glh(10000000, "integrate-lh");
     bool use_simd = true;
+    SIMDFallbackCounter simd_fallback("Integral::Integrate");
     TSCAL sum = 0.0;
 
     BitArray defon;
@@ -1577,10 +2050,12 @@ namespace ngfem
                      this_simd = false;
                      use_simd = false;
                      hsum = 0.0;
+                     simd_fallback.Fallback (e);
                    }
                }
              if (!this_simd)
                {
+                 simd_fallback.CountScalarElement();
                  IntegrationRule ir(trafo.GetElementType(), order);
                  BaseMappedIntegrationRule & mir = trafo(ir, lh);
                  FlatMatrix<TSCAL> values(ir.Size(), 1, lh);
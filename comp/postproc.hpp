@@ -56,6 +56,53 @@ namespace ngcomp
                   int bonus_intorder=0);
   
 
+  /**
+     Element-wise L2 projection onto a space, as in SetValues, with the
+     local projection matrices M_T^{-1} B_T^T W_T computed once. A Set call
+     only evaluates the coefficient function in the integration points and
+     applies one small matrix per element. Built for a fixed mesh and space.
+  */
+  class NGS_DLL_HEADER InterpolationOperator
+  {
+    /// not owning, the cache must not keep the space alive
+    weak_ptr<FESpace> fes;
+    VorB vb;
+    int bonus_intorder;
+    int dimflux;
+    size_t ndof, timestamp;
+    /// projection matrices, empty for elements which are not set
+    Table<double> proj;
+    Array<int> nip;
+    Array<int> intorder;
+    /// number of elements sharing a dof
+    Array<int> cnti;
+
+    template <class SCAL>
+    void T_Set (CoefficientFunction & coef, GridFunction & u, LocalHeap & lh,
+                bool use_simd, int mdcomp) const;
+  public:
+    InterpolationOperator (shared_ptr<FESpace> afes, VorB avb, const Region * reg,
+                           LocalHeap & lh, int abonus_intorder = 0);
+
+    void Set (shared_ptr<CoefficientFunction> coef, GridFunction & u, LocalHeap & lh,
+              bool use_simd = true, int mdcomp = 0) const;
+
+    /// false if the mesh or the space changed since construction, or the space is gone
+    bool IsUpToDate () const;
+    shared_ptr<FESpace> GetFESpace () const { return fes.lock(); }
+    VorB VB () const { return vb; }
+    int BonusIntOrder () const { return bonus_intorder; }
+  };
+
+  /// Cached InterpolationOperator, rebuilt when the mesh or the space changes
+  extern NGS_DLL_HEADER shared_ptr<InterpolationOperator>
+  GetInterpolationOperator (shared_ptr<FESpace> fes, VorB vb, const Region * reg,
+                            LocalHeap & lh, int bonus_intorder = 0);
+
+  /// number of cached InterpolationOperators, entries of deleted spaces are dropped
+  extern NGS_DLL_HEADER size_t InterpolationCacheSize ();
+
+
   template <class SCAL>
   extern NGS_DLL_HEADER
   int CalcPointFlux (const GridFunction & u,
@@ -126,6 +173,29 @@ namespace ngcomp
 			     S_BaseVector<SCAL> & vech1);
 
 
+  /// one function to be integrated by IntegrateBatch
+  struct BatchIntegrand
+  {
+    shared_ptr<CoefficientFunction> cf;
+    VorB vb = VOL;
+    int order = 5;
+    BitArray regions;                   // empty: all regions
+    shared_ptr<BitArray> elements;      // optional element mask
+    shared_ptr<GridFunction> deformation;
+  };
+
+  /*
+    Integrates many functions in one sweep over the mesh per VorB.
+    Integrands with the same order and domain are compiled into one
+    vectorial function, such that common sub-expressions and the mapped
+    integration rule are shared. Returns one vector per integrand.
+  */
+  template <typename TSCAL>
+  extern NGS_DLL_HEADER
+  Array<Vector<TSCAL>> IntegrateBatch (const MeshAccess & ma,
+                                       FlatArray<BatchIntegrand> integrands);
+
+
   template <class SCAL>
   extern NGS_DLL_HEADER 
   void CalcErrorHierarchical (const S_BilinearForm<SCAL> & bfa,
@@ -370,6 +370,51 @@ ANY_DOF: Any used dof (LOCAL_DOF or INTERFACE_DOF or WIREBASKET_DOF)
                   {
                     code_uses_tensors = val;
                   }, "Use tensors in code-generation")
+    .def_property("sparsecholesky_scratchdir",
+                  [] (GlobalDummyVariables&)
+                  {
+                    return sparsecholesky_scratchdir;
+                  },
+                  [] (GlobalDummyVariables&, string val)
+                  {
+                    sparsecholesky_scratchdir = val;
+                  }, "Directory for out-of-core SparseCholesky factors, empty string keeps factors in memory")
+    .def_property("sparsecholesky_outofcore_threshold",
+                  [] (GlobalDummyVariables&)
+                  {
+                    return sparsecholesky_outofcore_threshold;
+                  },
+                  [] (GlobalDummyVariables&, size_t val)
+                  {
+                    sparsecholesky_outofcore_threshold = val;
+                  }, "Factors larger than this (in bytes) are stored in sparsecholesky_scratchdir")
+    .def_property("shape_cache_max_bytes",
+                  [] (GlobalDummyVariables&)
+                  {
+                    return shape_cache_max_bytes;
+                  },
+                  [] (GlobalDummyVariables&, size_t val)
+                  {
+                    shape_cache_max_bytes = val;
+                  }, "Memory for cached SIMD shape tables of scalar elements, 0 disables the cache")
+    .def_property("agglomeration_groupsize",
+                  [] (GlobalDummyVariables&)
+                  {
+                    return agglomeration_groupsize;
+                  },
+                  [] (GlobalDummyVariables&, int val)
+                  {
+                    agglomeration_groupsize = val;
+                  }, "Number of ranks per group of the agglomerated parallel direct solver, 0 for sqrt(ranks)")
+    .def_property("agglomeration_minranks",
+                  [] (GlobalDummyVariables&)
+                  {
+                    return agglomeration_minranks;
+                  },
+                  [] (GlobalDummyVariables&, int val)
+                  {
+                    agglomeration_minranks = val;
+                  }, "Distributed matrices are inverted by the agglomerated solver from this number of ranks on, 0 for never")
                   
     ;
 
@@ -931,6 +976,24 @@ Parameters:
 ni : ngsolve.comp.NodeId
   input node id
 
+)raw_string"))
+
+    .def("ElementColoring", [](shared_ptr<FESpace> self, VorB vb)
+         {
+           py::list colors;
+           for (FlatArray<int> els_of_col : self->ElementColoring(vb))
+             colors.append (MakePyTuple(els_of_col));
+           return colors;
+         }, py::arg("VOL_or_BND")=VOL, docu_string(R"raw_string(
+Returns the element numbers of each color used for parallel assembly.
+Elements of one color do not share dofs, and are sorted by element type,
+region and number of dofs.
+
+Parameters:
+
+VOL_or_BND : ngsolve.comp.VorB
+  input VOL, BND, BBND,...
+
 )raw_string"))
 
     .def ("GetDofs", [](shared_ptr<FESpace> self, Region reg)
@@ -1715,19 +1778,27 @@ fespace : ngsolve.comp.FESpace
   
   py::class_<ReorderedFESpace, shared_ptr<ReorderedFESpace>, FESpace>(m, "Reorder",
 	docu_string(R"delimiter(Reordered Finite Element Spaces.
-...
+
+Renumbers the dofs of the wrapped space for memory locality. Matrices and
+vectors of forms and GridFunctions on the reordered space use the new numbering.
+
+ordering : string
+  "clusters" : clusters grown from seed elements (default)
+  "rcm" : bandwidth reducing reverse Cuthill-McKee
+  "hilbert", "morton" : first touch along a space-filling curve through the element centers
 )delimiter"))
-    .def(py::init([] (shared_ptr<FESpace> & fes, bool autoupdate)
+    .def(py::init([] (shared_ptr<FESpace> & fes, bool autoupdate, string ordering)
                   {
                     Flags flags = fes->GetFlags();
                     flags.SetFlag("autoupdate", autoupdate || fes->DoesAutoUpdate());
+                    flags.SetFlag("ordering", ordering);
                     auto refes = make_shared<ReorderedFESpace>(fes, flags);
                     // MR: Update() always updates wrapped space
                     refes->Update();
                     refes->FinalizeUpdate();
                     connect_auto_update(refes.get());
                     return refes;
-                  }), py::arg("fespace"), py::arg("autoupdate")=false)
+                  }), py::arg("fespace"), py::arg("autoupdate")=false, py::arg("ordering")="clusters")
     .def("GetClusters", &ReorderedFESpace::GetClusters)
     /*
     .def(py::pickle([](const PeriodicFESpace* per_fes)
@@ -2065,7 +2136,8 @@ parallel : bool
 )raw_string"))
     .def("Set", 
          [](shared_ptr<GF> self, spCF cf,
-            VorB vb, py::object definedon, bool dualdiffop, bool use_simd, int mdcomp, optional<shared_ptr<BitArray>> definedonelements, int bonus_intorder)
+            VorB vb, py::object definedon, bool dualdiffop, bool use_simd, int mdcomp, optional<shared_ptr<BitArray>> definedonelements, int bonus_intorder,
+            bool cache)
          {
            shared_ptr<TPHighOrderFESpace> tpspace = dynamic_pointer_cast<TPHighOrderFESpace>(self->GetFESpace());          
             Region * reg = nullptr;
@@ -2079,6 +2151,16 @@ parallel : bool
               Transfer2TPMesh(cf.get(),self.get(),glh);
               return;
             }            
+            if (cache)
+              {
+                if (dualdiffop || definedonelements.has_value())
+                  throw Exception("Set: cache is not supported together with dual or definedonelements");
+                if (vb == VOL && !reg && mdcomp == 0 && SetFromOtherMesh (cf, *self, glh, bonus_intorder))
+                  return;
+                auto op = GetInterpolationOperator (self->GetFESpace(), vb, reg, glh, bonus_intorder);
+                op->Set (cf, *self, glh, use_simd, mdcomp);
+                return;
+              }
             if (reg)
               SetValues (cf, *self, *reg, NULL, glh, dualdiffop, use_simd, mdcomp, definedonelements, bonus_intorder);
             else
@@ -2092,6 +2174,7 @@ parallel : bool
          py::arg("mdcomp")=0, 
          py::arg("definedonelements")=nullopt,
          py::arg("bonus_intorder")=0,
+         py::arg("cache")=false,
          docu_string(R"raw_string(
 Set values
 
@@ -2122,6 +2205,13 @@ definedonelements : nullopt
 bonus_intorder : int
   Increase numerical integration order.
 
+cache : bool
+  Keep the local projection matrices for repeated calls on the same
+  mesh and space, then Set only evaluates the coefficient.
+  For a GridFunction on another mesh, a MeshTransferOperator is kept
+  instead, rebuilt when one of the meshes moves or is deformed.
+  Not available for dual or definedonelements.
+
 )raw_string"))
 
     .def("Interpolate", 
@@ -2921,7 +3011,10 @@ flags : dict
                      "  This file must be set by ngsolve.SetTestoutFile. Use\n"
                      "  ngsolve.SetNumThreads(1) for serial output.",
                      py::arg("printelvec") = "bool\n"
-                     "  print element vectors to testout file"
+                     "  print element vectors to testout file",
+                     py::arg("overlap") = "bool\n"
+                     "  MPI only: assemble the elements at the subdomain interface first,\n"
+                     "  and cumulate the vector while the interior elements are assembled"
                      );
                 })
     .def("__str__",  [](LF & self ) { return ToString<LinearForm>(self); } )
@@ -3031,7 +3124,30 @@ integrator : ngsolve.fem.LFI
   prec_class
     .def(py::init([prec_class](shared_ptr<BilinearForm> bfa, const string & type, py::kwargs kwargs)
          {
+           // near-nullspace vectors (e.g. for saamg), not convertible to standard flags
+           Array<shared_ptr<BaseVector>> nullspace;
+           if (kwargs.contains("nullspace"))
+             {
+               py::object ns = kwargs.attr("pop")("nullspace");
+               if (py::isinstance<MultiVector>(ns))
+                 {
+                   auto mv = py::cast<shared_ptr<MultiVector>>(ns);
+                   for (size_t i = 0; i < mv->Size(); i++)
+                     nullspace.Append ((*mv)[i]);
+                 }
+               else
+                 for (auto v : ns)
+                   {
+                     if (py::isinstance<GridFunction>(v))
+                       nullspace.Append (py::cast<shared_ptr<GridFunction>>(v)->GetVectorPtr());
+                     else
+                       nullspace.Append (py::cast<shared_ptr<BaseVector>>(v));
+                   }
+             }
+
            auto flags = CreateFlagsFromKwArgs(kwargs, prec_class);
+           if (nullspace.Size())
+             flags.SetFlag("nullspace", nullspace);
 
            if (kwargs.contains("blockcreator"))
              {
@@ -3525,6 +3641,7 @@ integrator : ngsolve.fem.LFI
               region_sum = 0;
               element_sum = 0;
               bool use_simd = true;
+              SIMDFallbackCounter simd_fallback("Integrate");
               
               ma->IterateElements
                 (vb, glh, [&] (Ngs_Element el, LocalHeap & lh)
@@ -3556,10 +3673,12 @@ integrator : ngsolve.fem.LFI
                            this_simd = false;
                            use_simd = false;
                            hsum = 0.0;
+                           simd_fallback.Fallback (e);
                          }
                      }
                    if (!this_simd)
                      {
+                       simd_fallback.CountScalarElement();
                        IntegrationRule ir(trafo.GetElementType(), order);
                        BaseMappedIntegrationRule & mir = trafo(ir, lh);
                        FlatMatrix<> values(ir.Size(), dim, lh);
@@ -3623,6 +3742,7 @@ integrator : ngsolve.fem.LFI
               element_sum = 0;
               
               bool use_simd = true;
+              SIMDFallbackCounter simd_fallback("Integrate");
               
               ma->IterateElements
                 (vb, glh, [&] (Ngs_Element el, LocalHeap & lh)
@@ -3655,10 +3775,12 @@ integrator : ngsolve.fem.LFI
                            this_simd = false;
                            use_simd = false;
                            hsum = 0.0;
+                           simd_fallback.Fallback (e);
                          }
                      }
                    if (!this_simd)
                      {
+                       simd_fallback.CountScalarElement();
                        IntegrationRule ir(trafo.GetElementType(), order);
                        BaseMappedIntegrationRule & mir = trafo(ir, lh);
                        FlatMatrix<Complex> values(ir.Size(), dim, lh);
@@ -3802,6 +3924,147 @@ element_wise: bool = False
            */
          }, py::arg("igls"), py::arg("mesh"), py::arg("element_wise")=false);
 
+  m.def ("IntegrateBatch",
+         [] (vector<variant<spCF, shared_ptr<SumOfIntegrals>>> integrands,
+             shared_ptr<MeshAccess> ma, VorB vb, int order, optional<Region> definedon)
+         {
+           Array<BatchIntegrand> batch;
+           Array<IntRange> parts;     // integrands of one python argument
+           bool iscomplex = false;
+           
+           BatchIntegrand defaults;
+           defaults.vb = vb;
+           defaults.order = order;
+           if (definedon)
+             {
+               defaults.vb = VorB(*definedon);
+               defaults.regions = definedon->Mask();
+             }
+           
+           for (auto & item : integrands)
+             {
+               size_t first = batch.Size();
+               if (auto cf = get_if<spCF>(&item))
+                 {
+                   BatchIntegrand in = defaults;
+                   in.cf = *cf;
+                   batch.Append (in);
+                 }
+               else
+                 for (auto & icf : *get<shared_ptr<SumOfIntegrals>>(item))
+                   {
+                     auto & dx = icf->dx;
+                     if (dx.element_vb != VOL || dx.skeleton)
+                       throw Exception ("IntegrateBatch: only element-volume integrals are supported");
+                     if (icf->cf->Dimension() > 1)
+                       throw Exception("IntegrateBatch(cf*dx) needs scalar-valued CoefficientFunction");
+                     BatchIntegrand in;
+                     in.cf = icf->cf;
+                     in.vb = dx.vb;
+                     in.order = 5 + dx.bonus_intorder;
+                     in.elements = dx.definedonelements;
+                     in.deformation = dx.deformation;
+                     if (dx.definedon)
+                       {
+                         if (auto bits = get_if<BitArray> (&*dx.definedon))
+                           in.regions = *bits;
+                         if (auto name = get_if<string> (&*dx.definedon))
+                           in.regions = Region(ma, dx.vb, *name).Mask();
+                       }
+                     batch.Append (in);
+                   }
+               parts.Append (IntRange(first, batch.Size()));
+             }
+           
+           for (auto & in : batch)
+             {
+               iscomplex |= in.cf->IsComplex();
+               in.cf -> TraverseTree
+                 ([&] (CoefficientFunction & stepcf)
+                  {
+                    if (dynamic_cast<ProxyFunction*>(&stepcf))
+                      throw Exception("Cannot integrate ProxFunction!");
+                  });
+             }
+           
+           auto integrate = [&] (auto tscal)
+           {
+             typedef decltype(tscal) TSCAL;
+             Array<Vector<TSCAL>> vals;
+             {
+               py::gil_scoped_release release;
+               vals = IntegrateBatch<TSCAL> (*ma, batch);
+             }
+             
+             py::list result;
+             for (auto i : Range(parts))
+               {
+                 bool complex_part = false;
+                 for (auto j : parts[i])
+                   complex_part |= batch[j].cf->IsComplex();
+                 
+                 if (holds_alternative<spCF>(integrands[i]))
+                   {
+                     auto & v = vals[parts[i].First()];
+                     if (v.Size() == 1)
+                       result.append (complex_part ? py::cast(v(0)) : py::cast(ngbla::Real(v(0))));
+                     else if (complex_part)
+                       result.append (py::cast(Vector<TSCAL>(v)));
+                     else
+                       {
+                         Vector<double> rv(v.Size());
+                         for (auto k : Range(v))
+                           rv(k) = ngbla::Real(v(k));
+                         result.append (py::cast(rv));
+                       }
+                   }
+                 else
+                   {
+                     TSCAL sum = 0.0;
+                     for (auto j : parts[i])
+                       sum += vals[j](0);
+                     result.append (complex_part ? py::cast(sum) : py::cast(ngbla::Real(sum)));
+                   }
+               }
+             return result;
+           };
+           
+           if (iscomplex)
+             return integrate(Complex(0.0));
+           else
+             return integrate(double(0.0));
+         },
+         py::arg("integrands"), py::arg("mesh"), py::arg("VOL_or_BND")=VOL,
+         py::arg("order")=5, py::arg("definedon")=nullopt,
+         R"raw_string(
+Integrates many functions in one sweep over the mesh.
+
+Integrands with the same integration order and domain are evaluated
+together, such that geometry and common sub-expressions are shared,
+partial sums are kept per thread.
+
+Parameters
+----------
+
+integrands: list
+  CoefficientFunctions or integrals (cf*dx). Integrals use their own
+  domain and order, the other arguments apply to CoefficientFunctions.
+
+mesh: ngsolve.Mesh
+  The mesh to be integrated on.
+
+VOL_or_BND: ngsolve.VorB = VOL
+  Co-dimension for CoefficientFunctions.
+
+order: int = 5
+  Integration order for CoefficientFunctions.
+
+definedon: ngsolve.Region
+  Region for CoefficientFunctions, overwrites VOL_or_BND.
+
+Returns a list with one result per integrand.
+)raw_string");
+
   
   m.def("SymbolicLFI",
           [](spCF cf, VorB vb, bool element_boundary,
@@ -4487,6 +4750,34 @@ drawelems: BitArray
          { PatchwiseSolve(bf, lf, gf, glh); },
          py::arg("bf"), py::arg("lf"), py::arg("gf"));
 
+   py::class_<ExplicitDGOperator, shared_ptr<ExplicitDGOperator>, BaseMatrix>
+     (m, "ExplicitDGOperator", docu_string(R"raw_string(
+Matrix-free operator for explicit DG time-stepping. Applies M^{-1} A,
+where A is given by volume and skeleton integrals. Facet terms are
+evaluated face by face, the volume terms, facet contributions and the
+element-wise inverse mass matrix are fused in one element sweep.
+
+Parameters:
+
+space : ngsolve.FESpace
+  discontinuous (L2-type) space
+
+igls : ngsolve.SumOfIntegrals
+  volume terms (dx) and facet terms (dx(skeleton=True), ds(skeleton=True), dx(element_boundary=True))
+
+rho : ngsolve.CoefficientFunction
+  density for the mass matrix
+
+invmass : bool
+  apply the inverse mass matrix
+)raw_string"))
+     .def(py::init([] (shared_ptr<FESpace> fes, shared_ptr<SumOfIntegrals> igls,
+                       shared_ptr<CoefficientFunction> rho, bool invmass)
+                   {
+                     return make_shared<ExplicitDGOperator> (fes, igls, rho, invmass, global_heapsize);
+                   }), py::arg("space"), py::arg("igls"), py::arg("rho")=nullptr, py::arg("invmass")=true)
+     ;
+
    py::class_<InterpolateProxy, shared_ptr<InterpolateProxy>, ProxyFunction> (m, "InterpolateProxy");
    m.def("Interpolate", 
          [] (shared_ptr<CoefficientFunction> cf, shared_ptr<FESpace> fes, int bonus_intorder)
@@ -4589,9 +4880,45 @@ spacea/spaceb integrals.
 
 geom_free:
   If True, assembles a matrix-free operator.
+
+If spacea and spaceb live on different meshes, the MeshTransferOperator is returned.
+)raw_string")
+	 );
+
+   m.def("MeshTransferOperator", [&](shared_ptr<FESpace> spacea, shared_ptr<FESpace> spaceb,
+				     bool conservative, int bonus_intorder) -> shared_ptr<BaseMatrix>
+	 {
+	   py::gil_scoped_release release;
+	   return MeshTransferOperator(spacea, spaceb, glh, conservative, bonus_intorder);
+	 },
+	 py::arg("spacea"), py::arg("spaceb"),
+	 py::arg("conservative") = false,
+	 py::arg("bonus_intorder") = 0,
+     docu_string(R"raw_string(
+Transfer operator from a space on one mesh to a space on another, non-matching mesh.
+The integration points of the target mesh are located once in the source mesh, applying
+the operator is a sparse matrix-vector product. GridFunction.Set(gf, cache=True) uses a cached version of it.
+
+Parameters:
+
+spacea: ngsolve.comp.FESpace
+  the origin space
+
+spaceb: ngsolve.comp.FESpace
+  the goal space, on a different mesh
+
+conservative: bool
+  False -> element-wise L2 projection, averaged over elements (as Set)
+  True -> global L2 projection, mass inverse times mixed mass matrix
+
+bonus_intorder: int
+  Bonus integration order for the projection.
 )raw_string")
 	 );
 
+   m.def("InterpolationCacheSize", &InterpolationCacheSize,
+         "number of interpolation operators kept by GridFunction.Set(..., cache=True) for living spaces");
+
    m.def("MPI_Init", [&]()
 	 {
 	   const char * progname = "ngslib";
@@ -601,7 +601,10 @@ mesh (netgen.Mesh): a mesh generated from Netgen
               }
           },
          py::arg("pmltrafo"),py::arg("definedon"),
-         "Set PML transformation on domain"
+         "Set PML transformation on domain.\n"
+         "Elements with a PML transformation have complex mapped integration points,\n"
+         "they are integrated with scalar (non-SIMD) integration rules.\n"
+         "The PML coefficient functions (pml.PML_CF, Jac_CF, JacInv_CF, Det_CF) evaluate SIMD."
          )
     
     .def("UnSetPML", [](MeshAccess & ma, py::object definedon)
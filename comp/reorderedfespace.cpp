@@ -19,6 +19,10 @@ namespace ngcomp {
     integrator[VOL] = space->GetIntegrator(VOL);
     
     iscomplex = space->IsComplex();
+
+    ordering = flags.GetStringFlag ("ordering", "clusters");
+    if (ordering != "clusters" && ordering != "rcm" && ordering != "hilbert" && ordering != "morton")
+      throw Exception ("ReorderedFESpace: unknown ordering '" + ordering + "', use clusters, rcm, hilbert or morton");
     /*
       // not yet implemented ...
       if (space->LowOrderFESpacePtr() && false)
@@ -30,6 +34,235 @@ namespace ngcomp {
     */
     }
     
+  // dofs of the volume elements, regular dofs only
+  static Table<DofId> ElementDofs (const FESpace & space)
+  {
+    auto ma = space.GetMeshAccess();
+    TableCreator<DofId> creator(ma->GetNE(VOL));
+    for ( ; !creator.Done(); creator++)
+      ParallelForRange (ma->GetNE(VOL), [&] (IntRange r)
+        {
+          Array<DofId> dofs;
+          for (auto i : r)
+            {
+              space.GetDofNrs (ElementId(VOL, i), dofs);
+              for (auto d : dofs)
+                if (IsRegularDof(d))
+                  creator.Add (i, d);
+            }
+        });
+    return creator.MoveTable();
+  }
+
+  // numbers the dofs in the order the elements in elorder touch them first
+  static void FirstTouchOrder (FlatTable<DofId> el2dof, FlatArray<int> elorder,
+                               size_t ndof, Array<DofId> & order)
+  {
+    Array<bool> touched(ndof);
+    touched = false;
+    order.SetSize0();
+    for (auto el : elorder)
+      for (auto d : el2dof[el])
+        if (!touched[d])
+          {
+            touched[d] = true;
+            order.Append (d);
+          }
+    for (DofId d = 0; d < ndof; d++)
+      if (!touched[d])
+        order.Append (d);
+  }
+
+  // key of the integer coordinates x on the Hilbert or the Morton (z-order) curve
+  static uint64_t CurveKey (std::array<uint32_t,3> x, int dim, int bits, bool hilbert)
+  {
+    if (hilbert)
+      {
+        // axes to transposed Hilbert index, J. Skilling, AIP Conf. Proc. 707 (2004)
+        uint32_t m = 1u << (bits-1);
+        for (uint32_t q = m; q > 1; q >>= 1)
+          {
+            uint32_t p = q-1;
+            for (int i = 0; i < dim; i++)
+              if (x[i] & q)
+                x[0] ^= p;
+              else
+                {
+                  uint32_t t = (x[0] ^ x[i]) & p;
+                  x[0] ^= t;
+                  x[i] ^= t;
+                }
+          }
+        for (int i = 1; i < dim; i++)
+          x[i] ^= x[i-1];
+        uint32_t t = 0;
+        for (uint32_t q = m; q > 1; q >>= 1)
+          if (x[dim-1] & q)
+            t ^= q-1;
+        for (int i = 0; i < dim; i++)
+          x[i] ^= t;
+      }
+
+    uint64_t key = 0;
+    for (int b = bits-1; b >= 0; b--)
+      for (int i = 0; i < dim; i++)
+        key = (key << 1) | ((x[i] >> b) & 1);
+    return key;
+  }
+
+  static void SpaceFillingCurveOrder (const MeshAccess & ma, FlatTable<DofId> el2dof,
+                                      size_t ndof, bool hilbert, Array<DofId> & order)
+  {
+    static Timer t("ReorderedFESpace - space filling curve"); RegionTimer reg(t);
+    size_t ne = ma.GetNE(VOL);
+    int dim = ma.GetDimension();
+    int bits = min(32, 63/dim);
+
+    Array<Vec<3>> centers(ne);
+    ParallelFor (ne, [&] (size_t i)
+      {
+        Vec<3> c = 0.0;
+        auto verts = ma.GetElement(ElementId(VOL, i)).Vertices();
+        for (auto v : verts)
+          c += ma.GetPoint<3> (v);
+        centers[i] = (1.0/verts.Size()) * c;
+      });
+
+    Vec<3> pmin = 1e99, pmax = -1e99;
+    for (auto & c : centers)
+      for (int j = 0; j < 3; j++)
+        {
+          pmin(j) = min2(pmin(j), c(j));
+          pmax(j) = max2(pmax(j), c(j));
+        }
+    double h = 0;
+    for (int j = 0; j < dim; j++)
+      h = max2(h, pmax(j)-pmin(j));
+    double scale = (h > 0) ? (double((uint64_t(1) << bits) - 1) / h) : 0;
+
+    Array<uint64_t> keys(ne);
+    ParallelFor (ne, [&] (size_t i)
+      {
+        std::array<uint32_t,3> x = { 0, 0, 0 };
+        for (int j = 0; j < dim; j++)
+          x[j] = uint32_t(scale * (centers[i](j)-pmin(j)));
+        keys[i] = CurveKey (x, dim, bits, hilbert);
+      });
+
+    Array<int> elorder(ne);
+    for (size_t i = 0; i < ne; i++)
+      elorder[i] = i;
+    if (ne > 10000)
+      SampleSortI (keys, elorder);
+    else
+      QuickSortI (keys, elorder);
+
+    FirstTouchOrder (el2dof, elorder, ndof, order);
+  }
+
+  /*
+    Breadth-first search from start over the dofs connected by elements,
+    neighbours in order of increasing degree. Visited dofs get mark = stamp and
+    are appended to order. Returns the number of levels and the first entry of the last level.
+   */
+  static tuple<size_t,size_t> LevelBFS (FlatTable<DofId> el2dof, FlatTable<int> dof2el,
+                                        FlatArray<int> degree, DofId start,
+                                        FlatArray<int> mark, int stamp, Array<DofId> & order)
+  {
+    size_t level_begin = order.Size();
+    order.Append (start);
+    mark[start] = stamp;
+    size_t level_end = order.Size(), last_level = level_begin, nlevels = 0;
+    Array<DofId> nbs;
+    while (level_begin < level_end)
+      {
+        nlevels++;
+        last_level = level_begin;
+        for (size_t k = level_begin; k < level_end; k++)
+          {
+            nbs.SetSize0();
+            for (auto el : dof2el[order[k]])
+              for (auto d : el2dof[el])
+                if (mark[d] != stamp)
+                  {
+                    mark[d] = stamp;
+                    nbs.Append (d);
+                  }
+            QuickSort (nbs, [&] (DofId a, DofId b) { return degree[a] < degree[b]; });
+            for (auto d : nbs)
+              order.Append (d);
+          }
+        level_begin = level_end;
+        level_end = order.Size();
+      }
+    return { nlevels, last_level };
+  }
+
+  static void ReverseCuthillMcKeeOrder (FlatTable<DofId> el2dof, size_t ndof, Array<DofId> & order)
+  {
+    static Timer t("ReorderedFESpace - RCM"); RegionTimer reg(t);
+    size_t ne = el2dof.Size();
+
+    TableCreator<int> creator(ndof);
+    for ( ; !creator.Done(); creator++)
+      ParallelFor (ne, [&] (size_t el)
+        {
+          for (auto d : el2dof[el])
+            creator.Add (d, el);
+        });
+    Table<int> dof2el = creator.MoveTable();
+
+    Array<int> degree(ndof);
+    ParallelFor (ndof, [&] (size_t d)
+      {
+        QuickSort (dof2el[d]);
+        int deg = 0;
+        for (auto el : dof2el[d])
+          deg += el2dof[el].Size();
+        degree[d] = deg;
+      });
+
+    Array<DofId> seeds(ndof);
+    for (size_t d = 0; d < ndof; d++)
+      seeds[d] = d;
+    QuickSortI (degree, seeds);
+
+    Array<int> mark(ndof);
+    mark = 0;
+    Array<bool> numbered(ndof);
+    numbered = false;
+    Array<DofId> trial;
+    int stamp = 0;
+    order.SetSize0();
+    for (auto seed : seeds)
+      {
+        if (numbered[seed]) continue;
+
+        // a few sweeps towards a pseudo-peripheral start of the component
+        DofId start = seed;
+        size_t nlevels = 0;
+        for (int sweep = 0; sweep < 3; sweep++)
+          {
+            trial.SetSize0();
+            auto [nlev, last] = LevelBFS (el2dof, dof2el, degree, start, mark, ++stamp, trial);
+            if (nlev <= nlevels) break;
+            nlevels = nlev;
+            for (size_t k = last; k < trial.Size(); k++)
+              if (k == last || degree[trial[k]] < degree[start])
+                start = trial[k];
+          }
+
+        size_t first = order.Size();
+        LevelBFS (el2dof, dof2el, degree, start, mark, ++stamp, order);
+        for (size_t k = first; k < order.Size(); k++)
+          numbered[order[k]] = true;
+      }
+
+    for (size_t i = 0; i < ndof/2; i++)
+      swap (order[i], order[ndof-1-i]);
+  }
+
+  
   void ReorderedFESpace :: Update()
   {      
     space->Update();
@@ -37,27 +270,70 @@ namespace ngcomp {
 
     SetNDof(space->GetNDof());
     size_t ndof = space->GetNDof();
+
+    if (ordering == "clusters")
+      {
+        ClusterOrder();
+      }
+    else
+      {
+        Table<DofId> el2dof = ElementDofs (*space);
+        Array<DofId> order;
+        if (ordering == "rcm")
+          ReverseCuthillMcKeeOrder (el2dof, ndof, order);
+        else
+          SpaceFillingCurveOrder (*ma, el2dof, ndof, ordering == "hilbert", order);
+
+        dofmap.SetSize(ndof);
+        ParallelFor (ndof, [&] (size_t i) { dofmap[order[i]] = i; });
+
+        // clusters of 20 consecutive elements, ordered by their first dof
+        size_t ne = el2dof.Size();
+        Array<DofId> firstdof(ne);
+        Array<int> elorder(ne);
+        ParallelFor (ne, [&] (size_t el)
+          {
+            DofId first = ndof;
+            for (auto d : el2dof[el])
+              first = min2(first, dofmap[d]);
+            firstdof[el] = first;
+            elorder[el] = el;
+          });
+        QuickSortI (firstdof, elorder);
+
+        int step = 20;
+        Array<int> dofgroup(ndof);
+        dofgroup = -1;
+        for (size_t k = 0; k < ne; k++)
+          for (auto d : el2dof[elorder[k]])
+            if (dofgroup[d] == -1)
+              dofgroup[d] = k / step;
+        int ngroups = (ne+step-1) / step;
+        for (auto & g : dofgroup)
+          if (g == -1) g = ngroups;
+        ngroups++;
+
+        TableCreator<int> creator(ngroups);
+        for ( ; !creator.Done(); creator++)
+          for (DofId d = 0; d < ndof; d++)
+            creator.Add (dofgroup[d], dofmap[d]);
+        clusters = make_shared<Table<int>> (creator.MoveTable());
+      }
+
+    ctofdof.SetSize(ndof);
+    for (auto i : Range(ndof))
+      ctofdof[dofmap[i]] = space->GetDofCouplingType(i);
+  }
+
+  void ReorderedFESpace :: ClusterOrder()
+  {
+    size_t ndof = space->GetNDof();
     Array<DofId> dofs;
-    /*
-    dofmap.SetSize(ndof);
-    dofmap = UNUSED_DOF;
-    size_t cnt = 0;
-    for (auto nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
-      for (auto nr : Range(ma->GetNNodes(nt)))
-        {
-          space->GetDofNrs (NodeId(nt, nr), dofs);
-          for (auto d : dofs)
-            dofmap[d] = cnt++;
-        }
-    */
 
     Array<int> dofgroup(ndof);
     Array<int> elgroup(ma->GetNE());
     dofgroup = -1;
     elgroup = -1;
-    // int ngroups = 100;
-    // int step = ma->GetNE() / ngroups;
-    // if (step == 0) step = 1;
     int step = 20;
     // select seed elements
     int ngroups = 0;
@@ -69,28 +345,33 @@ namespace ngcomp {
           dofgroup[d] = ngroups;
       }
 
-    bool done = false;
-    while (!done)
+    // grow the groups over neighbouring elements
+    bool changed = true;
+    while (changed)
       {
-        cout << "another loop" << endl;
-        done = true;
+        changed = false;
         for (int elnr = 0; elnr < ma->GetNE(); elnr++)
           {
             if (elgroup[elnr] != -1) continue;
             space->GetDofNrs(ElementId(elnr), dofs);
             int groupnr = -1;
             for (auto d : dofs)
-              if (dofgroup[d] != -1)
+              if (IsRegularDof(d) && dofgroup[d] != -1)
                 groupnr = dofgroup[d];
             if (groupnr != -1)
               {
                 elgroup[elnr] = groupnr;
                 for (auto d : dofs)
-                  dofgroup[d] = groupnr;
+                  if (IsRegularDof(d))
+                    dofgroup[d] = groupnr;
+                changed = true;
               }
-            done = false;
           }
       }
+    // dofs of disconnected parts and not in elements
+    for (auto & g : dofgroup)
+      if (g == -1) g = ngroups;
+    ngroups++;
 
     dofmap.SetSize(ndof);
     size_t cnt = 0;
@@ -99,10 +380,6 @@ namespace ngcomp {
         if (dofgroup[d] == i)
           dofmap[d] = cnt++;
 
-    ctofdof.SetSize(ndof);
-    for (auto i : Range(ndof))
-      ctofdof[dofmap[i]] = space->GetDofCouplingType(i);
-
     {
       // build cluster table
       Array<int> cnt(ngroups);
@@ -18,6 +18,11 @@ namespace ngcomp
     Array<DofId> dofmap;
     shared_ptr<FESpace> space;
     shared_ptr<Table<DofId>> clusters;
+    /// "clusters", "rcm" (reverse Cuthill-McKee), "hilbert" or "morton"
+    string ordering;
+
+    /// grows clusters from every 20th element, dofs are numbered cluster by cluster
+    void ClusterOrder();
     
   public:
     ReorderedFESpace (shared_ptr<FESpace> space, const Flags & flags);
@@ -0,0 +1,595 @@
+#include <saamg.hpp>
+
+#include <comp.hpp>
+using namespace ngcomp;
+
+
+namespace ngcomp
+{
+
+  // scalar matrix of a block matrix, row N*i+k is row k of block row i.
+  // Only needed during the setup of the finest level.
+  template <int N>
+  static shared_ptr<SparseMatrix<double>> ExpandBlockMatrix (const SparseMatrix<Mat<N,N,double>> & bmat)
+  {
+    static Timer t("SAAMG - expand block matrix"); RegionTimer reg(t);
+
+    size_t h = bmat.Height();
+    Array<int> elsperrow(N*h);
+    for (size_t i = 0; i < h; i++)
+      for (int k = 0; k < N; k++)
+        elsperrow[N*i+k] = N*bmat.GetRowIndices(i).Size();
+
+    auto smat = make_shared<SparseMatrix<double>> (elsperrow, N*bmat.Width());
+    ParallelFor (h, [&] (size_t i)
+                 {
+                   auto bcols = bmat.GetRowIndices(i);
+                   auto bvals = bmat.GetRowValues(i);
+                   for (int k = 0; k < N; k++)
+                     {
+                       auto cols = smat->GetRowIndices(N*i+k);
+                       auto vals = smat->GetRowValues(N*i+k);
+                       for (size_t j = 0; j < bcols.Size(); j++)
+                         for (int l = 0; l < N; l++)
+                           {
+                             cols[N*j+l] = N*bcols[j]+l;
+                             vals[N*j+l] = bvals[j](k,l);
+                           }
+                     }
+                 });
+    return smat;
+  }
+
+
+  // largest eigenvalue of D^{-1} A on the free dofs, by power iteration
+  static double EstimateLambdaMax (const SparseMatrix<double> & mat, FlatArray<double> dinv,
+                                   const BitArray & freedofs, int steps = 10)
+  {
+    auto x = mat.CreateColVector();
+    auto y = mat.CreateColVector();
+    auto fx = x.FVDouble();
+    auto fy = y.FVDouble();
+
+    for (size_t i = 0; i < fx.Size(); i++)
+      fx(i) = freedofs.Test(i) ? 1.0 + 0.5 * sin(double(i)) : 0.0;
+    fx /= L2Norm(fx);
+
+    double lam = 1;
+    for (int it = 0; it < steps; it++)
+      {
+        mat.Mult (x, y);
+        for (size_t i = 0; i < fy.Size(); i++)
+          fy(i) = freedofs.Test(i) ? dinv[i] * fy(i) : 0.0;
+        lam = L2Norm(fy);
+        if (lam == 0) return 1;
+        fx = 1.0/lam * fy;
+      }
+    return lam;
+  }
+
+
+  SAAMG_Matrix :: SAAMG_Matrix (shared_ptr<SparseMatrix<double>> amat,
+                                shared_ptr<BitArray> freedofs,
+                                int abs,
+                                FlatMatrix<double> nullspace,
+                                const SAAMG_Parameters & param,
+                                int alevel,
+                                shared_ptr<BaseSparseMatrix> ablockmat)
+    : bs(abs), level(alevel), mat(amat), blockmat(ablockmat), smoothing_steps(param.smoothing_steps)
+  {
+    static Timer t("SAAMG"); RegionTimer reg(t);
+    static Timer tagg("SAAMG - aggregation");
+    static Timer tprol("SAAMG - prolongation");
+    static Timer tgalerkin("SAAMG - Galerkin product");
+
+    size = mat->Height();
+    size_t nnodes = size / bs;
+    size_t k = nullspace.Width();
+
+    if (nnodes * bs != size)
+      throw Exception ("SAAMG: matrix size is not a multiple of the block size");
+    if (nullspace.Height() != size)
+      throw Exception ("SAAMG: near-nullspace does not fit the matrix size");
+
+    cout << IM(3) << "SAAMG: level = " << level << ", ndof = " << size << ", nodes = " << nnodes
+         << ", nullspace dim = " << k << endl;
+
+
+    // node-wise strength of coupling
+    tagg.Start();
+    Array<bool> nodefree(nnodes);
+    Array<double> nodediag(nnodes);
+    ParallelFor (nnodes, [&] (size_t i)
+                 {
+                   bool free = false;
+                   double sum = 0;
+                   for (int l = 0; l < bs; l++)
+                     {
+                       size_t row = i*bs+l;
+                       if (freedofs->Test(row)) free = true;
+                       auto cols = mat->GetRowIndices(row);
+                       auto vals = mat->GetRowValues(row);
+                       for (size_t j = 0; j < cols.Size(); j++)
+                         if (cols[j]/bs == i)
+                           sum += sqr(vals[j]);
+                     }
+                   nodefree[i] = free;
+                   nodediag[i] = sqrt(sum);
+                 });
+
+    double theta2 = sqr(param.strength_threshold);
+    TableCreator<int> strong_creator(nnodes);
+    for ( ; !strong_creator.Done(); strong_creator++)
+      ParallelFor (nnodes, [&] (size_t i)
+                   {
+                     if (!nodefree[i]) return;
+                     ArrayMem<int,300> nbs;
+                     ArrayMem<double,300> weights;
+                     ArrayMem<int,300> index;
+                     for (int l = 0; l < bs; l++)
+                       {
+                         auto cols = mat->GetRowIndices(i*bs+l);
+                         auto vals = mat->GetRowValues(i*bs+l);
+                         for (size_t j = 0; j < cols.Size(); j++)
+                           if (size_t(cols[j]/bs) != i)
+                             {
+                               nbs.Append (cols[j]/bs);
+                               weights.Append (sqr(vals[j]));
+                             }
+                       }
+                     index.SetSize(nbs.Size());
+                     for (size_t j = 0; j < index.Size(); j++)
+                       index[j] = j;
+                     QuickSortI (nbs, index);
+
+                     for (size_t j = 0; j < index.Size(); )
+                       {
+                         int nb = nbs[index[j]];
+                         double sum = 0;
+                         for ( ; j < index.Size() && nbs[index[j]] == nb; j++)
+                           sum += weights[index[j]];
+                         if (nodefree[nb] && sum > theta2 * nodediag[i] * nodediag[nb])
+                           strong_creator.Add (i, nb);
+                       }
+                   });
+    Table<int> strong = strong_creator.MoveTable();
+
+
+    // aggregation
+    Array<int> agg(nnodes);
+    agg = -1;
+    int nagg = 0;
+
+    // phase 1: roots with all strong neighbours unaggregated
+    for (size_t i = 0; i < nnodes; i++)
+      {
+        if (!nodefree[i] || agg[i] != -1 || strong[i].Size() == 0) continue;
+        bool ok = true;
+        for (int j : strong[i])
+          if (agg[j] != -1) ok = false;
+        if (!ok) continue;
+        agg[i] = nagg;
+        for (int j : strong[i])
+          agg[j] = nagg;
+        nagg++;
+      }
+
+    // phase 2: join an aggregate of a strong neighbour
+    Array<int> agg1(agg);
+    for (size_t i = 0; i < nnodes; i++)
+      if (nodefree[i] && agg[i] == -1)
+        for (int j : strong[i])
+          if (agg1[j] != -1)
+            {
+              agg[i] = agg1[j];
+              break;
+            }
+
+    // phase 3: new aggregates from the remaining nodes
+    for (size_t i = 0; i < nnodes; i++)
+      {
+        if (!nodefree[i] || agg[i] != -1) continue;
+        agg[i] = nagg;
+        for (int j : strong[i])
+          if (agg[j] == -1)
+            agg[j] = nagg;
+        nagg++;
+      }
+    strong = Table<int>();
+    tagg.Stop();
+
+    cout << IM(3) << "SAAMG: level = " << level << ", aggregates = " << nagg << endl;
+
+
+    // smoother: block Gauss-Seidel on the free dofs of nodes,
+    // the block matrix has whole nodes free or fixed
+    TableCreator<int> smoothing_blocks_creator(nnodes);
+    for ( ; !smoothing_blocks_creator.Done(); smoothing_blocks_creator++)
+      for (size_t i = 0; i < nnodes; i++)
+        if (blockmat)
+          {
+            if (nodefree[i])
+              smoothing_blocks_creator.Add (i, i);
+          }
+        else
+          for (int l = 0; l < bs; l++)
+            if (freedofs->Test(i*bs+l))
+              smoothing_blocks_creator.Add (i, i*bs+l);
+    auto blocks = make_shared<Table<int>> (smoothing_blocks_creator.MoveTable());
+    smoother = blockmat ? blockmat->CreateBlockJacobiPrecond(blocks) : mat->CreateBlockJacobiPrecond(blocks);
+
+    if (nagg == 0)
+      {
+        if (blockmat) mat = nullptr;
+        return;
+      }
+
+    size_t ncoarse = nagg * k;
+    if (ncoarse >= size)
+      {
+        // aggregation does not reduce the problem, this is the coarsest level
+        cout << IM(3) << "SAAMG: level = " << level << ", " << ncoarse << " coarse dofs, solve directly" << endl;
+        mat->SetInverseType(SPARSECHOLESKY);
+        coarse_precond = mat->InverseMatrix(freedofs);
+        return;
+      }
+
+
+    // tentative prolongation from the QR of the near-nullspace on aggregates
+    tprol.Start();
+    TableCreator<int> agg2node_creator(nagg);
+    for ( ; !agg2node_creator.Done(); agg2node_creator++)
+      for (size_t i = 0; i < nnodes; i++)
+        if (agg[i] != -1)
+          agg2node_creator.Add (agg[i], i);
+    Table<int> agg2node = agg2node_creator.MoveTable();
+
+    Array<int> nne(size);
+    for (size_t i = 0; i < size; i++)
+      nne[i] = (agg[i/bs] != -1 && freedofs->Test(i)) ? k : 0;
+    auto tentprol = make_shared<SparseMatrix<double>> (nne, ncoarse);
+
+    Matrix<double> coarse_nullspace(ncoarse, k);
+    auto coarse_freedofs = make_shared<BitArray> (ncoarse);
+    coarse_freedofs->Clear();
+
+    ParallelFor (nagg, [&] (size_t a)
+                 {
+                   ArrayMem<int,300> rows;
+                   for (int node : agg2node[a])
+                     for (int l = 0; l < bs; l++)
+                       if (freedofs->Test(node*bs+l))
+                         rows.Append (node*bs+l);
+
+                   Matrix<double> q(rows.Size(), k);
+                   for (size_t i = 0; i < rows.Size(); i++)
+                     q.Row(i) = nullspace.Row(rows[i]);
+
+                   // modified Gram-Schmidt, linearly dependent modes are dropped
+                   Matrix<double> r(k, k);
+                   r = 0.0;
+                   for (size_t j = 0; j < k; j++)
+                     {
+                       double norm0 = L2Norm(q.Col(j));
+                       for (size_t l = 0; l < j; l++)
+                         {
+                           double ip = InnerProduct (q.Col(l), q.Col(j));
+                           r(l,j) = ip;
+                           q.Col(j) -= ip * q.Col(l);
+                         }
+                       double norm = L2Norm(q.Col(j));
+                       if (norm0 > 0 && norm > 1e-10 * norm0)
+                         {
+                           r(j,j) = norm;
+                           q.Col(j) *= 1.0/norm;
+                           coarse_freedofs->SetBitAtomic(a*k+j);
+                         }
+                       else
+                         q.Col(j) = 0.0;
+                     }
+
+                   for (size_t i = 0; i < rows.Size(); i++)
+                     {
+                       auto cols = tentprol->GetRowIndices(rows[i]);
+                       auto vals = tentprol->GetRowValues(rows[i]);
+                       for (size_t j = 0; j < k; j++)
+                         {
+                           cols[j] = a*k+j;
+                           vals[j] = q(i,j);
+                         }
+                     }
+                   coarse_nullspace.Rows(a*k, (a+1)*k) = r;
+                 });
+
+    if (param.smooth_prolongation)
+      {
+        // P = (I - omega D^{-1} A) P_tent
+        Array<double> dinv(size);
+        ParallelFor (size, [&] (size_t i)
+                     {
+                       size_t pos = mat->GetPositionTest(i,i);
+                       double d = (pos != numeric_limits<size_t>::max()) ? (*mat)[pos] : 0.0;
+                       dinv[i] = (freedofs->Test(i) && d != 0) ? 1.0/d : 0.0;
+                     });
+
+        double omega = 4.0/3.0 / EstimateLambdaMax (*mat, dinv, *freedofs);
+
+        auto smoothmat = make_shared<SparseMatrix<double>> (*mat);
+        ParallelFor (size, [&] (size_t i)
+                     {
+                       auto cols = smoothmat->GetRowIndices(i);
+                       auto vals = smoothmat->GetRowValues(i);
+                       for (size_t j = 0; j < cols.Size(); j++)
+                         vals[j] = (cols[j] == int(i) && dinv[i] != 0 ? 1.0 : 0.0) - omega * dinv[i] * vals[j];
+                     });
+        prolongation = MatMult (*smoothmat, *tentprol);
+      }
+    else
+      prolongation = tentprol;
+    tprol.Stop();
+
+    tgalerkin.Start();
+    auto coarsemat = dynamic_pointer_cast<SparseMatrix<double>> (mat->Restrict (*prolongation));
+    restriction = dynamic_pointer_cast<SparseMatrixTM<double>>(prolongation->CreateTranspose());
+    tgalerkin.Stop();
+
+    // stop if the coarse level is too small or not much smaller than this one
+    if (ncoarse <= param.max_coarse || level+1 >= param.max_levels || 4*ncoarse > 3*size)
+      {
+        coarsemat->SetInverseType(SPARSECHOLESKY);
+        coarse_precond = coarsemat->InverseMatrix(coarse_freedofs);
+      }
+    else
+      coarse_precond = make_shared<SAAMG_Matrix> (coarsemat, coarse_freedofs, k,
+                                                  coarse_nullspace, param, level+1);
+
+    // residuals and smoothing use the block matrix, the scalar copy is released
+    if (blockmat)
+      mat = nullptr;
+  }
+
+
+  void SAAMG_Matrix :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    static Timer t("SAAMG::Mult"); RegionTimer reg(t);
+    x = 0;
+    smoother->GSSmooth(x, b, smoothing_steps);
+
+    if (coarse_precond)
+      {
+        auto residuum = b.CreateVector();
+        if (blockmat)
+          residuum = b - (*blockmat) * x;
+        else
+          residuum = b - (*mat) * x;
+
+        // transfer operators and the direct solver act on the scalar dofs of block vectors
+        VFlatVector<double> sres(residuum.FVDouble()), sx(x.FVDouble());
+        if (prolongation)
+          {
+            auto coarse_residuum = coarse_precond->CreateColVector();
+            coarse_residuum = *restriction * sres;
+
+            auto coarse_x = coarse_precond->CreateColVector();
+            coarse_precond->Mult(coarse_residuum, coarse_x);
+
+            sx += *prolongation * coarse_x;
+          }
+        else
+          {
+            auto w = coarse_precond->CreateColVector();
+            coarse_precond->Mult(sres, w);
+            sx += w;
+          }
+      }
+    smoother->GSSmoothBack (x, b, smoothing_steps);
+  }
+
+  int SAAMG_Matrix :: GetNLevels () const
+  {
+    if (auto coarse_amg = dynamic_pointer_cast<SAAMG_Matrix> (coarse_precond))
+      return 1 + coarse_amg->GetNLevels();
+    return coarse_precond ? 2 : 1;
+  }
+
+
+
+  /*
+    Near-nullspace of an H1-space with dim = N at the scalar dofs, or of
+    a VectorH1-space (N = 1, one scalar space per component):
+    rigid body modes if the number of components equals the mesh
+    dimension, otherwise the constant modes. The modes are linear, so
+    they live on the vertex dofs of the hierarchical basis.
+  */
+  static Matrix<double> RigidBodyModes (const FESpace & fes, int N)
+  {
+    auto ma = fes.GetMeshAccess();
+    int D = ma->GetDimension();
+    size_t ndof = fes.GetNDof();
+
+    // components with their own dofs, rows of the expanded block matrix otherwise
+    int ncomp = N;
+    bool vectorh1 = dynamic_cast<const VectorH1FESpace*> (&fes) != nullptr;
+    if (vectorh1)
+      ncomp = dynamic_cast<const CompoundFESpace&> (fes).GetNSpaces();
+    else if (dynamic_cast<const CompoundFESpace*> (&fes))
+      throw Exception ("SAAMG: cannot build rigid body modes for the compound space "
+                       + fes.GetClassName() + ", provide them with the nullspace flag");
+
+    int nrot = 0;
+    if (ncomp == D) nrot = (D == 2) ? 1 : 3;
+    int k = ncomp + nrot;
+
+    Vec<3> center = 0.0;
+    for (size_t v = 0; v < ma->GetNV(); v++)
+      {
+        auto p = ma->GetPoint<3>(v);
+        center += p;
+      }
+    if (ma->GetNV())
+      center /= ma->GetNV();
+
+    Matrix<double> modes(N*ndof, k);
+    modes = 0.0;
+
+    Array<DofId> dnums;
+    Array<size_t> rownr;
+    for (size_t v = 0; v < ma->GetNV(); v++)
+      {
+        fes.GetDofNrs (NodeId(NT_VERTEX, v), dnums);
+        Vec<3> p = ma->GetPoint<3>(v) - center;
+
+        // rows of the components, a VectorH1 vertex has one dof per component in both dof layouts
+        rownr.SetSize0();
+        for (auto d : dnums)
+          if (IsRegularDof(d))
+            {
+              if (vectorh1)
+                rownr.Append (d);
+              else
+                for (int l = 0; l < N; l++)
+                  rownr.Append (N*d+l);
+            }
+        if (rownr.Size() % ncomp != 0)
+          throw Exception ("SAAMG: expected one vertex dof per component");
+
+        for (size_t first = 0; first < rownr.Size(); first += ncomp)
+          {
+            auto row = [&] (int l) { return modes.Row(rownr[first+l]); };
+            for (int l = 0; l < ncomp; l++)
+              row(l)(l) = 1;
+            if (nrot == 1)
+              {
+                row(0)(2) = -p(1);
+                row(1)(2) = p(0);
+              }
+            if (nrot == 3)
+              {
+                row(0)(3) = -p(1); row(1)(3) = p(0);
+                row(1)(4) = -p(2); row(2)(4) = p(1);
+                row(0)(5) = p(2);  row(2)(5) = -p(0);
+              }
+          }
+      }
+    return modes;
+  }
+
+
+
+  class SAAMG_Preconditioner : public Preconditioner
+  {
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BitArray> freedofs;
+    shared_ptr<BaseMatrix> mat;
+    shared_ptr<SAAMG_Matrix> amg;
+    SAAMG_Parameters param;
+    Array<shared_ptr<BaseVector>> nullspace;
+
+  public:
+    SAAMG_Preconditioner (shared_ptr<BilinearForm> abfa, const Flags & aflags,
+                          const string aname = "saamg")
+      : Preconditioner (abfa, aflags, aname), bfa(abfa)
+    {
+      param.strength_threshold = flags.GetNumFlag ("theta", param.strength_threshold);
+      param.smoothing_steps = int(flags.GetNumFlag ("smoothingsteps", param.smoothing_steps));
+      param.max_coarse = size_t(flags.GetNumFlag ("maxcoarse", param.max_coarse));
+      param.max_levels = int(flags.GetNumFlag ("maxlevels", param.max_levels));
+      param.smooth_prolongation = !flags.GetDefineFlagX ("smoothprol").IsFalse();
+
+      if (flags.AnyFlagDefined("nullspace"))
+        nullspace = std::any_cast<Array<shared_ptr<BaseVector>>> (flags.GetAnyFlag("nullspace"));
+
+      cout << IM(3) << "Create SAAMG" << endl;
+    }
+
+    SAAMG_Preconditioner (const PDE & pde, const Flags & aflags, const string & aname)
+      : SAAMG_Preconditioner (pde.GetBilinearForm (aflags.GetStringFlag ("bilinearform")),
+                              aflags, aname)
+    { ; }
+
+    virtual void InitLevel (shared_ptr<BitArray> _freedofs) override
+    {
+      freedofs = _freedofs;
+    }
+
+    virtual void FinalizeLevel (const BaseMatrix * matrix) override
+    {
+      static Timer t("SAAMG setup"); RegionTimer reg(t);
+
+      auto bmat = const_cast<BaseMatrix*>(matrix)->shared_from_this();
+      if (dynamic_pointer_cast<SparseMatrixSymmetric<double>> (bmat) ||
+          dynamic_pointer_cast<SparseMatrixSymmetric<Mat<2,2,double>>> (bmat) ||
+          dynamic_pointer_cast<SparseMatrixSymmetric<Mat<3,3,double>>> (bmat))
+        throw Exception ("SAAMG: needs a matrix with non-symmetric storage");
+
+      shared_ptr<SparseMatrix<double>> smat;
+      int N = 1;
+      if (auto m1 = dynamic_pointer_cast<SparseMatrix<double>> (bmat))
+        smat = m1;
+      else if (auto m2 = dynamic_pointer_cast<SparseMatrix<Mat<2,2,double>>> (bmat))
+        {
+          smat = ExpandBlockMatrix (*m2);
+          N = 2;
+        }
+      else if (auto m3 = dynamic_pointer_cast<SparseMatrix<Mat<3,3,double>>> (bmat))
+        {
+          smat = ExpandBlockMatrix (*m3);
+          N = 3;
+        }
+      else
+        throw Exception(string("SAAMG: expected a real SparseMatrix with entries double, Mat<2,2> or Mat<3,3>, but got a matrix of type ")
+                        + typeid(*matrix).name());
+
+      size_t ndof = smat->Height();
+      auto sfreedofs = make_shared<BitArray> (ndof);
+      sfreedofs->Set();
+      if (freedofs)
+        for (size_t i = 0; i < ndof; i++)
+          if (!freedofs->Test(i/N))
+            sfreedofs->Clear(i);
+
+      Matrix<double> modes;
+      if (nullspace.Size())
+        {
+          modes.SetSize (ndof, nullspace.Size());
+          for (size_t j = 0; j < nullspace.Size(); j++)
+            {
+              auto fv = nullspace[j]->FVDouble();
+              if (fv.Size() != ndof)
+                throw Exception ("SAAMG: near-nullspace vector has wrong size");
+              modes.Col(j) = fv;
+            }
+        }
+      else
+        modes = RigidBodyModes (*bfa->GetFESpace(), N);
+
+      // the finest level of a block matrix smoothes with it, the expanded copy is only used for the setup
+      amg = make_shared<SAAMG_Matrix> (smat, sfreedofs, N, modes, param, 0,
+                                       N > 1 ? dynamic_pointer_cast<BaseSparseMatrix> (bmat) : nullptr);
+      smat = nullptr;
+      mat = amg;
+
+      cout << IM(3) << "SAAMG: levels = " << amg->GetNLevels() << endl;
+    }
+
+    virtual void Update () override { ; }
+
+    virtual const BaseMatrix & GetMatrix() const override
+    {
+      if (!mat)
+        ThrowPreconditionerNotReady();
+      return *mat;
+    }
+
+    virtual const BaseMatrix & GetAMatrix() const override
+    {
+      return bfa->GetMatrix();
+    }
+
+    virtual const char * ClassName() const override
+    { return "SAAMG Preconditioner"; }
+  };
+
+
+  static RegisterPreconditioner<SAAMG_Preconditioner> init_saamg ("saamg");
+}
@@ -0,0 +1,69 @@
+#ifndef SAAMG_HPP_
+#define SAAMG_HPP_
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+  struct SAAMG_Parameters
+  {
+    /// nodes i,j are strongly coupled if |A_ij| > theta sqrt(|A_ii| |A_jj|)  (Frobenius norms of blocks)
+    double strength_threshold = 0.08;
+    /// Jacobi-smoothing of the tentative prolongation
+    bool smooth_prolongation = true;
+    int smoothing_steps = 1;
+    /// coarse levels with at most max_coarse dofs are solved directly
+    size_t max_coarse = 500;
+    int max_levels = 20;
+  };
+
+
+  /*
+    Smoothed aggregation AMG for systems, e.g. elasticity.
+
+    Works on the scalar matrix, a node (block row) consists of bs
+    consecutive dofs. If the block matrix is given, the finest level
+    smoothes and computes residuals with it on block vectors, the
+    scalar matrix is only used during the setup. The near-nullspace is given by its values at the
+    scalar dofs (size x k). Aggregates of strongly coupled nodes get k
+    coarse dofs from the aggregate-wise QR of the near-nullspace, the
+    R-factors are the near-nullspace of the coarse level.
+  */
+  class NGS_DLL_HEADER SAAMG_Matrix : public ngla::BaseMatrix
+  {
+    size_t size;
+    int bs;
+    int level;
+    std::shared_ptr<ngla::SparseMatrix<double>> mat;
+    std::shared_ptr<ngla::BaseSparseMatrix> blockmat;
+    std::shared_ptr<ngla::BaseBlockJacobiPrecond> smoother;
+    std::shared_ptr<ngla::SparseMatrixTM<double>> prolongation, restriction;
+    std::shared_ptr<ngla::BaseMatrix> coarse_precond;
+    int smoothing_steps = 1;
+
+  public:
+    SAAMG_Matrix (std::shared_ptr<ngla::SparseMatrix<double>> amat,
+                  std::shared_ptr<ngcore::BitArray> freedofs,
+                  int abs,
+                  ngbla::FlatMatrix<double> nullspace,
+                  const SAAMG_Parameters & param,
+                  int alevel = 0,
+                  std::shared_ptr<ngla::BaseSparseMatrix> ablockmat = nullptr);
+
+    virtual int VHeight() const override { return blockmat ? blockmat->VHeight() : size; }
+    virtual int VWidth() const override { return blockmat ? blockmat->VWidth() : size; }
+    virtual bool IsComplex() const override { return false; }
+
+    virtual AutoVector CreateRowVector () const override
+    { return blockmat ? blockmat->CreateColVector() : mat->CreateColVector(); }
+    virtual AutoVector CreateColVector () const override
+    { return blockmat ? blockmat->CreateRowVector() : mat->CreateRowVector(); }
+
+    virtual void Mult (const ngla::BaseVector & b, ngla::BaseVector & x) const override;
+
+    /// number of levels including the coarse direct solver
+    int GetNLevels () const;
+  };
+}
+
+#endif // SAAMG_HPP_
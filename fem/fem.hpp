@@ -46,6 +46,7 @@ namespace ngfem
 #include "fe_interfaces.hpp"
 #include "finiteelement.hpp"
 #include "scalarfe.hpp"
+#include "shapecache.hpp"
 #include "tscalarfe.hpp"
 
 #include "elementtransformation.hpp"
@@ -144,6 +144,20 @@ namespace ngfem
       return (ET == ET_SEGM) || (ET == ET_TRIG) || (ET == ET_QUAD)
         || (ET == ET_HEX) || (ET == ET_TET); 
     }
+
+    /// shape functions depend on vertex ordering and orders, cache only uniform order
+    size_t ShapeClassKey () const
+    {
+      for (int i = 0; i < N_EDGE; i++)
+        if (order_edge[i] != order) return size_t(-1);
+      for (int i = 0; i < N_FACE; i++)
+        if (order_face[i][0] != order || order_face[i][1] != order) return size_t(-1);
+      if constexpr (DIM == 3)
+        if (order_cell[0][0] != order || order_cell[0][1] != order || order_cell[0][2] != order)
+          return size_t(-1);
+      size_t classnr = VertexOrientationClass<N_VERTEX> (this->vnums);
+      return 2 * (order + 256 * classnr) + (nodalp2 ? 1 : 0);
+    }
   };
 
 }  
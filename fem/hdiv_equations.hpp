@@ -392,6 +392,13 @@ public:
     y.Range(0,fel.GetNDof()) = ((1.0/mip.GetJacobiDet())* InnerProduct (x, mip.GetNV()) ) * Cast(fel).GetShape (mip.IP(), lh);
   }
 
+  static void GenerateMatrixSIMDIR (const FiniteElement & fel,
+                                    const SIMD_BaseMappedIntegrationRule & mir,
+                                    BareSliceMatrix<SIMD<double>> mat)
+  {
+    Cast(fel).CalcMappedShape (mir, mat);
+  }
+
   using DiffOp<DiffOpIdVecHDivBoundary<D,FEL>>::ApplySIMDIR;          
   static void ApplySIMDIR (const FiniteElement & fel, const SIMD_BaseMappedIntegrationRule & mir,
                            BareSliceVector<double> x, BareSliceMatrix<SIMD<double>> y)
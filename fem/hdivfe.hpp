@@ -201,6 +201,13 @@ namespace ngfem
       throw Exception(string("CalcMappedShape not implemented for H(div) normal element ")+typeid(*this).name());
     }
 
+    // shape * normal, the rows are dof*(D+1)+comp
+    virtual void CalcMappedShape (const SIMD_BaseMappedIntegrationRule & mir,
+                                  BareSliceMatrix<SIMD<double>> shapes) const
+    {
+      throw ExceptionNOSIMD ("HDivNormalFE::CalcMappedShape (simd) not overloaded");
+    }
+
     virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir,
                            BareSliceVector<> coefs,
                            BareSliceMatrix<SIMD<double>> values) const
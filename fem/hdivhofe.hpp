@@ -83,6 +83,24 @@ namespace ngfem
                                       
     }
 
+    virtual void CalcMappedShape (const SIMD_BaseMappedIntegrationRule & bmir,
+                                  BareSliceMatrix<SIMD<double>> shapes) const override
+    {
+      auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM+1>&> (bmir);
+      for (size_t i = 0; i < mir.Size(); i++)
+        {
+          auto & mip = mir[i];
+          auto scaled_nv = (1.0/mip.GetJacobiDet()) * mip.GetNV();
+          auto shapei = shapes.Col(i);
+          TIP<DIM,SIMD<double>> tip = mip.IP().template TIp<DIM>();
+          static_cast<const FEL*> (this) ->
+            T_CalcShape (tip, SBLambda([shapei, scaled_nv] (size_t nr, SIMD<double> shape)
+                                       {
+                                         shapei.Range(nr*(DIM+1), (nr+1)*(DIM+1)) = shape * scaled_nv;
+                                       }));
+        }
+    }
+
     virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & bmir,
                            BareSliceVector<> coefs,
                            BareSliceMatrix<SIMD<double>> values) const override
@@ -12,6 +12,56 @@
 namespace ngfem
 {
 
+  static mutex simd_fallbacks_mutex;
+  static Array<unique_ptr<SIMDFallbacks::Entry>> & SIMDFallbackEntries ()
+  {
+    static Array<unique_ptr<SIMDFallbacks::Entry>> entries;
+    return entries;
+  }
+
+  SIMDFallbacks::Entry & SIMDFallbacks :: Get (const string & where, const string & what)
+  {
+    lock_guard<mutex> guard(simd_fallbacks_mutex);
+    auto & entries = SIMDFallbackEntries();
+    for (auto & entry : entries)
+      if (entry->where == where && entry->what == what)
+        return *entry;
+    auto entry = make_unique<Entry>();
+    entry->where = where;
+    entry->what = what;
+    entries.Append (move(entry));
+    return *entries.Last();
+  }
+
+  Array<const SIMDFallbacks::Entry*> SIMDFallbacks :: GetEntries ()
+  {
+    lock_guard<mutex> guard(simd_fallbacks_mutex);
+    Array<const Entry*> used;
+    for (auto & entry : SIMDFallbackEntries())
+      if (entry->elements > 0)
+        used.Append (entry.get());
+    return used;
+  }
+
+  void SIMDFallbacks :: Reset ()
+  {
+    // entries are referenced by integrators, only the counters are cleared
+    lock_guard<mutex> guard(simd_fallbacks_mutex);
+    for (auto & entry : SIMDFallbackEntries())
+      entry->elements = 0;
+  }
+
+  void SIMDFallbacks :: Print (ostream & ost)
+  {
+    auto entries = GetEntries();
+    if (entries.Size() == 0) return;
+    ost << "SIMD fallbacks to scalar evaluation:" << endl;
+    for (auto entry : entries)
+      ost << "  " << entry->where << ", elements = " << entry->elements << endl
+          << "    " << entry->what << endl;
+  }
+
+
   DifferentialOperator :: ~DifferentialOperator ()
   {
     ;
@@ -84,6 +134,16 @@ namespace ngfem
     return name;   // string("Integrator ") + typeid(*this).name(); 
   }
 
+  void Integrator :: SimdFallback (const ExceptionNOSIMD & e, const string & where,
+                                  bool count_element) const
+  {
+    auto & entry = SIMDFallbacks::Get (Name() + " (" + ToString(VB()) + "), " + where, e.What());
+    if (count_element)
+      entry.elements++;
+    simd_fallback = &entry;
+    simd_evaluate = false;
+  }
+
     
 
   void Integrator :: SetIntegrationAlongCurve ( const int npoints )
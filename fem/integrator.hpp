@@ -19,6 +19,54 @@ namespace ngfem
   // enum FORM_TYPE { VOLUME_FORM, BOUNDARY_FORM, SKELETON_FORM, CURVE_FORM };
 
 
+  /*
+    Book-keeping of SIMD evaluations which failed with ExceptionNOSIMD and
+    were redone in the scalar path. An entry is the place (integrator and
+    function) together with the exception message, which names the
+    CoefficientFunction or DifferentialOperator without SIMD support.
+  */
+  class NGS_DLL_HEADER SIMDFallbacks
+  {
+  public:
+    struct Entry
+    {
+      string where;
+      string what;
+      /// number of elements evaluated in the scalar path
+      atomic<size_t> elements{0};
+    };
+
+    /// the entry stays valid for the lifetime of the program
+    static Entry & Get (const string & where, const string & what);
+    static void Record (const string & where, const ExceptionNOSIMD & e, size_t elements = 1)
+    { Get (where, e.What()).elements += elements; }
+
+    /// entries with at least one element
+    static Array<const Entry*> GetEntries ();
+    static void Reset ();
+    static void Print (ostream & ost);
+  };
+
+  /*
+    For element loops which switch to the scalar path after the first
+    ExceptionNOSIMD: Fallback in the catch, CountScalarElement in the scalar path.
+  */
+  class SIMDFallbackCounter
+  {
+    string where;
+    atomic<SIMDFallbacks::Entry*> entry{nullptr};
+  public:
+    SIMDFallbackCounter (const string & awhere) : where(awhere) { ; }
+    void Fallback (const ExceptionNOSIMD & e)
+    { entry = &SIMDFallbacks::Get (where, e.What()); }
+    void CountScalarElement ()
+    {
+      if (auto e = entry.load(memory_order_relaxed))
+        e->elements++;
+    }
+  };
+
+
   /**
      Base class for linear-form and bilinear-form integrators.
      Provides integration order, restriction to subdomains
@@ -58,7 +106,10 @@ namespace ngfem
     std::array<unique_ptr<IntegrationRule>,25> userdefined_intrules;
     std::array<unique_ptr<SIMD_IntegrationRule>,25> userdefined_simd_intrules;
 
-    mutable bool simd_evaluate = true;
+    /// atomic: cleared by SimdFallback while other threads are integrating
+    mutable atomic<bool> simd_evaluate{true};
+    /// set when SIMD got switched off by an ExceptionNOSIMD, before simd_evaluate is cleared
+    mutable atomic<SIMDFallbacks::Entry*> simd_fallback{nullptr};
 
     shared_ptr<ngcomp::GridFunction> deformation; // ALE for this integrator
     
@@ -258,6 +309,20 @@ namespace ngfem
     bool SimdEvaluate () const { return simd_evaluate; }
     void SetSimdEvaluate (bool b = true) { simd_evaluate = b; }
 
+    /// switch to scalar evaluation after e was thrown in function 'where',
+    /// count_element = false if the element is retried on the counting scalar path
+    void SimdFallback (const ExceptionNOSIMD & e, const string & where,
+                       bool count_element = true) const;
+    /// counts an element where the scalar path is taken, if SIMD was switched off by a fallback.
+    /// A thread which has seen simd_evaluate cleared also sees the entry
+    void CountScalarElement () const
+    {
+      if (simd_evaluate) return;
+      if (auto entry = simd_fallback.load())
+        entry->elements++;
+    }
+    SIMDFallbacks::Entry * GetSimdFallback () const { return simd_fallback; }
+
     void SetDeformation (shared_ptr<ngcomp::GridFunction> adeform) { deformation = adeform; } 
     const shared_ptr<ngcomp::GridFunction> & GetDeformation() const { return deformation; }
   };
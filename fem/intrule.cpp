@@ -3230,6 +3230,7 @@ namespace ngfem
           {
             IntegrationRule ir(eltype, order);
             auto tmp = new SIMD_IntegrationRule(ir);
+            tmp->SetPersistent();
             switch (eltype)
               {
               case ET_SEGM:
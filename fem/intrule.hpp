@@ -2323,6 +2323,7 @@ namespace ngfem
     int dimension = -1;
     size_t nip = -47;
     const SIMD_IntegrationRule *irx = nullptr, *iry = nullptr, *irz = nullptr; // for tensor product IR
+    bool persistent = false;  // points live until program end, e.g. the global rules
   public:
     SIMD_IntegrationRule () = default;
     inline SIMD_IntegrationRule (ELEMENT_TYPE eltype, int order);
@@ -2354,6 +2355,7 @@ namespace ngfem
       ir2.irx = irx;
       ir2.iry = iry;
       ir2.irz = irz;
+      ir2.persistent = persistent;
       return ir2;
     }
 
@@ -2366,6 +2368,10 @@ namespace ngfem
     void SetIRX(const SIMD_IntegrationRule * ir) { irx = ir; }
     void SetIRY(const SIMD_IntegrationRule * ir) { iry = ir; }
     void SetIRZ(const SIMD_IntegrationRule * ir) { irz = ir; }
+
+    /// the points may be used as key for cached data (e.g. shape tables)
+    bool IsPersistent() const { return persistent; }
+    void SetPersistent(bool p = true) { persistent = p; }
   };
 
   extern NGS_DLL_HEADER const SIMD_IntegrationRule & SIMD_SelectIntegrationRule (ELEMENT_TYPE eltype, int order);
@@ -2381,6 +2387,7 @@ namespace ngfem
     irx = ir.irx;
     iry = ir.iry;
     irz = ir.irz;
+    persistent = ir.persistent;
   }
 
 
@@ -2409,6 +2416,7 @@ namespace ngfem
       ir.SetIRY(&air.GetIRY());
       ir.SetIRZ(&air.GetIRZ());
       ir.SetNIP(air.GetNIP());
+      ir.SetPersistent(air.IsPersistent());
     }
     ~SIMD_BaseMappedIntegrationRule ()
       { ir.NothingToDelete(); }
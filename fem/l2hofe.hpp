@@ -110,6 +110,14 @@ namespace ngfem
       return { 0, 0, 0, 0 }; // for the compiler
     }
 
+    /// shape functions depend on vertex ordering and orders, cache only uniform order
+    size_t ShapeClassKey () const
+    {
+      for (int i = 0; i < DIM; i++)
+        if (order_inner[i] != order) return size_t(-1);
+      return order + 256 * size_t(VertexOrientationClass<N_VERTEX> (vnums));
+    }
+
     NGS_DLL_HEADER virtual void PrecomputeTrace () override;
     NGS_DLL_HEADER virtual void PrecomputeGrad () override;
     NGS_DLL_HEADER virtual void PrecomputeShapes (const IntegrationRule & ir) override;
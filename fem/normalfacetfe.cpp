@@ -46,6 +46,38 @@ namespace ngfem
     return tip;
   }
 
+  template <int DIM>
+  auto GetHDivNormalTIP (const SIMD<IntegrationPoint> & ip);
+
+  template<>
+  auto GetHDivNormalTIP<1> (const SIMD<IntegrationPoint> & ip)
+  {
+    TIP<1, AutoDiff<2,SIMD<double>>> tip(ip.FacetNr(), ip.VB());
+    tip.x.Value() = ip(0);
+    tip.x.DValue(1) = 1.0;
+    tip.x.DValue(0) = 0.0;
+
+    return tip;
+  }
+
+  template<>
+  auto GetHDivNormalTIP<2> (const SIMD<IntegrationPoint> & ip)
+  {
+    TIP<2, AutoDiff<3,SIMD<double>>> tip(ip.FacetNr(), ip.VB());
+    tip.x.Value() = ip(0);
+    tip.y.Value() = ip(1);
+
+    tip.x.DValue(0) = 0.0;
+    tip.x.DValue(1) = 1.0;
+    tip.x.DValue(2) = 0.0;
+
+    tip.y.DValue(0) = -1.0;
+    tip.y.DValue(1) = 0.0;
+    tip.y.DValue(2) = 0.0;
+
+    return tip;
+  }
+
   
 
 
@@ -417,6 +449,80 @@ namespace ngfem
                           }));
   }
   
+  /*
+    SIMD evaluation on boundary elements, the mapped shapes are
+    shape * nv / det as in DiffOpIdVecHDivBoundary.
+  */
+  template<ELEMENT_TYPE ET>
+  void NormalFacetFacetFE<ET>::
+  CalcMappedShape (const SIMD_BaseMappedIntegrationRule & bmir,
+                   BareSliceMatrix<SIMD<double>> shapes) const
+  {
+    if (bmir.DimSpace() != DIM+1)
+      throw ExceptionNOSIMD ("NormalFacetFacetFE::CalcMappedShape (simd) needs codim 1");
+    auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM+1>&> (bmir);
+    for (size_t i = 0; i < mir.Size(); i++)
+      {
+        auto scaled_nv = (1.0/mir[i].GetJacobiDet()) * mir[i].GetNV();
+        auto shapei = shapes.Col(i);
+        T_CalcShape (GetHDivNormalTIP<DIM>(mir[i].IP()),
+                     SBLambda([shapei, scaled_nv] (size_t j, auto val)
+                              {
+                                SIMD<double> shape = HDiv2ShapeNew(val)(DIM);
+                                shapei.Range(j*(DIM+1), (j+1)*(DIM+1)) = shape * scaled_nv;
+                              }));
+      }
+  }
+
+  template<ELEMENT_TYPE ET>
+  void NormalFacetFacetFE<ET>::
+  Evaluate (const SIMD_BaseMappedIntegrationRule & bmir,
+            BareSliceVector<> coefs,
+            BareSliceMatrix<SIMD<double>> values) const
+  {
+    if (bmir.DimSpace() != DIM+1)
+      throw ExceptionNOSIMD ("NormalFacetFacetFE::Evaluate (simd) needs codim 1");
+    auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM+1>&> (bmir);
+    for (size_t i = 0; i < mir.Size(); i++)
+      {
+        SIMD<double> sum(0.0);
+        T_CalcShape (GetHDivNormalTIP<DIM>(mir[i].IP()),
+                     SBLambda([&sum, coefs] (size_t j, auto val)
+                              {
+                                sum += coefs(j) * HDiv2ShapeNew(val)(DIM);
+                              }));
+        sum /= mir[i].GetJacobiDet();
+        auto nv = mir[i].GetNV();
+        for (size_t k = 0; k < DIM+1; k++)
+          values(k,i) = nv[k] * sum;
+      }
+  }
+
+  template<ELEMENT_TYPE ET>
+  void NormalFacetFacetFE<ET>::
+  AddTrans (const SIMD_BaseMappedIntegrationRule & bmir,
+            BareSliceMatrix<SIMD<double>> values,
+            BareSliceVector<> coefs) const
+  {
+    if (bmir.DimSpace() != DIM+1)
+      throw ExceptionNOSIMD ("NormalFacetFacetFE::AddTrans (simd) needs codim 1");
+    auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM+1>&> (bmir);
+    for (size_t i = 0; i < mir.Size(); i++)
+      {
+        auto nv = mir[i].GetNV();
+        SIMD<double> sum = 0.0;
+        for (size_t k = 0; k < DIM+1; k++)
+          sum += nv[k] * values(k,i);
+        SIMD<double> vali = sum / mir[i].GetJacobiDet();
+
+        T_CalcShape (GetHDivNormalTIP<DIM>(mir[i].IP()),
+                     SBLambda([vali, coefs] (size_t j, auto val)
+                              {
+                                coefs(j) += HSum(HDiv2ShapeNew(val)(DIM) * vali);
+                              }));
+      }
+  }
+  
   template<> template <typename Tx, typename TFA>
   void NormalFacetFacetFE<ET_SEGM>::T_CalcShape(TIP<DIM,Tx> tip,
                                                 TFA & shape) const
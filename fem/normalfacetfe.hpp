@@ -63,6 +63,17 @@ namespace ngfem
     virtual void CalcShape(const IntegrationPoint & ip,
          		    FlatVector<> shape) const override;
 
+    virtual void CalcMappedShape (const SIMD_BaseMappedIntegrationRule & mir,
+                                  BareSliceMatrix<SIMD<double>> shapes) const override;
+
+    virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir,
+                           BareSliceVector<> coefs,
+                           BareSliceMatrix<SIMD<double>> values) const override;
+
+    virtual void AddTrans (const SIMD_BaseMappedIntegrationRule & ir,
+                           BareSliceMatrix<SIMD<double>> values,
+                           BareSliceVector<> coefs) const override;
+
     template<typename Tx, typename TFA>  
     void T_CalcShape (TIP<DIM,Tx> tip, TFA & shape) const;
   };
@@ -1611,6 +1611,7 @@ allow_fail : bool
                                }
                              catch (const ExceptionNOSIMD& e)
                                {
+                                 SIMDFallbacks::Record ("CoefficientFunction.__call__", e);
                                  for (auto i = r.begin(); i < r.end(); )
                                    {
                                      HeapReset hr(lh);
@@ -2458,6 +2459,22 @@ kwargs : kwargs
                   [](shared_ptr<BFI> self, bool b) { return self->SetSimdEvaluate(b); },                  
                   "SIMD evaluate ?"
       )
+    .def_property("reference_bmatrices",
+                  [](shared_ptr<BFI> self)
+                  {
+                    auto sbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (self);
+                    return sbfi ? sbfi->ReferenceBMatrices() : false;
+                  },
+                  [](shared_ptr<BFI> self, bool b)
+                  {
+                    auto sbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (self);
+                    if (!sbfi)
+                      throw Exception ("reference_bmatrices needs a symbolic integrator");
+                    sbfi->SetReferenceBMatrices(b);
+                  },
+                  "use cached reference B-matrices on affine trigs and tets ?\n"
+                  "requires elementwise constant coefficients, other elements take the standard path"
+      )
 
     .def("__str__",  [](shared_ptr<BFI> self) { return ToString<BilinearFormIntegrator>(*self); } )
 
@@ -2885,6 +2902,29 @@ alpha : double
                            
   m.def("GenerateL2ElementCode", &GenerateL2ElementCode);
 
+  m.def("SIMDFallbacks", [] ()
+        {
+          py::list fallbacks;
+          for (auto entry : SIMDFallbacks::GetEntries())
+            {
+              py::dict fallback;
+              fallback["where"] = py::str(entry->where);
+              fallback["what"] = py::str(entry->what);
+              fallback["elements"] = py::int_(size_t(entry->elements));
+              fallbacks.append(fallback);
+            }
+          return fallbacks;
+        }, docu_string(R"raw_string(
+Returns the list of SIMD evaluations which failed and were done by the
+slower scalar evaluation instead. Every entry is a dict with
+  'where': the integrator or function,
+  'what': the exception message, naming the CoefficientFunction or
+          differential operator without SIMD support,
+  'elements': the number of elements evaluated by the scalar path.
+)raw_string"));
+
+  m.def("ResetSIMDFallbacks", &SIMDFallbacks::Reset, "Reset the SIMD fallback counters");
+
   m.def("VoxelCoefficient",
         [](py::tuple pystart, py::tuple pyend, py::array values,
            bool linear, py::object trafocf)
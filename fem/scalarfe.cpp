@@ -20,6 +20,9 @@
 namespace ngfem
 {
 
+  size_t shape_cache_max_bytes = size_t(256) << 20;
+  atomic<size_t> shape_cache_bytes{0};
+
   /*
   template <int D>
   ScalarFiniteElement<D> :: ~ScalarFiniteElement () 
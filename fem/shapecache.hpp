@@ -0,0 +1,115 @@
+#ifndef FILE_SHAPECACHE
+#define FILE_SHAPECACHE
+
+/*********************************************************************/
+/* File:   shapecache.hpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <shared_mutex>
+
+namespace ngfem
+{
+
+  /// upper bound for all cached shape tables, 0 disables the cache
+  NGS_DLL_HEADER extern size_t shape_cache_max_bytes;
+  NGS_DLL_HEADER extern atomic<size_t> shape_cache_bytes;
+
+
+  /// rank of the permutation sorting the vertex numbers (in [0, N!) )
+  template <int N, typename TVN>
+  INLINE int VertexOrientationClass (const TVN & vnums)
+  {
+    int classnr = 0;
+    for (int i = 0; i < N; i++)
+      {
+        int smaller = 0;
+        for (int j = i+1; j < N; j++)
+          if (vnums[j] < vnums[i]) smaller++;
+        classnr = classnr * (N-i) + smaller;
+      }
+    return classnr;
+  }
+
+
+  /*
+    Shape functions and reference gradients in the points of a SIMD
+    integration rule. shapes is ndof x nip, dshapes consists of DIM
+    blocks of size ndof x nip holding the partial derivatives.
+  */
+  class SIMD_ShapeTable
+  {
+  public:
+    size_t ndof;
+    int dim;
+    Matrix<SIMD<double>> shapes;
+    Matrix<SIMD<double>> dshapes;
+
+    SIMD_ShapeTable (size_t andof, int adim, size_t nip)
+      : ndof(andof), dim(adim), shapes(andof, nip), dshapes(adim*andof, nip) { ; }
+
+    static size_t Bytes (size_t ndof, int dim, size_t nip)
+    { return (dim+1)*ndof*nip*sizeof(SIMD<double>); }
+
+    /// the SIMD tables as double matrices, one column per scalar point
+    FlatMatrix<> Shapes () const
+    { return FlatMatrix<> (ndof, shapes.Width()*SIMD<double>::Size(), (double*)shapes.Data()); }
+    /// partial derivatives in direction k
+    FlatMatrix<> DShapes (int k) const
+    { return FlatMatrix<> (ndof, dshapes.Width()*SIMD<double>::Size(),
+                           (double*)dshapes.Data() + k*ndof*dshapes.Width()*SIMD<double>::Size()); }
+  };
+
+
+  /*
+    Shape tables of one element class, keyed by the class key of the
+    element (orientation class and orders) and the integration rule.
+    Only rules living for the whole run (IsPersistent) are used as keys.
+  */
+  class SIMD_ShapeCache
+  {
+    typedef tuple<size_t, const SIMD<IntegrationPoint>*, size_t> TKey;
+    map<TKey, unique_ptr<SIMD_ShapeTable>> tables;
+    mutable shared_mutex mtx;
+  public:
+    ~SIMD_ShapeCache ()
+    {
+      for (auto & [key,tab] : tables)
+        shape_cache_bytes -= SIMD_ShapeTable::Bytes (tab->ndof, tab->dim, tab->shapes.Width());
+    }
+
+    /// returns nullptr if the table does not fit into the memory budget
+    template <typename FUNC>
+    const SIMD_ShapeTable * Get (size_t classkey, const SIMD_IntegrationRule & ir,
+                                 size_t ndof, int dim, FUNC fill)
+    {
+      TKey key { classkey, ir.Data(), ir.Size() };
+      {
+        shared_lock<shared_mutex> guard(mtx);
+        auto pos = tables.find(key);
+        if (pos != tables.end()) return pos->second.get();
+      }
+
+      size_t bytes = SIMD_ShapeTable::Bytes (ndof, dim, ir.Size());
+      if (shape_cache_bytes.fetch_add (bytes) + bytes > shape_cache_max_bytes)
+        {
+          shape_cache_bytes -= bytes;
+          return nullptr;
+        }
+
+      auto tab = make_unique<SIMD_ShapeTable> (ndof, dim, ir.Size());
+      fill (*tab);
+
+      unique_lock<shared_mutex> guard(mtx);
+      auto & entry = tables[key];
+      if (entry)    // computed concurrently by another thread
+        shape_cache_bytes -= bytes;
+      else
+        entry = move(tab);
+      return entry.get();
+    }
+  };
+
+}
+
+#endif
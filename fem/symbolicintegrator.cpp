@@ -1043,7 +1043,8 @@ namespace ngfem
         return;
       }
     
-    if (simd_evaluate)
+    // there are no complex SIMD mapped rules, elements with a complex (PML) trafo go the scalar way
+    if (simd_evaluate && !trafo.IsComplex())
       {
         try
           {
@@ -1103,13 +1104,14 @@ namespace ngfem
           {
             cout << IM(6) << e.What() << endl
                  << "switching back to standard evaluation" << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "CalcElementVector", false);
             T_CalcElementVector (fel, trafo, elvec, lh);
           }
       }
     else
       {
         // static Timer t("symbolicLFI - CalcElementVector", NoTracing); RegionTimer reg(t);
+        CountScalarElement();
         HeapReset hr(lh);
         // IntegrationRule ir(trafo.GetElementType(), 2*fel.Order());
         const IntegrationRule& ir = GetIntegrationRule(trafo.GetElementType(),2*fel.Order()+bonus_intorder);
@@ -1473,6 +1475,242 @@ namespace ngfem
   {
     ExtendSymmetric (elmat);
   }
+
+  const SymbolicBilinearFormIntegrator::RefBMatrix * SymbolicBilinearFormIntegrator ::
+  GetRefBMatrix (const FiniteElement & fel, const DifferentialOperator & diffop,
+                 int classnr, const SIMD_IntegrationRule & ir, LocalHeap & lh) const
+  {
+    TRefBKey key { &typeid(fel), classnr, fel.GetNDof(), fel.Order(), &diffop, ir.Data(), ir.Size() };
+    {
+      shared_lock<shared_mutex> guard(refb_mutex);
+      auto pos = refb_cache.find(key);
+      if (pos != refb_cache.end()) return pos->second.get();
+    }
+
+    static Timer t("SymbolicBFI::GetRefBMatrix"); RegionTimer reg(t);
+    HeapReset hr(lh);
+    size_t ndof = fel.GetNDof();
+    size_t dim = diffop.Dim();
+    auto & reftrafo = GetFEElementTransformation (fel.ElementType());
+
+    auto refb = make_unique<RefBMatrix>();
+    refb->bmat.SetSize (ndof*dim, ir.Size());
+    diffop.CalcMatrix (fel, reftrafo(ir, lh), refb->bmat);
+
+    IntegrationPoint ip0 = ir[0][0];
+    FlatMatrix<double,ColMajor> b0(dim, ndof, lh);
+    diffop.CalcMatrix (fel, reftrafo(ip0, lh), b0, lh);
+    refb->bref0.SetSize (ndof, dim);
+    refb->bref0 = Trans(b0);
+
+    // least squares: the B-matrix in one point determines the mapping
+    try
+      {
+        Matrix<> gram = b0 * Trans(b0);
+        CalcInverse (gram);
+        refb->pinv.SetSize (dim, ndof);
+        refb->pinv = gram * b0;
+
+        Matrix<> check = refb->pinv * refb->bref0;
+        for (size_t i = 0; i < dim; i++)
+          check(i,i) -= 1;
+        refb->valid = L2Norm(check) < 1e-8;
+      }
+    catch (const Exception &)
+      {
+        refb->valid = false;
+      }
+
+    unique_lock<shared_mutex> guard(refb_mutex);
+    auto & entry = refb_cache[key];
+    if (!entry)    // else computed concurrently by another thread
+      entry = move(refb);
+    return entry.get();
+  }
+
+
+  /*
+    Affine elements with elementwise constant coefficients: the B-matrix
+    is the reference B-matrix times a constant mapping, Bphys = Bref M^T.
+    The mapping is recovered in the first integration point, the
+    coefficient is condensed into Dref = M1^T D M2, and the element
+    matrix becomes one product of cached reference B-matrices.
+  */
+  bool SymbolicBilinearFormIntegrator ::
+  CalcElementMatrixAddRefB (const FiniteElement & fel,
+                            const ElementTransformation & trafo,
+                            FlatMatrix<double> elmat,
+                            bool & symmetric_so_far,
+                            LocalHeap & lh) const
+  {
+    auto et = fel.ElementType();
+    if (!elementwise_constant || vb != VOL || trafo.IsCurvedElement() ||
+        (et != ET_TRIG && et != ET_TET) || trafo.SpaceDim() != Dim(et) ||
+        typeid(fel) == typeid(const MixedFiniteElement&))
+      return false;
+
+    static Timer t("SymbolicBFI::CalcElementMatrixAddRefB", NoTracing);
+    RegionTimer reg(t);
+
+    // reference shapes depend on the ordering of the vertices
+    int nv = ElementTopology::GetNVertices(et);
+    int sort[4] = { -1, -1, -1, -1 };
+    int rank[4];
+    trafo.GetSort (FlatArray<int> (nv, sort));
+    for (int i = 0; i < nv; i++)
+      {
+        if (sort[i] < 0) return false;
+        rank[sort[i]] = i;
+      }
+    int classnr = (et == ET_TRIG) ? VertexOrientationClass<3> (rank) : VertexOrientationClass<4> (rank);
+
+    const SIMD_IntegrationRule & ir = Get_SIMD_IntegrationRule (fel, lh);
+    if (!ir.IsPersistent()) return false;
+    IntegrationPoint ip0 = ir[0][0];
+    BaseMappedIntegrationPoint & mip0 = trafo(ip0, lh);
+
+    // recover the mappings of all proxies before touching elmat
+    auto get_mapping = [&] (ProxyFunction * proxy, const RefBMatrix *& refb) -> double*
+      {
+        auto & diffop = *proxy->Evaluator();
+        refb = GetRefBMatrix (fel, diffop, classnr, ir, lh);
+        if (!refb->valid) return nullptr;
+
+        size_t dim = proxy->Dimension();
+        FlatMatrix<double,ColMajor> bphys(dim, fel.GetNDof(), lh);
+        diffop.CalcMatrix (fel, mip0, bphys, lh);
+        FlatMatrix<> mt(dim, dim, lh);
+        mt = refb->pinv * Trans(bphys);
+
+        FlatMatrix<> diff(fel.GetNDof(), dim, lh);
+        diff = Trans(bphys);
+        diff -= refb->bref0 * mt;
+        if (!(L2Norm(diff) <= 1e-10 * L2Norm(bphys))) return nullptr;
+        return mt.Data();
+      };
+
+    FlatArray<const RefBMatrix*> refb1(trial_proxies.Size(), lh), refb2(test_proxies.Size(), lh);
+    FlatArray<double*> mt1(trial_proxies.Size(), lh), mt2(test_proxies.Size(), lh);
+    for (size_t i = 0; i < trial_proxies.Size(); i++)
+      if (!(mt1[i] = get_mapping (trial_proxies[i], refb1[i]))) return false;
+    for (size_t i = 0; i < test_proxies.Size(); i++)
+      if (!(mt2[i] = get_mapping (test_proxies[i], refb2[i]))) return false;
+
+    // the coefficient is constant, one SIMD point is enough
+    SIMD_IntegrationRule ir1(1, const_cast<SIMD<IntegrationPoint>*> (&ir[0]));
+    SIMD_BaseMappedIntegrationRule & mir1 = trafo(ir1, lh);
+
+    ProxyUserData ud;
+    const_cast<ElementTransformation&>(trafo).userdata = &ud;
+    PrecomputeCacheCF(cache_cfs, mir1, lh);
+
+    FlatVector<SIMD<double>> weights(ir.Size(), lh);
+    for (size_t i = 0; i < ir.Size(); i++)
+      weights(i) = mip0.GetMeasure() * ir[i].Weight();
+
+    // Dref = M1^T D M2, the coefficient in reference components
+    FlatArray<double*> drefs(nonzeros_proxies.Height()*nonzeros_proxies.Width(), lh);
+    int k1 = 0;
+    for (size_t k1nr = 0; k1nr < trial_proxies.Size(); k1nr++)
+      {
+        auto proxy1 = trial_proxies[k1nr];
+        int l1 = 0;
+        for (size_t l1nr = 0; l1nr < test_proxies.Size(); l1nr++)
+          {
+            auto proxy2 = test_proxies[l1nr];
+            size_t dim_proxy1 = proxy1->Dimension();
+            size_t dim_proxy2 = proxy2->Dimension();
+            size_t tt_pair = l1nr*trial_proxies.Size()+k1nr;
+            drefs[tt_pair] = nullptr;
+
+            if (nonzeros_proxies(tt_pair))
+              {
+                FlatMatrix<> dref(dim_proxy1, dim_proxy2, lh);
+                drefs[tt_pair] = dref.Data();
+                HeapReset hr(lh);
+
+                FlatMatrix<SIMD<double>> proxyvalues(dim_proxy1*dim_proxy2, 1, lh);
+                proxyvalues = 0.0;
+                if (ddcf_dtest_dtrial(l1nr, k1nr))
+                  ddcf_dtest_dtrial(l1nr, k1nr)->Evaluate(mir1, proxyvalues);
+                else
+                  for (size_t k = 0, kk = 0; k < dim_proxy1; k++)
+                    for (size_t l = 0; l < dim_proxy2; l++, kk++)
+                      if (nonzeros(l1+l, k1+k))
+                        {
+                          ud.trialfunction = proxy1;
+                          ud.trial_comp = k;
+                          ud.testfunction = proxy2;
+                          ud.test_comp = l;
+                          cf -> Evaluate(mir1, proxyvalues.Rows(kk,kk+1));
+                        }
+
+                FlatMatrix<> dmat(dim_proxy1, dim_proxy2, lh);
+                for (size_t k = 0; k < dim_proxy1; k++)
+                  for (size_t j = 0; j < dim_proxy2; j++)
+                    dmat(k,j) = nonzeros(l1+j, k1+k) ?
+                      (symbolic_integrator_uses_diff ?
+                       proxyvalues(j*dim_proxy1+k, 0)[0] : proxyvalues(k*dim_proxy2+j, 0)[0]) : 0.0;
+                FlatMatrix<> mat1(dim_proxy1, dim_proxy1, mt1[k1nr]);
+                FlatMatrix<> mat2(dim_proxy2, dim_proxy2, mt2[l1nr]);
+                FlatMatrix<> dmat2(dim_proxy1, dim_proxy2, lh);
+                dmat2 = dmat * Trans(mat2);
+                dref = mat1 * dmat2;
+              }
+            l1 += proxy2->Dimension();
+          }
+        k1 += proxy1->Dimension();
+      }
+
+    // from here on elmat is modified, nothing may fail
+    for (size_t k1nr = 0; k1nr < trial_proxies.Size(); k1nr++)
+      for (size_t l1nr = 0; l1nr < test_proxies.Size(); l1nr++)
+        {
+          size_t tt_pair = l1nr*trial_proxies.Size()+k1nr;
+          if (!drefs[tt_pair]) continue;
+
+          HeapReset hr(lh);
+          auto proxy1 = trial_proxies[k1nr];
+          auto proxy2 = test_proxies[l1nr];
+          size_t dim_proxy1 = proxy1->Dimension();
+          size_t dim_proxy2 = proxy2->Dimension();
+          bool samediffop = same_diffops(tt_pair);
+          bool is_diagonal = diagonal_proxies(tt_pair);
+          FlatMatrix<> dref(dim_proxy1, dim_proxy2, drefs[tt_pair]);
+
+          IntRange r1 = proxy1->Evaluator()->UsedDofs(fel);
+          IntRange r2 = proxy2->Evaluator()->UsedDofs(fel);
+          SliceMatrix<double> part_elmat = elmat.Rows(r2).Cols(r1);
+
+          auto & bbmat1 = refb1[k1nr]->bmat;
+          FlatMatrix<SIMD<double>> bdbmat1(elmat.Width() * dim_proxy2, ir.Size(), lh);
+          FlatMatrix<SIMD<double>> hbdbmat1(elmat.Width(), dim_proxy2 * ir.Size(), bdbmat1.Data());
+          FlatMatrix<SIMD<double>> hbbmat2(elmat.Height(), dim_proxy2 * ir.Size(), refb2[l1nr]->bmat.Data());
+
+          hbdbmat1.Rows(r1) = 0.0;
+          for (size_t j = 0; j < dim_proxy2; j++)
+            for (size_t k = 0; k < dim_proxy1; k++)
+              if (dref(k,j) != 0.0)
+                {
+                  auto bbmat1_k = bbmat1.RowSlice(k, dim_proxy1).Rows(r1);
+                  auto bdbmat1_j = bdbmat1.RowSlice(j, dim_proxy2).Rows(r1);
+
+                  for (size_t i = 0; i < ir.Size(); i++)
+                    bdbmat1_j.Col(i).Range(0,r1.Size()) += dref(k,j)*weights(i) * bbmat1_k.Col(i);
+                }
+
+          // Dref is symmetric for diagonal D and equal mappings
+          symmetric_so_far &= samediffop && is_diagonal;
+          if (symmetric_so_far)
+            {
+              AddABtSym (hbbmat2.Rows(r2), hbdbmat1.Rows(r1), part_elmat);
+              ExtendSymmetric (part_elmat);
+            }
+          else
+            AddABt (hbbmat2.Rows(r2), hbdbmat1.Rows(r1), part_elmat);
+        }
+    return true;
+  }
   
 
   /*
@@ -1522,12 +1760,23 @@ namespace ngfem
       }
     
 
+    if constexpr (is_same<SCAL,double>::value && is_same<SCAL_RES,double>::value)
+      if (reference_bmatrices && simd_evaluate && !trafo.IsComplex())
+        try
+          {
+            if (CalcElementMatrixAddRefB (fel, trafo, elmat, symmetric_so_far, lh))
+              return;
+          }
+        catch (const ExceptionNOSIMD &)
+          { ; }  // elmat is untouched, the standard path does the fallback
+
     bool is_mixedfe = typeid(fel) == typeid(const MixedFiniteElement&);
     const MixedFiniteElement * mixedfe = static_cast<const MixedFiniteElement*> (&fel);
     const FiniteElement & fel_trial = is_mixedfe ? mixedfe->FETrial() : fel;
     const FiniteElement & fel_test = is_mixedfe ? mixedfe->FETest() : fel;
     // size_t first_std_eval = 0;
-    if (simd_evaluate)
+    // there are no complex SIMD mapped rules, elements with a complex (PML) trafo go the scalar way
+    if (simd_evaluate && !trafo.IsComplex())
       try
         {
           // static Timer tsimd(string("SymbolicBFI::CalcElementMatrixAddSIMD")+typeid(SCAL).name()+typeid(SCAL_SHAPES).name()+typeid(SCAL_RES).name(), NoTracing);          
@@ -1785,12 +2034,13 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "CalcElementMatrix", false);
           throw ExceptionNOSIMD("in TCalcElementMatrixAdd");
           // T_CalcElementMatrixAdd<SCAL, SCAL_SHAPES, SCAL_RES> (fel, trafo, elmat, lh);
           // return;
         }
     
+    CountScalarElement();
 
     // IntegrationRule ir(trafo.GetElementType(), intorder);
     const IntegrationRule& ir = GetIntegrationRule (fel, lh);
@@ -2237,11 +2487,12 @@ namespace ngfem
             {
               cout << IM(6) << e.What() << endl
                    << "switching to scalar evaluation, may be a problem with Add" << endl;
-              simd_evaluate = false;
+              SimdFallback (e, "CalcElementMatrixEB", false);
               throw ExceptionNOSIMD("disabled simd-evaluate in AddElementMatrixEB");
             }
         }
       
+      CountScalarElement();
       for (int k = 0; k < nfacet; k++)
         {
           // tir.Start();
@@ -2570,7 +2821,7 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation in CalcLinearized" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "CalcLinearizedElementMatrix");
           CalcLinearizedElementMatrix (fel, trafo, elveclin, elmat, lh);
           return;
         }
@@ -2782,7 +3033,7 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation in CalcLinearizedEB" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "CalcLinearizedElementMatrixEB");
           T_CalcLinearizedElementMatrixEB<SCAL,SCAL_SHAPES> (fel1, trafo, elveclin, elmat, lh);
           return;
         }
@@ -2981,7 +3232,7 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "ApplyElementMatrix");
           ApplyElementMatrix (fel, trafo, elx, ely, precomputed, lh);
           return;
         }
@@ -3130,7 +3381,7 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "ApplyElementMatrixEB");
           T_ApplyElementMatrixEB<SCAL,SCAL_SHAPES> (fel, trafo, elx, ely, precomputed, lh);
           return;
         }
@@ -3263,7 +3514,7 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "ApplyElementMatrixTrans");
           ApplyElementMatrix (fel, trafo, elx, ely, precomputed, lh);
           return;
         }
@@ -3408,7 +3659,7 @@ namespace ngfem
         {
           cout << IM(6) << e.What() << endl
                << "switching to scalar evaluation" << endl;
-          simd_evaluate = false;
+          SimdFallback (e, "ApplyElementMatrixTransEB");
           T_ApplyElementMatrixEB<SCAL,SCAL_SHAPES> (fel, trafo, elx, ely, precomputed, lh);
           return;
         }
@@ -4150,7 +4401,7 @@ namespace ngfem
           {
             cout << IM(6) << "caught in SymbolicFacetInegtrator::Apply: " << endl
                  << e.What() << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "ApplyFacetMatrix");
             ApplyFacetMatrix (fel1, LocalFacetNr1, trafo1, ElVertices1,
                               fel2, LocalFacetNr2, trafo2, ElVertices2,
                               elx, ely, lh);
@@ -4329,7 +4580,7 @@ namespace ngfem
           {
             cout << IM(6) << "caught in SymbolicFacetInegtrator::CalcTraceValues: " << endl
                  << e.What() << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "CalcTraceValues");
 	    CalcTraceValues (volumefel, LocalFacetNr, eltrans, ElVertices, trace, elx, lh);
           }
 	return;
@@ -4462,7 +4713,7 @@ namespace ngfem
           {
             cout << IM(6) << "caught in SymbolicFacetInegtrator::CalcTraceValues: " << endl
                  << e.What() << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "ApplyFromTraceValues");
 	    ApplyFromTraceValues(volumefel, LocalFacetNr, eltrans, ElVertices,
 				 trace, elx, ely, lh);
           }
@@ -4628,7 +4879,7 @@ namespace ngfem
           {
             cout << IM(6) << "caught in SymbolicFacetInegtrator::ApplyBnd: " << endl
                  << e.What() << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "ApplyFacetMatrix (bnd)");
             ApplyFacetMatrix (fel1, LocalFacetNr, trafo1, ElVertices,
                               strafo, SElVertices, 
                               elx, ely, lh);
@@ -4917,7 +5168,7 @@ namespace ngfem
           {
             cout << IM(6) << e.What() << endl
                  << "switching back to standard evaluation (in SymbolicEnergy::CalcLinearized)" << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "CalcLinearizedElementMatrix");
             CalcLinearizedElementMatrix (fel, trafo, elveclin, elmat, lh);
           }
         return;
@@ -5342,7 +5593,7 @@ namespace ngfem
           {
             cout << IM(6) << e.What() << endl
                  << "switching back to standard evaluation (in SymbolicEnergy::Energy)" << endl;
-            simd_evaluate = false;
+            SimdFallback (e, "Energy");
             return Energy (fel, trafo, elx, lh);
           }
       }
@@ -5512,7 +5763,7 @@ namespace ngfem
           {
             cout << IM(6) << e.What() << endl
                  << "switching back to standard evaluation (in SymbolicEnergy::CalcLinearized)" << endl;              
-            simd_evaluate = false;
+            SimdFallback (e, "ApplyElementMatrix");
             ApplyElementMatrix (fel, trafo, elx, ely, precomputed, lh);
           }
         return;
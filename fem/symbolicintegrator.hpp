@@ -678,6 +678,21 @@ public:
     shared_ptr<BilinearFormIntegrator> linearization;
     Array<shared_ptr<CoefficientFunction>> dcf_dtest;  // derivatives by test-functions
     Matrix<shared_ptr<CoefficientFunction>> ddcf_dtest_dtrial;  // derivatives by test- and trial-functions
+
+    bool reference_bmatrices = false;  // affine elements use cached reference B-matrices ?
+    // B-matrix of a diffop on the reference element
+    struct RefBMatrix
+    {
+      bool valid = false;
+      Matrix<SIMD<double>> bmat;   // ndof*dim x nip, in the points of the SIMD rule
+      Matrix<> bref0;              // ndof x dim, in the first integration point
+      Matrix<> pinv;               // dim x ndof, left inverse of bref0
+    };
+    // fe-type, orientation class, ndof, order, diffop, integration rule
+    typedef tuple<const type_info*, int, size_t, int, const DifferentialOperator*,
+                  const SIMD<IntegrationPoint>*, size_t> TRefBKey;
+    mutable map<TRefBKey, unique_ptr<RefBMatrix>> refb_cache;
+    mutable shared_mutex refb_mutex;
   public:
     NGS_DLL_HEADER SymbolicBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb,
                                                    VorB aelement_boundary);
@@ -697,6 +712,9 @@ public:
     void SetLinearization(shared_ptr<BilinearFormIntegrator> _lin)
     { linearization = _lin; }
 
+    bool ReferenceBMatrices () const { return reference_bmatrices; }
+    void SetReferenceBMatrices (bool b = true) { reference_bmatrices = b; }
+
     NGS_DLL_HEADER virtual void 
     CalcElementMatrix (const FiniteElement & fel,
 		       const ElementTransformation & trafo, 
@@ -731,6 +749,19 @@ public:
                                  bool & symmetric_so_far, 
                                  LocalHeap & lh) const;
 
+    const RefBMatrix * GetRefBMatrix (const FiniteElement & fel,
+                                      const DifferentialOperator & diffop,
+                                      int classnr,
+                                      const SIMD_IntegrationRule & ir,
+                                      LocalHeap & lh) const;
+
+    /// affine elements with constant coefficients, returns false if not applicable
+    bool CalcElementMatrixAddRefB (const FiniteElement & fel,
+                                   const ElementTransformation & trafo,
+                                   FlatMatrix<double> elmat,
+                                   bool & symmetric_so_far,
+                                   LocalHeap & lh) const;
+
     template <typename SCAL, typename SCAL_SHAPES, typename SCAL_RES>
     void T_CalcElementMatrixEBAdd (const FiniteElement & fel,
                                    const ElementTransformation & trafo, 
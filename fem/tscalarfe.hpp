@@ -144,8 +144,14 @@ namespace ngfem
     NGS_DLL_HEADER virtual void AddDualTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values, BareSliceVector<> coefs) const override;    
 
     NGS_DLL_HEADER virtual bool GetDiagDualityMassInverse (FlatVector<> diag) const override;
+
+    /// elements with equal key have the same shape functions, -1 if not cacheable
+    size_t ShapeClassKey () const { return size_t(-1); }
     
   protected:
+    /// cached shapes in the points of a persistent rule, nullptr if not available
+    const SIMD_ShapeTable * GetShapeTable (const SIMD_IntegrationRule & ir) const;
+
     /*
     template<typename Tx, typename TFA>  
     INLINE void T_CalcShape (Tx x[], TFA & shape) const
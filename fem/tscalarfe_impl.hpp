@@ -29,6 +29,33 @@ namespace ngfem
 
 #ifndef FASTCOMPILE
 
+  template <class FEL, ELEMENT_TYPE ET, class BASE>
+  const SIMD_ShapeTable * T_ScalarFiniteElement<FEL,ET,BASE> :: 
+  GetShapeTable (const SIMD_IntegrationRule & ir) const
+  {
+    if constexpr (DIM == 0)
+      return nullptr;
+    else
+      {
+        if (!ir.IsPersistent() || shape_cache_max_bytes == 0) return nullptr;
+        size_t key = static_cast<const FEL*> (this) -> ShapeClassKey();
+        if (key == size_t(-1)) return nullptr;
+
+        static SIMD_ShapeCache cache;
+        return cache.Get (key, ir, ndof, DIM, [this,&ir] (SIMD_ShapeTable & tab)
+          {
+            for (size_t i = 0; i < ir.Size(); i++)
+              T_CalcShape (GetTIPGrad<DIM> (ir[i]),
+                           SBLambda ([&tab,i] (size_t j, auto shape)
+                                     {
+                                       tab.shapes(j,i) = shape.Value();
+                                       for (int k = 0; k < DIM; k++)
+                                         tab.dshapes(k*tab.ndof+j,i) = shape.DValue(k);
+                                     }));
+          });
+      }
+  }
+
   template <class FEL, ELEMENT_TYPE ET, class BASE>
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   CalcShape (const IntegrationRule & ir, BareSliceMatrix<> shape) const
@@ -41,6 +68,11 @@ namespace ngfem
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shapes) const
   {
+    if (auto tab = GetShapeTable(ir))
+      {
+        shapes.AddSize(ndof, ir.Size()) = tab->shapes;
+        return;
+      }
     /*
     for (size_t i = 0; i < ir.Size(); i++)
       T_CalcShape (GetTIP<DIM>(ir[i]),
@@ -80,6 +112,13 @@ namespace ngfem
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
   {
+    if (auto tab = GetShapeTable(ir))
+      {
+        FlatVector<> hvalues(ir.Size()*SIMD<double>::Size(), (double*)values.Data());
+        hvalues = Trans(tab->Shapes()) * coefs.Range(0,ndof);
+        return;
+      }
+    
     FlatArray<SIMD<IntegrationPoint>> hir = ir;
     size_t i = 0;
     for ( ; i+2 <= hir.Size(); i+=2)
@@ -123,6 +162,14 @@ namespace ngfem
             SliceMatrix<> coefs,
             BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto tab = GetShapeTable(ir))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        SliceMatrix<> hvalues(coefs.Width(), ir.Size()*SW, values.Dist()*SW, (double*)values.Data());
+        hvalues = Trans(coefs.Rows(0,ndof)) * tab->Shapes();
+        return;
+      }
+    
     FlatArray<SIMD<IntegrationPoint>> hir = ir;    
     size_t j = 0;
     for ( ; j+4 <= coefs.Width(); j+=4)
@@ -233,6 +280,13 @@ namespace ngfem
   AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values,
             BareSliceVector<> coefs) const
   {
+    if (auto tab = GetShapeTable(ir))
+      {
+        FlatVector<> hvalues(ir.Size()*SIMD<double>::Size(), (double*)values.Data());
+        coefs.Range(0,ndof) += tab->Shapes() * hvalues;
+        return;
+      }
+    
     FlatArray<SIMD<IntegrationPoint>> hir = ir;
     /*
     for (int i = 0; i < hir.Size(); i++)
@@ -371,6 +425,14 @@ namespace ngfem
             BareSliceMatrix<SIMD<double>> values,
             SliceMatrix<> coefs) const
   {
+    if (auto tab = GetShapeTable(ir))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        SliceMatrix<> hvalues(coefs.Width(), ir.Size()*SW, values.Dist()*SW, (double*)values.Data());
+        coefs.Rows(0,ndof) += tab->Shapes() * Trans(hvalues);
+        return;
+      }
+    
     FlatArray<SIMD<IntegrationPoint>> hir = ir;    
     size_t j = 0;
     for ( ; j+4 <= coefs.Width(); j+=4)
@@ -528,6 +590,26 @@ namespace ngfem
        {
          constexpr int DIMSPACE = DIM+CODIM.value;         
          auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+
+         if (auto tab = this->GetShapeTable(mir.IR()))
+           {
+             // reference gradients from the table, then map by J^{-T}
+             constexpr size_t SW = SIMD<double>::Size();
+             STACK_ARRAY(SIMD<double>, mem, DIM*mir.Size());
+             FlatMatrix<SIMD<double>> refgrad(DIM, mir.Size(), &mem[0]);
+             for (int k = 0; k < DIM; k++)
+               {
+                 FlatVector<> hrow(mir.Size()*SW, (double*)refgrad.Row(k).Data());
+                 hrow = Trans(tab->DShapes(k)) * coefs.Range(0,this->ndof);
+               }
+             for (size_t i = 0; i < mir.Size(); i++)
+               {
+                 Vec<DIM,SIMD<double>> rg = refgrad.Col(i);
+                 values.Col(i).Range(DIMSPACE) = Trans(mir[i].GetJacobianInverse()) * rg;
+               }
+             return;
+           }
+         
          for (size_t i = 0; i < mir.Size(); i++)
            {
              double *pcoefs = &coefs(0);
@@ -553,6 +635,17 @@ namespace ngfem
                 BareSliceVector<> coefs,
                 BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto tab = GetShapeTable(ir))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        for (int k = 0; k < DIM; k++)
+          {
+            FlatVector<> hrow(ir.Size()*SW, (double*)&values(k,0));
+            hrow = Trans(tab->DShapes(k)) * coefs.Range(0,ndof);
+          }
+        return;
+      }
+    
     for (int i = 0; i < ir.Size(); i++)
       {
         Vec<DIM,SIMD<double>> sum(0.0);
@@ -612,6 +705,26 @@ namespace ngfem
          if (bmir.DimSpace() == DIMSPACE)
            {
              auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+
+             if (auto tab = this->GetShapeTable(mir.IR()))
+               {
+                 // pull back to reference gradients, then one GEMV per direction
+                 constexpr size_t SW = SIMD<double>::Size();
+                 STACK_ARRAY(SIMD<double>, mem, DIM*mir.Size());
+                 FlatMatrix<SIMD<double>> refvals(DIM, mir.Size(), &mem[0]);
+                 for (size_t i = 0; i < mir.Size(); i++)
+                   {
+                     Vec<DIMSPACE,SIMD<double>> vali = values.Col(i).Range(DIMSPACE);
+                     refvals.Col(i) = mir[i].GetJacobianInverse() * vali;
+                   }
+                 for (int k = 0; k < DIM; k++)
+                   {
+                     FlatVector<> hrow(mir.Size()*SW, (double*)refvals.Row(k).Data());
+                     coefs.Range(0,this->ndof) += tab->DShapes(k) * hrow;
+                   }
+                 return;
+               }
+             
              for (size_t i = 0; i < mir.Size(); i++)
                {
                  // Directional derivative
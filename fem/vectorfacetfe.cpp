@@ -248,8 +248,8 @@ namespace ngfem
     if(vnums[fav[1]] > vnums[fav[2]]) swap(fav[1],fav[2]);
     if(vnums[fav[0]] > vnums[fav[1]]) swap(fav[0],fav[1]); 	
 
-    AutoDiff<2> adxi  = lami[fav[0]]-lami[fav[2]];
-    AutoDiff<2> adeta = lami[fav[1]]-lami[fav[2]];
+    Tx adxi  = lami[fav[0]]-lami[fav[2]];
+    Tx adeta = lami[fav[1]]-lami[fav[2]];
 
     DubinerBasis::Eval(order_inner[0], lami[fav[1]].Value(), lami[fav[0]].Value(),
                        SBLambda([&] (size_t nr, Tx val)
@@ -270,15 +270,15 @@ namespace ngfem
 
   /* **************************** Facet Quad ********************************* */
 
-  template<>
-  void VectorFacetFacetFE<ET_QUAD>::CalcShape (const IntegrationPoint & ip,
-					  SliceMatrix<> shape) const
+  template<> template <typename Tx, typename TFA>
+  void VectorFacetFacetFE<ET_QUAD>::T_CalcShape(TIP<DIM,Tx> tip, 
+                                                TFA &  shape) const
   {
-    AutoDiff<2> x (ip(0), 0);
-    AutoDiff<2> y (ip(1), 1);
+    Tx x = tip.x;
+    Tx y = tip.y;
 
     // orient: copied from h1
-    AutoDiff<2> sigma[4] = {(1-x)+(1-y),x+(1-y),x+y,(1-x)+y};  
+    Tx sigma[4] = {(1-x)+(1-y),x+(1-y),x+y,(1-x)+y};  
     int fmax = 0; 
     for (int j = 1; j < 4; j++)
       if (vnums[j] > vnums[fmax]) fmax = j;
@@ -286,28 +286,23 @@ namespace ngfem
     int f2 = (fmax+1)%4; 
     if(vnums[f2] > vnums[f1]) swap(f1,f2);  // fmax > f1 > f2; 
 
-    AutoDiff<2> xi  = sigma[fmax] - sigma[f1]; 
-    AutoDiff<2> eta = sigma[fmax] - sigma[f2]; 
+    Tx xi  = sigma[fmax] - sigma[f1]; 
+    Tx eta = sigma[fmax] - sigma[f2]; 
     
     int ii = 0;
-    
-    int n = max2(order_inner[0],order_inner[1]);
-    ArrayMem<double, 20> polx(n+1), poly(n+1);
-
-    LegendrePolynomial (n, xi.Value(), polx);
-    LegendrePolynomial (n, eta.Value(), poly);
-    
-    for (int i = 0; i <= order_inner[0]; i++)
-      for (int j = 0; j <= order_inner[1]; j++)
-	{
-	  double val = polx[i] * poly[j];
-	  shape(ii,0) = val * xi.DValue(0);
-	  shape(ii,1) = val * xi.DValue(1);
-	  ii++;
-	  shape(ii,0) = val * eta.DValue(0);
-	  shape(ii,1) = val * eta.DValue(1);
-	  ii++;
-	}
+    LegendrePolynomial
+      (order_inner[0], xi.Value(),
+       SBLambda([&] (size_t i, auto polx)
+                {
+                  LegendrePolynomial
+                    (order_inner[1], eta.Value(),
+                     SBLambda([&] (size_t j, auto poly)
+                              {
+                                Tx val = polx * poly;
+                                shape[ii++] = uDv(val, xi);
+                                shape[ii++] = uDv(val, eta);
+                              }));
+                }));
   }
 
   template<>
@@ -318,6 +313,79 @@ namespace ngfem
   }
 
 
+  /*
+    SIMD evaluation on boundary elements. The reference derivatives are
+    mapped by the pseudo-inverse of the Jacobian, this is the covariant
+    transformation of the tangential field.
+  */
+  template <ELEMENT_TYPE ET>
+  void VectorFacetFacetFE<ET>::
+  CalcMappedShape (const SIMD_BaseMappedIntegrationRule & bmir, 
+                   BareSliceMatrix<SIMD<double>> shapes) const
+  {
+    Switch<4-DIM>
+      (bmir.DimSpace()-DIM,[this,&bmir,shapes](auto CODIM)
+       {
+         constexpr int DIMSPACE = DIM+CODIM.value;
+         auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+         for (size_t i = 0; i < mir.Size(); i++)
+           {
+             auto shapei = shapes.Col(i);
+             this->T_CalcShape (GetTIP(mir[i]),
+                                SBLambda ([shapei,DIMSPACE] (size_t j, auto s)
+                                          {
+                                            shapei.Range(j*DIMSPACE, (j+1)*DIMSPACE) = s.Value();
+                                          }));
+           }
+       });
+  }
+
+  template <ELEMENT_TYPE ET>
+  void VectorFacetFacetFE<ET>::
+  Evaluate (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs,
+            BareSliceMatrix<SIMD<double>> values) const
+  {
+    Switch<4-DIM>
+      (bmir.DimSpace()-DIM,[this,&bmir,coefs,values](auto CODIM)
+       {
+         constexpr int DIMSPACE = DIM+CODIM.value;
+         auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+         for (size_t i = 0; i < mir.Size(); i++)
+           {
+             Vec<DIMSPACE,SIMD<double>> sum(0.0);
+             this->T_CalcShape (GetTIP(mir[i]),
+                                SBLambda ([&sum,coefs] (size_t j, auto shape)
+                                          {
+                                            sum += coefs(j) * shape.Value();
+                                          }));
+             values.Col(i).Range(DIMSPACE) = sum;
+           }
+       });
+  }
+
+  template <ELEMENT_TYPE ET>
+  void VectorFacetFacetFE<ET>::
+  AddTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values,
+            BareSliceVector<> coefs) const
+  {
+    Switch<4-DIM>
+      (bmir.DimSpace()-DIM,[this,&bmir,coefs,values](auto CODIM)
+       {
+         constexpr int DIMSPACE = DIM+CODIM.value;
+         auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+         for (size_t i = 0; i < mir.Size(); i++)
+           {
+             Vec<DIMSPACE,SIMD<double>> vali = values.Col(i);
+             this->T_CalcShape (GetTIP(mir[i]),
+                                SBLambda ([vali,coefs] (size_t j, auto s)
+                                          {
+                                            coefs(j) += HSum(InnerProduct(s.Value(), vali));
+                                          }));
+           }
+       });
+  }
+
+
   /* **************************** Volume Trig ********************************* */
 
   template<>
@@ -1071,6 +1139,7 @@ namespace ngfem
   
   template class VectorFacetFacetFE<ET_SEGM>;
   template class VectorFacetFacetFE<ET_TRIG>;
+  template class VectorFacetFacetFE<ET_QUAD>;
   
   // template class VectorFacetVolumeFE<ET_SEGM>;
   template class VectorFacetVolumeFE<ET_TRIG>;
@@ -14,6 +14,89 @@ Arnoldi Eigenvalue Solver
 
 namespace ngla
 {
+
+  void ShiftedInverseCache :: Clear ()
+  {
+    lock_guard<mutex> guard(mtx);
+    shifts.SetSize0();
+    mats.SetSize0();
+    inverses.SetSize0();
+  }
+
+  void ShiftedInverseCache :: Prepare (FlatArray<Complex> ashifts)
+  {
+    static Timer t("ShiftedInverseCache::Prepare");
+    RegionTimer reg(t);
+    lock_guard<mutex> guard(mtx);
+
+    Array<Complex> missing;
+    for (auto s : ashifts)
+      if (!shifts.Contains(s) && !missing.Contains(s))
+        missing.Append (s);
+    if (missing.Size() == 0) return;
+
+    size_t n = missing.Size();
+    Array<shared_ptr<BaseMatrix>> newmats(n), newinvs(n);
+    for (size_t i = 0; i < n; i++)
+      {
+        newmats[i] = a->CreateMatrix();
+        if (a->IsComplex())
+          newmats[i]->AsVector() = a->AsVector() - missing[i]*b->AsVector();
+        else
+          {
+            if (missing[i].imag() != 0)
+              throw Exception ("Only real shifts allowed for real matrices");
+            newmats[i]->AsVector() = a->AsVector() - missing[i].real()*b->AsVector();
+          }
+        if (inversetype)
+          newmats[i]->SetInverseType (*inversetype);
+      }
+
+    // the symbolic factorization is taken from any factorization we have
+    shared_ptr<SparseFactorization> symbolic;
+    for (auto inv : inverses)
+      if ( (symbolic = dynamic_pointer_cast<SparseFactorization> (inv)) )
+        break;
+
+    size_t first = 0;
+    if (!symbolic)
+      {
+        newinvs[0] = newmats[0]->InverseMatrix (freedofs);
+        symbolic = dynamic_pointer_cast<SparseFactorization> (newinvs[0]);
+        first = 1;
+      }
+
+    // numeric factorizations in parallel over the shifts. They only read
+    // the symbolic factorization, and the ParallelFor inside FactorNew
+    // runs within the task of its shift
+    if (symbolic)
+      ParallelFor (IntRange(first, n), [&] (size_t i)
+                   {
+                     if (auto sp = dynamic_pointer_cast<BaseSparseMatrix> (newmats[i]))
+                       newinvs[i] = symbolic->CreateSameStructure (sp);
+                   });
+
+    // factorizations without shared symbolic phase, they are parallel on their own
+    for (size_t i = first; i < n; i++)
+      if (!newinvs[i])
+        newinvs[i] = newmats[i]->InverseMatrix (freedofs);
+
+    cout << IM(3) << "ShiftedInverseCache: factorized " << n << " shifts, "
+         << shifts.Size()+n << " in cache" << endl;
+    
+    shifts.Append (missing);
+    mats.Append (newmats);
+    inverses.Append (newinvs);
+  }
+
+  shared_ptr<BaseMatrix> ShiftedInverseCache :: GetInverse (Complex shift)
+  {
+    Prepare (Array<Complex> { shift });
+    lock_guard<mutex> guard(mtx);
+    return inverses[shifts.Pos(shift)];
+  }
+
+
   
   template <typename SCAL>
   void Arnoldi<SCAL>::Calc (int inumval, Array<Complex> & lam, int inumev, 
@@ -168,6 +251,132 @@ namespace ngla
   } 
 	
 
+  template <typename SCAL>
+  void Arnoldi<SCAL>::CalcRational (int inumval, Array<Complex> & lam, int inumev,
+                                    Array<shared_ptr<BaseVector>> & hevecs) const
+  {
+    static Timer t("rational Krylov");
+    static Timer tf("rational Krylov - factor");
+    static Timer to("rational Krylov - orthogonalize");
+    static Timer tp("rational Krylov - project");
+    RegionTimer reg(t);
+
+    Array<SCAL> hshifts = shifts;
+    if (hshifts.Size() == 0)
+      hshifts.Append (shift);
+    size_t ns = hshifts.Size();
+
+    auto cache = inverses;
+    if (!cache)
+      cache = make_shared<ShiftedInverseCache> (a, b, freedofs, inversetype);
+    else if (cache->GetA() != a || cache->GetB() != b)
+      throw Exception ("Arnoldi::CalcRational: inverse cache is for different matrices");
+
+    Array<shared_ptr<BaseMatrix>> invs(ns);
+    tf.Start();
+    Array<Complex> cshifts(ns);
+    for (size_t i = 0; i < ns; i++)
+      cshifts[i] = hshifts[i];
+    cache->Prepare (cshifts);
+    for (size_t i = 0; i < ns; i++)
+      invs[i] = cache->GetInverse (cshifts[i]);
+    tf.Stop();
+
+    shared_ptr<BaseVector> hv = a->CreateColVector();
+    auto hv2 = a->CreateColVector();
+    size_t m = min2 (size_t(inumval), size_t(hv->Size()));
+    auto basis = hv->CreateMultiVector(m);
+    
+    hv->SetRandom();
+    hv->SetParallelStatus (CUMULATED);
+    FlatVector<SCAL> fv = hv->template FV<SCAL>();
+    if (freedofs)
+      for (int i = 0; i < hv->Size(); i++)
+	if (! (*freedofs)[i] ) fv(i) = 0;
+    *hv /= hv->L2Norm();
+    *(*basis)[0] = *hv;
+
+    // orthonormal basis of the rational Krylov space, shifts taken cyclically
+    to.Start();
+    for (size_t i = 1; i < m; i++)
+      {
+        cout << IM(1) << "\ri = " << i << "/" << m << flush;
+        *hv2 = *b * *(*basis)[i-1];
+        *hv = *invs[(i-1) % ns] * *hv2;
+
+        auto vi = basis->Range(IntRange(0, i));
+        for (int pass = 0; pass < 2; pass++)
+          {
+            Vector<SCAL> h = vi->template T_InnerProduct<SCAL> (*hv, true);
+            for (size_t j = 0; j < i; j++)
+              h(j) = -Conj(h(j));
+            vi->AddTo (h, *hv);
+          }
+        *(*basis)[i] = (1.0/hv->L2Norm()) * *hv;
+      }
+    cout << IM(1) << endl;
+    to.Stop();
+
+    // Rayleigh-Ritz: (A_m - shift_0 B_m)^(-1) B_m y = theta y, lam = shift_0 + 1/theta
+    tp.Start();
+    Vector<double> ones(m);
+    ones = 1;
+    auto abasis = hv->CreateMultiVector(m);
+    auto bbasis = hv->CreateMultiVector(m);
+    *abasis = 0.0;
+    *bbasis = 0.0;
+    MultAdd (*a, FlatVector<double>(ones), *basis, *abasis);
+    MultAdd (*b, FlatVector<double>(ones), *basis, *bbasis);
+
+    // projected (i,j) = v_i^H X v_j
+    Matrix<Complex> am(m), bm(m);
+    Matrix<SCAL> hm = abasis->template T_InnerProduct<SCAL> (*basis, true);
+    am = Trans(hm);
+    hm = bbasis->template T_InnerProduct<SCAL> (*basis, true);
+    bm = Trans(hm);
+    tp.Stop();
+
+    Complex shift0 = hshifts[0];
+    Matrix<Complex> shifted = am - shift0 * bm;
+    CalcInverse (shifted);
+    Matrix<Complex> opm = shifted * bm;
+    Matrix<Complex> opmt = Trans(opm);
+    Vector<Complex> theta(m);
+    Matrix<Complex> evecs(m);
+    LapackEigenValues (opmt, theta, evecs);
+
+    Array<Complex> lami(m);
+    Array<double> dist(m);
+    Array<int> index(m);
+    for (size_t i = 0; i < m; i++)
+      {
+        lami[i] = (abs(theta(i)) > 1e-300) ? shift0 + 1.0/theta(i) : Complex(1e300);
+        dist[i] = 1e300;
+        for (auto s : hshifts)
+          dist[i] = min2(dist[i], abs(lami[i]-Complex(s)));
+        index[i] = i;
+      }
+    QuickSort (index, [&] (int i, int j) { return dist[i] < dist[j]; });
+
+    lam.SetSize (m);
+    for (size_t i = 0; i < m; i++)
+      lam[i] = lami[index[i]];
+
+    size_t nout = min2 (size_t(inumev), m);
+    hevecs.SetSize(nout);
+    for (size_t i = 0; i < nout; i++)
+      {
+        if (a->IsComplex())
+          hevecs[i] = a->CreateColVector();
+        else
+          hevecs[i] = make_shared<VVector<Complex>> (a->Height());
+        *hevecs[i] = 0;
+        for (size_t j = 0; j < m; j++)
+          *hevecs[i] += evecs(index[i],j) * *(*basis)[j];
+      }
+  }
+
+
   template class Arnoldi<double>;
   template class Arnoldi<Complex>;
 
@@ -10,6 +10,42 @@
 
 namespace ngla
 {
+  /**
+     Factorizations of A - shift*B for several shifts.
+
+     Missing factorizations are computed in parallel and kept for later
+     requests. Matrices of different shifts have the same non-zero pattern,
+     so factorizations supporting it share the symbolic phase.
+   */
+  class NGS_DLL_HEADER ShiftedInverseCache
+  {
+    shared_ptr<BaseMatrix> a;
+    shared_ptr<BaseMatrix> b;
+    shared_ptr<BitArray> freedofs;
+    optional<string> inversetype;
+
+    Array<Complex> shifts;
+    Array<shared_ptr<BaseMatrix>> mats;
+    Array<shared_ptr<BaseMatrix>> inverses;
+    mutex mtx;
+  public:
+    ShiftedInverseCache (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ab,
+                         shared_ptr<BitArray> afreedofs = nullptr,
+                         optional<string> ainversetype = nullopt)
+      : a(aa), b(ab), freedofs(afreedofs), inversetype(ainversetype) { ; }
+
+    auto GetA () const { return a; }
+    auto GetB () const { return b; }
+    auto GetFreeDofs () const { return freedofs; }
+    size_t Size () const { return shifts.Size(); }
+    void Clear ();
+
+    /// factorizes for all shifts not in the cache yet
+    void Prepare (FlatArray<Complex> ashifts);
+    shared_ptr<BaseMatrix> GetInverse (Complex shift);
+  };
+
+
   /**
      Arnoldi Eigenvalue Solver.
 
@@ -31,6 +67,8 @@ namespace ngla
     shared_ptr<BitArray> freedofs;
     SCAL shift;
     optional<string> inversetype;
+    Array<SCAL> shifts;
+    shared_ptr<ShiftedInverseCache> inverses;
   public:
     Arnoldi (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> ab, shared_ptr<BitArray> afreedofs = nullptr)
       : a(aa), b(ab), freedofs(afreedofs)
@@ -46,6 +84,21 @@ namespace ngla
     void Calc (int numval, Array<Complex> & lam, int nev, 
                Array<shared_ptr<BaseVector>> & evecs, 
                shared_ptr<BaseMatrix> pre = nullptr) const;
+
+    /// shifts of the rational Krylov method
+    void SetShifts (FlatArray<SCAL> ashifts)
+    { shifts = ashifts; }
+    /// factorizations for CalcRational, which can be shared between solvers
+    void SetInverseCache (shared_ptr<ShiftedInverseCache> acache)
+    { inverses = acache; }
+
+    /**
+       Rational Krylov method: the basis of dimension numval is extended
+       alternately by (A-shift_i B)^(-1) B for all shifts. The nev Ritz pairs
+       closest to any of the shifts are returned.
+     */
+    void CalcRational (int numval, Array<Complex> & lam, int nev,
+                       Array<shared_ptr<BaseVector>> & evecs) const;
   };
 }
 
@@ -326,6 +326,8 @@ namespace ngla
       case MUMPS:           return "mumps";
       case MASTERINVERSE:   return "masterinverse";
       case UMFPACK:         return "umfpack";
+      case SPARSELU:        return "sparselu";
+      case AGGLOMERATEDINVERSE: return "agglomeratedinverse";
       }
     return "";
   }
@@ -899,7 +899,7 @@ namespace ngla
     if (ownmem)
       {
         GetMemoryTracer().Free(sizeof(TSCAL) * this->entrysize * this->size);
-        delete [] pdata;
+        FreeFirstTouch (pdata);
       }
   }
 
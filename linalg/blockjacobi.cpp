@@ -360,52 +360,130 @@ namespace ngla
                       [] (size_t a, size_t b) { return a+b; },
                       size_t(0));
 
+    static Timer tcol("BlockJacobi-coloring");
+    tcol.Start();
+
+    size_t nblocks = blocktable->Size();
+    Array<int> coloring(nblocks);
+    coloring = -1;
+
+    int maxcolor = 0;
+    int basecol = 0;
+    Array<unsigned int> mask(mat->Width());
+    size_t found = 0;
+
+    do
+      {
+        mask = 0;
+        
+        for (auto i : Range(nblocks))
+          {
+            if (coloring[i] >= 0) continue;
+
+            unsigned check = 0;
+	    for (int d : (*blocktable)[i] )              
+              check |= mask[d];
+            
+            if (check != UINT_MAX) // 0xFFFFFFFF)
+              {
+                found++;
+                unsigned checkbit = 1;
+                int color = basecol;
+                while (check & checkbit)
+                  {
+                    color++;
+                    checkbit *= 2;
+                  }
+
+                coloring[i] = color;
+                if (color > maxcolor) maxcolor = color;
+                
+                for (int d : (*blocktable)[i] )
+                  for(auto coupling : mat->GetRowIndices(d))
+                    mask[coupling] |= checkbit;
+              }
+          }
+        basecol += 8*sizeof(unsigned int); // 32;
+      }
+    while (found < nblocks);
+    tcol.Stop();    
+
+    TableCreator<int> creator(maxcolor+1);
+    for ( ; !creator.Done(); creator++)
+      for (size_t i = 0; i < nblocks; i++)
+          creator.Add (coloring[i], i);
+    block_coloring = creator.MoveTable();
+
+    cout << IM(4) << " using " << maxcolor+1 << " colors" << endl;
+
+    // calc balancing:
+
+    color_balance.SetSize (block_coloring.Size());
+
+    for (auto c : Range (block_coloring))
+      {
+        color_balance[c].Calc (block_coloring[c].Size(),
+                               [&] (size_t bi)
+                               {
+                                 int costs = 0;
+                                 size_t blocknr = block_coloring[c][bi];
+
+                                 for (auto d : (*blocktable)[blocknr])
+                                   costs += mat->GetRowIndices(d).Size();
+                                 return costs;
+                               });
+
+      }
+
+
+    // the blocks are stored in color order and first touched with the
+    // partitioning of MultAdd/GSSmooth, such that the pages end up on
+    // the NUMA node of the thread which later works on them
     bigmem.SetSize(totmem);
 
     cout << IM(5) << "avg entrysize:   " << blocktable->AsArray().Size()/blocktable->Size() << endl;
     cout << IM(5) << "avg entrysize^2: " << totmem/blocktable->Size() << endl;    
     
     totmem = 0;
-    for (auto i : Range (*blocktable))
-      {
-        size_t bs = (*blocktable)[i].Size();
-        new ( & invdiag[i] ) FlatMatrix<TM> (bs, bs, bigmem.Addr(totmem));
-        totmem += sqr (bs);
-      }
+    for (auto c : Range (block_coloring))
+      for (auto i : block_coloring[c])
+        {
+          size_t bs = (*blocktable)[i].Size();
+          new ( & invdiag[i] ) FlatMatrix<TM> (bs, bs, bigmem.Addr(totmem));
+          totmem += sqr (bs);
+        }
 
 
 
     /** Get diagonal blocks **/
-    SharedLoop2 sl1(blocktable->Size());
-    ParallelJob
-      ([&] (const TaskInfo & ti)
-       {
-         NgProfiler::StartThreadTimer (tpar, TaskManager::GetThreadId());         
-         for (int i : sl1)
-       {
-         NgProfiler::StartThreadTimer (tprep, TaskManager::GetThreadId());
-
-        auto blocki = (*blocktable)[i];
-        QuickSort (blocki);
-	if (!blocki.Size()) 
-	  {
-            NgProfiler::StopThreadTimer (tprep, TaskManager::GetThreadId());                             
-	    invdiag[i] = 0;
-	    // return;
-            continue;
-	  }
-	
-        FlatMatrix<TM> & blockmat = invdiag[i];
-        NgProfiler::StopThreadTimer (tprep, TaskManager::GetThreadId());                 
-        NgProfiler::StartThreadTimer (tget, TaskManager::GetThreadId());
-	for (size_t j = 0; j < blocki.Size(); j++)
-	  for (size_t k = 0; k < blocki.Size(); k++)
-	    blockmat(j,k) = (*mat)(blocki[j], blocki[k]);
-        NgProfiler::StopThreadTimer (tget, TaskManager::GetThreadId());                         
-        // }, TasksPerThread(10));
-       }
-         NgProfiler::StopThreadTimer (tpar, TaskManager::GetThreadId());                  
-       } );
+    for (auto c : Range (block_coloring))
+      ParallelForRange
+        (color_balance[c], [&] (IntRange r)
+         {
+           NgProfiler::StartThreadTimer (tpar, TaskManager::GetThreadId());         
+           for (auto i : block_coloring[c].Range(r))
+             {
+               NgProfiler::StartThreadTimer (tprep, TaskManager::GetThreadId());
+               
+               auto blocki = (*blocktable)[i];
+               QuickSort (blocki);
+               if (!blocki.Size()) 
+                 {
+                   NgProfiler::StopThreadTimer (tprep, TaskManager::GetThreadId());                             
+                   invdiag[i] = 0;
+                   continue;
+                 }
+               
+               FlatMatrix<TM> & blockmat = invdiag[i];
+               NgProfiler::StopThreadTimer (tprep, TaskManager::GetThreadId());                 
+               NgProfiler::StartThreadTimer (tget, TaskManager::GetThreadId());
+               for (size_t j = 0; j < blocki.Size(); j++)
+                 for (size_t k = 0; k < blocki.Size(); k++)
+                   blockmat(j,k) = (*mat)(blocki[j], blocki[k]);
+               NgProfiler::StopThreadTimer (tget, TaskManager::GetThreadId());                         
+             }
+           NgProfiler::StopThreadTimer (tpar, TaskManager::GetThreadId());                  
+         });
 
 
     /**
@@ -503,82 +581,6 @@ namespace ngla
        } );
 
     cout << IM(3) << "\rBuilding block " << blocktable->Size() << "/" << blocktable->Size() << flush;
-    *testout << "block coloring";
-
-    static Timer tcol("BlockJacobi-coloring");
-    tcol.Start();
-
-    size_t nblocks = blocktable->Size();
-    Array<int> coloring(nblocks);
-    coloring = -1;
-
-    int maxcolor = 0;
-    int basecol = 0;
-    Array<unsigned int> mask(mat->Width());
-    size_t found = 0;
-
-    do
-      {
-        mask = 0;
-        
-        for (auto i : Range(nblocks))
-          {
-            if (coloring[i] >= 0) continue;
-
-            unsigned check = 0;
-	    for (int d : (*blocktable)[i] )              
-              check |= mask[d];
-            
-            if (check != UINT_MAX) // 0xFFFFFFFF)
-              {
-                found++;
-                unsigned checkbit = 1;
-                int color = basecol;
-                while (check & checkbit)
-                  {
-                    color++;
-                    checkbit *= 2;
-                  }
-
-                coloring[i] = color;
-                if (color > maxcolor) maxcolor = color;
-                
-                for (int d : (*blocktable)[i] )
-                  for(auto coupling : mat->GetRowIndices(d))
-                    mask[coupling] |= checkbit;
-              }
-          }
-        basecol += 8*sizeof(unsigned int); // 32;
-      }
-    while (found < nblocks);
-    tcol.Stop();    
-
-    TableCreator<int> creator(maxcolor+1);
-    for ( ; !creator.Done(); creator++)
-      for (size_t i = 0; i < nblocks; i++)
-          creator.Add (coloring[i], i);
-    block_coloring = creator.MoveTable();
-
-    cout << IM(4) << " using " << maxcolor+1 << " colors" << endl;
-
-    // calc balancing:
-
-    color_balance.SetSize (block_coloring.Size());
-
-    for (auto c : Range (block_coloring))
-      {
-        color_balance[c].Calc (block_coloring[c].Size(),
-                               [&] (size_t bi)
-                               {
-                                 int costs = 0;
-                                 size_t blocknr = block_coloring[c][bi];
-
-                                 for (auto d : (*blocktable)[blocknr])
-                                   costs += mat->GetRowIndices(d).Size();
-                                 return costs;
-                               });
-
-      }
 
     GetMemoryTracer().Track(bigmem, "InvDiag");
     cout << IM(3) << "\rBlockJacobi Preconditioner built" << endl;
@@ -600,6 +602,7 @@ namespace ngla
   {
     static Timer timer("BlockJacobi::MultAdd");
     RegionTimer reg (timer);
+    AddWork (timer, InvDiagFlops(), InvDiagBytes());
     
     x.Cumulate();
     y.Cumulate();
@@ -643,6 +646,7 @@ namespace ngla
   {
     static Timer timer("BlockJacobi::MultTransAdd");
     RegionTimer reg (timer);
+    AddWork (timer, InvDiagFlops(), InvDiagBytes());
 
     x.Cumulate();
     y.Cumulate();
@@ -690,7 +694,7 @@ namespace ngla
   {
     static Timer timer ("BlockJacobiPrecond::GSSmooth");
     RegionTimer reg(timer);
-    timer.AddFlops (nze);
+    AddWork (timer, steps*SmoothFlops(), steps*SmoothBytes());
     
     FlatVector<TVX> fb = b.FV<TVX> (); 
     FlatVector<TVX> fx = x.FV<TVX> ();
@@ -813,7 +817,7 @@ namespace ngla
   {
     static Timer timer ("BlockJacobiPrecond::GSSmoothBack");
     RegionTimer reg(timer);
-    timer.AddFlops (nze);
+    AddWork (timer, steps*SmoothFlops(), steps*SmoothBytes());
 
     const FlatVector<TVX> fb = b.FV<TVX> (); 
     FlatVector<TVX> fx = x.FV<TVX> ();
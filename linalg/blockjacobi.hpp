@@ -148,6 +148,25 @@ namespace ngla
     typedef TV_ROW TVX;
     typedef typename mat_traits<TM>::TSCAL TSCAL;
 
+  protected:
+    /// work estimates of one sweep for the profiler (a multiply-add counts 2)
+    double EntryFlops () const
+    {
+      return 2 * (is_same<TSCAL,Complex>::value ? 4 : 1) * mat_traits<TM>::HEIGHT * mat_traits<TM>::WIDTH;
+    }
+    /// gather, multiplication with the inverse blocks, scatter
+    double InvDiagFlops () const { return EntryFlops() * bigmem.Size(); }
+    double InvDiagBytes () const
+    {
+      return double(bigmem.Size()) * sizeof(TM)
+        + double(blocktable->AsArray().Size()) * (sizeof(int) + 3*sizeof(TVX));
+    }
+    /// additionally the residual of all block rows
+    double SmoothFlops () const { return InvDiagFlops() + EntryFlops() * nze; }
+    double SmoothBytes () const { return InvDiagBytes() + double(nze) * (sizeof(TM)+sizeof(int)); }
+    
+  public:
+
     ///
     BlockJacobiPrecond (shared_ptr<const SparseMatrix<TM,TV_ROW,TV_COL>> amat, 
 			shared_ptr<Table<int>> ablocktable, bool cumulate_block_diags = false);
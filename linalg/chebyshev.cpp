@@ -30,6 +30,14 @@ namespace ngla
     lmax = almax;
   }
     
+  void ChebyshevIteration :: EstimateBounds (int lanczos_steps)
+  {
+    EstimateSpectralBounds (*a, *c, lanczos_steps, lmin, lmax);
+    // Lanczos approximates the extremal eigenvalues from inside
+    lmin *= 0.95;
+    lmax *= 1.05;
+  }
+
   void  ChebyshevIteration :: 
   Mult (const BaseVector & b, BaseVector & x) const
   {
@@ -78,4 +86,180 @@ namespace ngla
 	  }
       }
   }
+
+
+
+  void EstimateSpectralBounds (const BaseMatrix & a, const BaseMatrix & c, int steps,
+                               double & lmin, double & lmax)
+  {
+    static Timer t("EstimateSpectralBounds"); RegionTimer reg(t);
+
+    auto r = a.CreateColVector();
+    auto z = a.CreateColVector();
+    auto p = a.CreateColVector();
+    auto w = a.CreateColVector();
+
+    r.SetRandom();
+    r.Distribute();
+    z = c * r;
+    p = z;
+    double rz = InnerProduct (*r, *z);
+    double rz0 = rz;
+
+    // CG coefficients give the Lanczos tridiagonal matrix
+    Array<double> alpha, beta;
+    for (int k = 0; k < steps && rz > 1e-30 * rz0; k++)
+      {
+        w = a * p;
+        double pw = InnerProduct (*p, *w);
+        if (pw <= 0) break;
+        double al = rz / pw;
+        r -= al * w;
+        z = c * r;
+        double rznew = InnerProduct (*r, *z);
+        alpha.Append (al);
+        beta.Append (rznew / rz);
+        p *= rznew / rz;
+        p += z;
+        rz = rznew;
+      }
+
+    int n = alpha.Size();
+    if (n == 0)
+      throw Exception ("EstimateSpectralBounds: matrix or preconditioner not positive definite");
+
+    Matrix<double> tri(n);
+    tri = 0.0;
+    for (int i = 0; i < n; i++)
+      {
+        tri(i,i) = 1/alpha[i] + ((i > 0) ? beta[i-1]/alpha[i-1] : 0.0);
+        if (i+1 < n)
+          tri(i,i+1) = tri(i+1,i) = sqrt(beta[i]) / alpha[i];
+      }
+
+#ifdef LAPACK
+    Vector<double> lam(n);
+    Matrix<double> evecs(n);
+    LapackEigenValuesSymmetric (tri, lam, evecs);
+    lmin = lam(0);
+    lmax = lam(n-1);
+#else
+    // Gershgorin
+    lmin = 1e99;
+    lmax = 0;
+    for (int i = 0; i < n; i++)
+      {
+        double offdiag = 0;
+        for (int j = 0; j < n; j++)
+          if (j != i) offdiag += fabs(tri(i,j));
+        lmin = min(lmin, tri(i,i)-offdiag);
+        lmax = max(lmax, tri(i,i)+offdiag);
+      }
+    lmin = max(lmin, 0.0);
+#endif
+  }
+
+
+  // y += s * dinv .* x, x and y cumulated
+  class DiagonalScaling : public BaseMatrix
+  {
+    shared_ptr<BaseVector> dinv;
+  public:
+    DiagonalScaling (shared_ptr<BaseVector> adinv) : dinv(adinv) { ; }
+    bool IsComplex() const override { return false; }
+    int VHeight() const override { return dinv->Size(); }
+    int VWidth() const override { return dinv->Size(); }
+    AutoVector CreateRowVector () const override { return dinv->CreateVector(); }
+    AutoVector CreateColVector () const override { return dinv->CreateVector(); }
+
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override
+    {
+      x.Cumulate();
+      y.Cumulate();
+      auto fd = dinv->FVDouble();
+      auto fx = x.FVDouble();
+      auto fy = y.FVDouble();
+      ParallelForRange (fd.Size(), [&] (IntRange r)
+                        {
+                          for (auto i : r)
+                            fy(i) += s * fd(i) * fx(i);
+                        });
+    }
+  };
+
+
+  shared_ptr<BaseVector> CreateInverseDiagonal (const BaseSparseMatrix & mat, shared_ptr<BitArray> freedofs)
+  {
+    auto smat = dynamic_cast<const SparseMatrixTM<double>*> (&mat);
+    if (!smat)
+      throw Exception (string("CreateInverseDiagonal: needs a real scalar sparse matrix, got ")
+                       + typeid(mat).name());
+
+    shared_ptr<BaseVector> dinv = smat->CreateColVector();
+    auto fd = dinv->FVDouble();
+    ParallelFor (smat->Height(), [&] (size_t i)
+                 {
+                   fd(i) = 0;
+                   if (freedofs && !freedofs->Test(i)) return;
+                   auto cols = smat->GetRowIndices(i);
+                   auto vals = smat->GetRowValues(i);
+                   for (size_t j = 0; j < cols.Size(); j++)
+                     if (cols[j] == int(i) && vals(j) != 0)
+                       fd(i) = 1.0 / vals(j);
+                 });
+    return dinv;
+  }
+
+
+  ChebyshevSmoother :: ChebyshevSmoother (shared_ptr<BaseMatrix> aa, shared_ptr<BaseVector> dinv,
+                                          int adegree, double ratio, int lanczos_steps)
+    : a(aa), jacobi(make_shared<DiagonalScaling>(dinv)), degree(adegree)
+  {
+    if (a->IsComplex())
+      throw Exception ("ChebyshevSmoother: complex matrices are not supported");
+    double emin, emax;
+    EstimateSpectralBounds (*a, *jacobi, lanczos_steps, emin, emax);
+    lmax = 1.1 * emax;
+    lmin = lmax / ratio;
+    cout << IM(5) << "ChebyshevSmoother: estimated lmax = " << emax << endl;
+  }
+
+  void ChebyshevSmoother :: Mult (const BaseVector & b, BaseVector & x) const
+  {
+    x = 0.0;
+    x.SetParallelStatus (CUMULATED);
+    Smooth (x, b, 1);
+  }
+
+  void ChebyshevSmoother :: Smooth (BaseVector & x, const BaseVector & b, int steps) const
+  {
+    static Timer t("ChebyshevSmoother"); RegionTimer reg(t);
+
+    auto r = b.CreateVector();
+    auto w = x.CreateVector();
+    auto d = x.CreateVector();
+
+    double theta = 0.5 * (lmax+lmin);
+    double delta = 0.5 * (lmax-lmin);
+    double sigma = theta / delta;
+
+    for (int s = 0; s < steps; s++)
+      {
+        r = b - (*a) * x;
+        d = (*jacobi) * r;
+        d *= 1/theta;
+        double rho = 1/sigma;
+        for (int k = 1; k <= degree; k++)
+          {
+            x += d;
+            if (k == degree) break;
+            r = b - (*a) * x;
+            w = (*jacobi) * r;
+            double rhonew = 1 / (2*sigma - rho);
+            d *= rhonew * rho;
+            d += (2*rhonew/delta) * w;
+            rho = rhonew;
+          }
+      }
+  }
 }
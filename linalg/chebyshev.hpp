@@ -29,6 +29,8 @@ namespace ngla
     bool IsComplex() const override { return a->IsComplex(); } 
     ///
     void SetBounds (double almin, double almax);
+    /// bounds of the spectrum of C A from some Lanczos steps
+    void EstimateBounds (int lanczos_steps = 10);
     ///
     void Mult (const BaseVector & v, BaseVector & prod) const override;
     ///
@@ -36,6 +38,47 @@ namespace ngla
     AutoVector CreateColVector () const override { return a->CreateRowVector(); }
   };
 
+
+  /**
+     Chebyshev-Jacobi polynomial smoother.
+
+     Damps the eigenvalues of D^{-1} A in [lmax/ratio, lmax], the upper bound
+     is estimated by Lanczos steps. Needs only matrix-vector products and
+     diagonal scaling, dinv is a cumulated vector (zero at non-free dofs).
+  */
+  class NGS_DLL_HEADER ChebyshevSmoother : public BaseMatrix
+  {
+    shared_ptr<BaseMatrix> a;
+    shared_ptr<BaseMatrix> jacobi;
+    int degree;
+    double lmin, lmax;
+  public:
+    ChebyshevSmoother (shared_ptr<BaseMatrix> aa, shared_ptr<BaseVector> dinv,
+                       int adegree = 3, double ratio = 30, int lanczos_steps = 10);
+
+    void SetBounds (double almin, double almax) { lmin = almin; lmax = almax; }
+    double GetLMin () const { return lmin; }
+    double GetLMax () const { return lmax; }
+
+    /// steps times degree Chebyshev iterations for A x = b
+    void Smooth (BaseVector & x, const BaseVector & b, int steps = 1) const;
+
+    bool IsComplex() const override { return false; }
+    int VHeight() const override { return a->VHeight(); }
+    int VWidth() const override { return a->VWidth(); }
+    void Mult (const BaseVector & b, BaseVector & x) const override;
+    AutoVector CreateRowVector () const override { return a->CreateColVector(); }
+    AutoVector CreateColVector () const override { return a->CreateRowVector(); }
+  };
+
+  /// inverse diagonal of a real scalar sparse matrix, zero at non-free dofs
+  NGS_DLL_HEADER shared_ptr<BaseVector>
+  CreateInverseDiagonal (const BaseSparseMatrix & mat, shared_ptr<BitArray> freedofs = nullptr);
+
+  /// extremal eigenvalues of C A from steps Lanczos steps (via CG), A and C symmetric positive
+  NGS_DLL_HEADER void EstimateSpectralBounds (const BaseMatrix & a, const BaseMatrix & c, int steps,
+                                              double & lmin, double & lmax);
+
 }
 
 #endif
@@ -0,0 +1,347 @@
+/**************************************************************************/
+/* File:   eigensolvers.cpp                                               */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+
+   Block eigenvalue solvers on MultiVectors: LOBPCG and Krylov-Schur
+
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  // eigenvalues ascending, eigenvectors are the columns of evecs
+  static void SymmetricEigenSystem (FlatMatrix<double> a, FlatVector<double> lam,
+                                    FlatMatrix<double> evecs)
+  {
+#ifdef LAPACK
+    size_t n = a.Height();
+    Matrix<double> sym = 0.5 * (a + Trans(a));
+    Matrix<double> hevecs(n);
+    LapackEigenValuesSymmetric (sym, lam, hevecs);
+    evecs = Trans (hevecs);
+#else
+    throw Exception ("dense symmetric eigenvalue solver needs LAPACK");
+#endif
+  }
+
+  /*
+    Rayleigh-Ritz for the pencil (ga, gm). Directions in the kernel of gm
+    (linearly dependent basis vectors) are dropped, the columns of y are
+    gm-orthonormal. Returns the number of Ritz pairs.
+   */
+  static size_t RayleighRitz (FlatMatrix<double> ga, FlatMatrix<double> gm,
+                              Vector<double> & lam, Matrix<double> & y)
+  {
+    size_t n = ga.Height();
+    Vector<double> dm(n);
+    Matrix<double> um(n);
+    SymmetricEigenSystem (gm, dm, um);
+
+    size_t first = 0;
+    while (first < n && dm(first) <= 1e-12 * dm(n-1))
+      first++;
+    size_t k = n-first;
+
+    Matrix<double> z(n, k);
+    for (size_t j = 0; j < k; j++)
+      z.Col(j) = (1.0/sqrt(dm(first+j))) * um.Col(first+j);
+
+    Matrix<double> gaz = ga * z;
+    Matrix<double> red = Trans(z) * gaz;
+    Matrix<double> yr(k);
+    lam.SetSize(k);
+    SymmetricEigenSystem (red, lam, yr);
+    y.SetSize(n, k);
+    y = z * yr;
+    return k;
+  }
+
+  static void Apply (const BaseMatrix & mat, const MultiVector & x, MultiVector & y)
+  {
+    Vector<double> ones(x.Size());
+    ones = 1;
+    y = 0.0;
+    mat.MultAdd (ones, x, y);
+  }
+
+
+
+  Vector<double> LOBPCGSolver :: Solve (MultiVector & x)
+  {
+    static Timer t("LOBPCG");
+    static Timer tr("LOBPCG - residuals");
+    static Timer trr("LOBPCG - Rayleigh-Ritz");
+    RegionTimer reg(t);
+
+    if (a->IsComplex() || x.IsComplex())
+      throw Exception ("LOBPCG: only real symmetric problems are supported");
+
+    size_t num = x.Size();
+    if (num == 0) return Vector<double>(0);
+
+    /*
+      the basis S = [X, P, W] of the Rayleigh-Ritz step, together with A*S and M*S.
+      T is the work space for the new X and P.
+     */
+    shared_ptr<BaseVector> refvec = a->CreateColVector();
+    auto S = refvec->CreateMultiVector(3*num);
+    auto AS = refvec->CreateMultiVector(3*num);
+    auto MS = refvec->CreateMultiVector(3*num);
+    auto T = refvec->CreateMultiVector(2*num);
+    auto AT = refvec->CreateMultiVector(2*num);
+    auto MT = refvec->CreateMultiVector(2*num);
+    auto hv = refvec->CreateVector();
+
+    IntRange rx(0, num);
+    auto X = S->Range(rx);
+    auto AX = AS->Range(rx);
+    auto MX = MS->Range(rx);
+
+    // T[offset...] = S[src] * y, and the same for the images
+    auto combine = [&] (IntRange src, FlatMatrix<double> y, size_t offset)
+      {
+        IntRange dst(offset, offset+y.Width());
+        for (auto [from, to] : { pair(S.get(), T.get()), pair(AS.get(), AT.get()), pair(MS.get(), MT.get()) })
+          {
+            auto todst = to->Range(dst);
+            *todst = 0.0;
+            todst->Add (*from->Range(src), y);
+          }
+      };
+    auto copyback = [&] (IntRange r)
+      {
+        *S->Range(r) = *T->Range(r);
+        *AS->Range(r) = *AT->Range(r);
+        *MS->Range(r) = *MT->Range(r);
+      };
+
+    *X = x;
+    X->Orthogonalize (m.get());
+    Apply (*a, *X, *AX);
+    Apply (*m, *X, *MX);
+
+    Vector<double> lam(num), theta;
+    Matrix<double> y;
+    {
+      RegionTimer reg(trr);
+      Matrix<double> ga = X->InnerProductD(*AX);
+      Matrix<double> gm = X->InnerProductD(*MX);
+      if (RayleighRitz (ga, gm, theta, y) < num)
+        throw Exception ("LOBPCG: initial vectors are linearly dependent");
+      lam = theta;
+      combine (rx, y, 0);
+      copyback (rx);
+    }
+
+    size_t np = 0;
+    Array<int> active;
+    for (steps = 1; steps <= maxsteps; steps++)
+      {
+        // residuals of the Ritz pairs, preconditioned ones of the unconverged pairs are the new W
+        active.SetSize0();
+        double maxres = 0;
+        {
+          RegionTimer reg(tr);
+          for (size_t i = 0; i < num; i++)
+            {
+              *hv = *(*AX)[i] - lam(i) * *(*MX)[i];
+              double res = hv.L2Norm() / (fabs(lam(i)) * (*MX)[i]->L2Norm() + 1e-300);
+              maxres = max2(maxres, res);
+              if (res < tol) continue;
+
+              auto w = (*S)[num+np+active.Size()];
+              if (pre)
+                *w = *pre * *hv;
+              else
+                *w = *hv;
+              active.Append(i);
+            }
+        }
+
+        if (printrates)
+          cout << "LOBPCG iteration " << steps << ", active = " << active.Size()
+               << ", max res = " << maxres << ", lam = " << lam << endl;
+        if (active.Size() == 0) break;
+
+        size_t nw = active.Size();
+        IntRange rw(num+np, num+np+nw);
+        auto W = S->Range(rw);
+
+        // M-orthogonalize W to the Ritz vectors
+        Matrix<double> c = MX->InnerProductD(*W);
+        c *= -1;
+        W->Add (*X, c);
+        Apply (*a, *W, *AS->Range(rw));
+        Apply (*m, *W, *MS->Range(rw));
+
+        RegionTimer reg(trr);
+        IntRange rs(0, num+np+nw);
+        Matrix<double> ga = S->Range(rs)->InnerProductD(*AS->Range(rs));
+        Matrix<double> gm = S->Range(rs)->InnerProductD(*MS->Range(rs));
+        if (RayleighRitz (ga, gm, theta, y) < num)
+          throw Exception ("LOBPCG: search space degenerated");
+        lam = theta.Range(0, num);
+
+        // X = S Y_x, and conjugate directions P = [P,W] Y_pw for the active columns
+        Matrix<double> yx = y.Cols(rx);
+        Matrix<double> ypw(np+nw, nw);
+        for (size_t j = 0; j < nw; j++)
+          ypw.Col(j) = y.Col(active[j]).Range(num, num+np+nw);
+
+        combine (rs, yx, 0);
+        combine (IntRange(num, num+np+nw), ypw, num);
+        copyback (IntRange(0, num+nw));
+        np = nw;
+      }
+
+    x = *X;
+    return lam;
+  }
+
+
+
+  Vector<double> KrylovSchurSolver :: Solve (MultiVector & evecs)
+  {
+    static Timer t("KrylovSchur");
+    static Timer texp("KrylovSchur - expand");
+    static Timer trestart("KrylovSchur - restart");
+    RegionTimer reg(t);
+
+    if (a->IsComplex() || evecs.IsComplex())
+      throw Exception ("KrylovSchur: only real symmetric problems are supported");
+
+    size_t nev = evecs.Size();
+    size_t nkry = ncv ? ncv : max(2*nev+1, nev+20);
+    nkry = min(nkry, size_t(a->Height()));
+    if (nev >= nkry)
+      throw Exception ("KrylovSchur: Krylov space dimension " + ToString(nkry)
+                       + " must be larger than the number of eigenvalues " + ToString(nev));
+
+    // A - shift*M entry by entry needs the same non-zero pattern
+    auto spa = dynamic_pointer_cast<BaseSparseMatrix> (a);
+    auto spm = dynamic_pointer_cast<BaseSparseMatrix> (m);
+    if (!spa || !spm || !spa->SameGraph (*spm))
+      throw Exception ("KrylovSchur: A and M must be sparse matrices with the same non-zero pattern");
+    auto mat_shift = a->CreateMatrix();
+    mat_shift->AsVector() = a->AsVector() - shift*m->AsVector();
+    if (inversetype)
+      mat_shift->SetInverseType(*inversetype);
+    shared_ptr<BaseMatrix> inv = mat_shift->InverseMatrix (freedofs);
+
+    shared_ptr<BaseVector> refvec = a->CreateColVector();
+    auto V = refvec->CreateMultiVector(nkry+1);
+    auto T = refvec->CreateMultiVector(nkry);
+    auto w = refvec->CreateVector();
+    auto mw = refvec->CreateVector();
+
+    // V[0..k] is M-orthonormal, (A-shift M)^(-1) M V[0..k) = V[0..k] H
+    Matrix<double> H(nkry+1, nkry);
+    H = 0.0;
+
+    w.SetRandom();
+    *(*V)[0] = *inv * *w;
+    *mw = *m * *(*V)[0];
+    *(*V)[0] /= sqrt ((*V)[0]->InnerProductD(*mw));
+
+    Vector<double> theta(nkry);
+    Matrix<double> ys(nkry);
+    Array<int> order(nkry);
+    size_t kstart = 0, nconv = 0;
+
+    for (steps = 1; steps <= maxsteps; steps++)
+      {
+        texp.Start();
+        for (size_t j = kstart; j < nkry; j++)
+          {
+            *mw = *m * *(*V)[j];
+            *w = *inv * *mw;
+
+            // full re-orthogonalization, twice is enough
+            auto Vj = V->Range(IntRange(0, j+1));
+            for (int pass = 0; pass < 2; pass++)
+              {
+                *mw = *m * *w;
+                Vector<double> h = Vj->InnerProductD(*mw);
+                H.Col(j).Range(0, j+1) += h;
+                h *= -1;
+                Vj->AddTo (h, *w);
+              }
+
+            *mw = *m * *w;
+            double beta = sqrt (w.InnerProductD(*mw));
+            H(j+1, j) = beta;
+            *(*V)[j+1] = (1.0/beta) * *w;
+          }
+        texp.Stop();
+
+        SymmetricEigenSystem (H.Rows(0, nkry), theta, ys);
+
+        // largest |theta| are the eigenvalues closest to the shift
+        for (size_t i = 0; i < nkry; i++) order[i] = i;
+        QuickSort (order, [&] (int i, int j) { return fabs(theta(i)) > fabs(theta(j)); });
+
+        Vector<double> b = Trans(ys) * H.Row(nkry);
+        nconv = 0;
+        while (nconv < nev && fabs(b(order[nconv])) < tol * fabs(theta(order[nconv])))
+          nconv++;
+
+        if (printrates)
+          cout << "KrylovSchur restart " << steps << ", converged = " << nconv << "/" << nev << endl;
+        if (nconv >= nev || steps == maxsteps) break;
+
+        // thick restart with the wanted part of the Schur form
+        RegionTimer reg(trestart);
+        size_t keep = nev + (nkry-nev)/2;
+        Matrix<double> yk(nkry, keep);
+        for (size_t i = 0; i < keep; i++)
+          yk.Col(i) = ys.Col(order[i]);
+
+        auto Tk = T->Range(IntRange(0, keep));
+        *Tk = 0.0;
+        Tk->Add (*V->Range(IntRange(0, nkry)), yk);
+        *V->Range(IntRange(0, keep)) = *Tk;
+        *(*V)[keep] = *(*V)[nkry];
+
+        H = 0.0;
+        for (size_t i = 0; i < keep; i++)
+          {
+            H(i,i) = theta(order[i]);
+            H(keep,i) = b(order[i]);
+          }
+        kstart = keep;
+      }
+
+    if (nconv < nev)
+      cout << IM(1) << "KrylovSchur: only " << nconv << " of " << nev << " eigenpairs converged" << endl;
+
+    Array<int> wanted(nev);
+    for (size_t i = 0; i < nev; i++)
+      wanted[i] = order[i];
+    // ascending eigenvalues shift + 1/theta, theta = 0 is an eigenvalue at infinity
+    QuickSort (wanted, [&] (int i, int j)
+               {
+                 double ti = theta(i), tj = theta(j);
+                 if (ti == 0 || tj == 0) return ti != 0 && tj == 0;
+                 if (ti*tj > 0) return ti > tj;
+                 return ti < 0;
+               });
+
+    Vector<double> lam(nev);
+    Matrix<double> ye(nkry, nev);
+    for (size_t i = 0; i < nev; i++)
+      {
+        double th = theta(wanted[i]);
+        lam(i) = (th != 0) ? shift + 1/th : numeric_limits<double>::infinity();
+        ye.Col(i) = ys.Col(wanted[i]);
+      }
+    evecs = 0.0;
+    evecs.Add (*V->Range(IntRange(0, nkry)), ye);
+    return lam;
+  }
+
+}
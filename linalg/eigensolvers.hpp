@@ -0,0 +1,90 @@
+#ifndef FILE_EIGENSOLVERS
+#define FILE_EIGENSOLVERS
+
+/**************************************************************************/
+/* File:   eigensolvers.hpp                                               */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Locally optimal block preconditioned conjugate gradient method.
+
+     Computes the smallest eigenpairs of the symmetric generalized evp
+
+     A x = lam M x
+
+     with M symmetric positive definite. Converged columns are soft-locked,
+     i.e. they stay in the Rayleigh-Ritz basis but do not contribute
+     search directions anymore.
+   */
+  class NGS_DLL_HEADER LOBPCGSolver
+  {
+    shared_ptr<BaseMatrix> a;
+    shared_ptr<BaseMatrix> m;
+    shared_ptr<BaseMatrix> pre;
+    int maxsteps = 100;
+    double tol = 1e-8;
+    bool printrates = false;
+    int steps = 0;
+  public:
+    LOBPCGSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> am,
+                  shared_ptr<BaseMatrix> apre = nullptr)
+      : a(aa), m(am), pre(apre) { ; }
+
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
+    void SetTolerance (double atol) { tol = atol; }
+    void SetPrintRates (bool aprint) { printrates = aprint; }
+    int GetSteps () const { return steps; }
+
+    /// x is the initial guess and returns the eigenvectors, x.Size() eigenvalues are computed
+    Vector<double> Solve (MultiVector & x);
+  };
+
+
+  /**
+     Thick-restart Krylov-Schur method for the symmetric generalized evp
+
+     A x = lam M x
+
+     applied to the shift-and-invert operator (A-shift*M)^(-1) M, which is
+     symmetric in the M-inner product. Thus the Schur form is diagonal and the
+     method coincides with the thick-restart Lanczos method.
+     Computes the eigenvalues closest to the shift.
+   */
+  class NGS_DLL_HEADER KrylovSchurSolver
+  {
+    shared_ptr<BaseMatrix> a;
+    shared_ptr<BaseMatrix> m;
+    shared_ptr<BitArray> freedofs;
+    double shift = 0;
+    optional<string> inversetype;
+    int ncv = 0;
+    int maxsteps = 100;
+    double tol = 1e-10;
+    bool printrates = false;
+    int steps = 0;
+  public:
+    KrylovSchurSolver (shared_ptr<BaseMatrix> aa, shared_ptr<BaseMatrix> am,
+                       shared_ptr<BitArray> afreedofs = nullptr)
+      : a(aa), m(am), freedofs(afreedofs) { ; }
+
+    void SetShift (double ashift) { shift = ashift; }
+    void SetInverseType (optional<string> ainv) { inversetype = ainv; }
+    /// dimension of the Krylov space, default is max(2*nev+1, nev+20)
+    void SetNumKrylovVectors (int ancv) { ncv = ancv; }
+    /// maximal number of restarts
+    void SetMaxSteps (int amaxsteps) { maxsteps = amaxsteps; }
+    void SetTolerance (double atol) { tol = atol; }
+    void SetPrintRates (bool aprint) { printrates = aprint; }
+    int GetSteps () const { return steps; }
+
+    /// computes evecs.Size() eigenpairs, eigenvalues are sorted ascending
+    Vector<double> Solve (MultiVector & evecs);
+  };
+
+}
+
+#endif
@@ -47,5 +47,6 @@ namespace ngla
 #include "chebyshev.hpp"
 #include "eigen.hpp"
 #include "arnoldi.hpp"
+#include "eigensolvers.hpp"
 
 #endif
@@ -1030,6 +1030,7 @@ freedofs : BitArray
 inverse : string
   Solver to use, allowed values are:
     sparsecholesky - internal solver of NGSolve for symmetric matrices
+    sparselu       - internal solver of NGSolve for non-symmetric and indefinite matrices
     umfpack        - solver by Suitesparse/UMFPACK (if NGSolve was configured with USE_UMFPACK=ON)
     pardiso        - PARDISO, either provided by libpardiso (USE_PARDISO=ON) or Intel MKL (USE_MKL=ON).
                      If neither Pardiso nor Intel MKL was linked at compile-time, NGSolve will look
@@ -1426,6 +1427,19 @@ inverse : string
   py::class_<SparseCholesky<Complex>, shared_ptr<SparseCholesky<Complex>>, SparseFactorization> (m, "SparseCholesky_c")
     .def(NGSPickle<SparseCholesky<Complex>>())
     ;
+
+  py::class_<SparseLU<double>, shared_ptr<SparseLU<double>>, SparseFactorization> (m, "SparseLU_d")
+    .def_property_readonly("nperturbed", &SparseLU<double>::GetNumPerturbedPivots,
+                           "number of tiny pivots replaced by static pivoting")
+    .def("SetRefinement", &SparseLU<double>::SetRefinement, py::arg("steps")=3, py::arg("tol")=1e-12,
+         "maximal number of iterative refinement steps and relative residual tolerance")
+    ;
+  py::class_<SparseLU<Complex>, shared_ptr<SparseLU<Complex>>, SparseFactorization> (m, "SparseLU_c")
+    .def_property_readonly("nperturbed", &SparseLU<Complex>::GetNumPerturbedPivots,
+                           "number of tiny pivots replaced by static pivoting")
+    .def("SetRefinement", &SparseLU<Complex>::SetRefinement, py::arg("steps")=3, py::arg("tol")=1e-12,
+         "maximal number of iterative refinement steps and relative residual tolerance")
+    ;
   
   py::class_<Projector, shared_ptr<Projector>, BaseMatrix> (m, "Projector")
     .def(py::init<shared_ptr<BitArray>,bool>(),
@@ -1765,8 +1779,235 @@ vecs : list
 shift : object
   complex or real shift
 )raw_string"));
-  
-  
+
+  py::class_<ShiftedInverseCache, shared_ptr<ShiftedInverseCache>>
+    (m, "ShiftedInverseCache", "factorizations of A-shift*M for several shifts, kept for reuse")
+    .def(py::init<shared_ptr<BaseMatrix>, shared_ptr<BaseMatrix>, shared_ptr<BitArray>, optional<string>>(),
+         py::arg("mata"), py::arg("matm"), py::arg("freedofs")=nullptr, py::arg("inverse")=nullopt)
+    .def("Prepare", [](ShiftedInverseCache & self, std::vector<Complex> shifts)
+         {
+           self.Prepare (ArrayFromVector (shifts));
+         }, py::arg("shifts"), py::call_guard<py::gil_scoped_release>(),
+         "factorize for all shifts which are not in the cache yet, in parallel")
+    .def("Inverse", &ShiftedInverseCache::GetInverse, py::arg("shift"),
+         py::call_guard<py::gil_scoped_release>())
+    .def("Clear", &ShiftedInverseCache::Clear)
+    .def("__len__", &ShiftedInverseCache::Size)
+    ;
+
+  m.def("RationalArnoldiSolver", [](shared_ptr<BaseMatrix> mata, shared_ptr<BaseMatrix> matm,
+                                    shared_ptr<BitArray> freedofs,
+                                    py::list vecs, std::vector<Complex> shifts, int numval,
+                                    optional<string> inverse,
+                                    shared_ptr<ShiftedInverseCache> cache)
+        {
+          int nev;
+          {
+            py::gil_scoped_acquire acq;
+            nev = py::len(vecs);
+          }
+          if (numval == 0)
+            numval = 2*nev + 10*shifts.size();
+          if (!cache)
+            cache = make_shared<ShiftedInverseCache> (mata, matm, freedofs, inverse);
+
+          Array<Complex> lam;
+          Array<shared_ptr<BaseVector>> evecs;
+          if (mata->IsComplex())
+            {
+              Arnoldi<Complex> arnoldi (mata, matm, freedofs);
+              arnoldi.SetShifts (ArrayFromVector (shifts));
+              arnoldi.SetInverseCache (cache);
+              arnoldi.CalcRational (numval, lam, nev, evecs);
+            }
+          else
+            {
+              Array<double> rshifts;
+              for (auto s : shifts)
+                {
+                  if (s.imag())
+                    throw Exception("Only real shifts allowed for real arnoldi");
+                  rshifts.Append (s.real());
+                }
+              Arnoldi<double> arnoldi (mata, matm, freedofs);
+              arnoldi.SetShifts (rshifts);
+              arnoldi.SetInverseCache (cache);
+              arnoldi.CalcRational (numval, lam, nev, evecs);
+            }
+
+          {
+            py::gil_scoped_acquire acq;
+            for (int i = 0; i < min2(nev, int(evecs.Size())); i++)
+              vecs[i].cast<BaseVector&>() = *evecs[i];
+          }
+          Vector<Complex> vlam(min2(nev, int(lam.Size())));
+          for (int i = 0; i < vlam.Size(); i++)
+            vlam(i) = lam[i];
+          return vlam;
+        },
+        py::arg("mata"), py::arg("matm"), py::arg("freedofs"), py::arg("vecs"), py::arg("shifts"),
+        py::arg("numval")=0, py::arg("inverse")=nullopt, py::arg("cache")=nullptr,
+        py::call_guard<py::gil_scoped_release>(),
+        docu_string(R"raw_string(
+Rational Krylov eigenvalue solver with several shifts
+
+Solves the generalized linear EVP A*u = M*lam*u. The Krylov space is extended
+cyclically by (A-shift_i*M)^(-1)*M for all shifts. The factorizations are computed
+in parallel and kept in the cache, pass the same cache to later calls (e.g. in a
+frequency sweep) to reuse them.
+len(vecs) eigenpairs with eigenvalues closest to any of the shifts are returned.
+
+Parameters:
+
+mata : ngsolve.la.BaseMatrix
+  matrix A
+
+matm : ngsolve.la.BaseMatrix
+  matrix M
+
+freedofs : nsolve.ngstd.BitArray
+  correct degrees of freedom
+
+vecs : list
+  list of BaseVectors for writing eigenvectors
+
+shifts : list
+  complex or real shifts
+
+numval : int
+  dimension of the Krylov space, default is 2*len(vecs)+10*len(shifts)
+
+inverse : str
+  inverse type for the factorizations
+
+cache : ngsolve.la.ShiftedInverseCache
+  factorizations of A-shift*M, created if not given
+)raw_string"));
+
+  m.def("LOBPCG", [](shared_ptr<BaseMatrix> mata, shared_ptr<BaseMatrix> matm,
+                     shared_ptr<BaseMatrix> pre, int num, int maxit, double tol,
+                     bool printrates, shared_ptr<MultiVector> initial)
+        {
+          LOBPCGSolver solver(mata, matm, pre);
+          solver.SetMaxSteps (maxit);
+          solver.SetTolerance (tol);
+          solver.SetPrintRates (printrates);
+
+          shared_ptr<MultiVector> evecs = shared_ptr<BaseVector>(mata->CreateColVector())->CreateMultiVector(num);
+          if (initial)
+            *evecs = *initial;
+          else
+            for (size_t i = 0; i < evecs->Size(); i++)
+              {
+                auto hv = (*evecs)[i]->CreateVector();
+                hv.SetRandom();
+                if (pre)
+                  *(*evecs)[i] = *pre * *hv;
+                else
+                  *(*evecs)[i] = *hv;
+              }
+          Vector<double> lam = solver.Solve (*evecs);
+          return tuple(lam, evecs);
+        },
+        py::arg("mata"), py::arg("matm"), py::arg("pre")=nullptr, py::arg("num")=1,
+        py::arg("maxit")=100, py::arg("tol")=1e-8, py::arg("printrates")=false,
+        py::arg("initial")=nullptr,
+        py::call_guard<py::gil_scoped_release>(),
+        docu_string(R"raw_string(
+Locally optimal block preconditioned conjugate gradient method with soft locking.
+
+Computes the num smallest eigenpairs of the symmetric EVP A*u = lam*M*u.
+Returns the eigenvalues and a MultiVector of M-orthonormal eigenvectors.
+
+Parameters:
+
+mata : ngsolve.la.BaseMatrix
+  matrix A
+
+matm : ngsolve.la.BaseMatrix
+  matrix M, symmetric positive definite
+
+pre : ngsolve.la.BaseMatrix
+  preconditioner for A, must vanish on Dirichlet dofs
+
+num : int
+  number of eigenpairs
+
+maxit : int
+  maximal number of iterations
+
+tol : float
+  relative residual |Au-lam*Mu| / (|lam| |Mu|) for convergence
+
+printrates : bool
+  print residuals and eigenvalues
+
+initial : ngsolve.la.MultiVector
+  initial guess of num vectors, default is pre applied to random vectors
+)raw_string"));
+
+  m.def("KrylovSchur", [](shared_ptr<BaseMatrix> mata, shared_ptr<BaseMatrix> matm,
+                          shared_ptr<BitArray> freedofs, int num, double shift,
+                          int ncv, int maxit, double tol,
+                          optional<string> inverse, bool printrates)
+        {
+          KrylovSchurSolver solver(mata, matm, freedofs);
+          solver.SetShift (shift);
+          solver.SetInverseType (inverse);
+          solver.SetNumKrylovVectors (ncv);
+          solver.SetMaxSteps (maxit);
+          solver.SetTolerance (tol);
+          solver.SetPrintRates (printrates);
+
+          shared_ptr<MultiVector> evecs = shared_ptr<BaseVector>(mata->CreateColVector())->CreateMultiVector(num);
+          Vector<double> lam = solver.Solve (*evecs);
+          return tuple(lam, evecs);
+        },
+        py::arg("mata"), py::arg("matm"), py::arg("freedofs")=nullptr, py::arg("num")=1,
+        py::arg("shift")=0.0, py::arg("ncv")=0, py::arg("maxit")=100, py::arg("tol")=1e-10,
+        py::arg("inverse")=nullopt, py::arg("printrates")=false,
+        py::call_guard<py::gil_scoped_release>(),
+        docu_string(R"raw_string(
+Thick-restart Krylov-Schur eigenvalue solver for symmetric problems
+
+Solves the generalized EVP A*u = lam*M*u by restarted Krylov iterations for the
+shift-and-invert operator (A-shift*M)^(-1)*M. The num eigenpairs closest to the
+shift are returned as eigenvalues (sorted ascending) and a MultiVector of
+M-orthonormal eigenvectors.
+
+Parameters:
+
+mata : ngsolve.la.BaseMatrix
+  matrix A
+
+matm : ngsolve.la.BaseMatrix
+  matrix M, symmetric positive definite
+
+freedofs : nsolve.ngstd.BitArray
+  correct degrees of freedom
+
+num : int
+  number of eigenpairs
+
+shift : float
+  real shift
+
+ncv : int
+  dimension of the Krylov space, default is max(2*num+1, num+20)
+
+maxit : int
+  maximal number of restarts
+
+tol : float
+  relative accuracy of the eigenvalues of the shifted operator
+
+inverse : str
+  inverse type for the factorization of A-shift*M
+
+printrates : bool
+  print number of converged eigenpairs after every restart
+)raw_string"));
+
 
   m.def("DoArchive" , [](shared_ptr<Archive> & arch, BaseMatrix & mat)
                                          { cout << "output basematrix" << endl;
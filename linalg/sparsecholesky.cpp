@@ -12,6 +12,12 @@
 #include <core/concurrentqueue.h>
 #include <core/taskmanager.hpp>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 typedef moodycamel::ConcurrentQueue<int> TQueue; 
 typedef moodycamel::ProducerToken TPToken; 
@@ -23,6 +29,108 @@ namespace ngla
   
   static TQueue queue;
 
+  string sparsecholesky_scratchdir = "";
+  size_t sparsecholesky_outofcore_threshold = 0;
+
+  
+#ifndef WIN32
+  static size_t PageSize ()
+  {
+    static size_t pagesize = sysconf(_SC_PAGESIZE);
+    return pagesize;
+  }
+
+  MappedScratchFile :: MappedScratchFile (string dir, size_t abytes)
+    : bytes(abytes)
+  {
+    string name = dir + "/ngs_factor_XXXXXX";
+    fd = mkstemp (&name[0]);
+    if (fd == -1)
+      throw Exception ("MappedScratchFile: cannot create scratch file in " + dir);
+    unlink (name.c_str());    // file is removed when closed
+
+    if (ftruncate (fd, max2(bytes, size_t(1))) != 0)
+      {
+        close (fd);
+        throw Exception ("MappedScratchFile: cannot allocate " + ToString(bytes) + " bytes in " + dir);
+      }
+    ptr = mmap (nullptr, max2(bytes, size_t(1)), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED)
+      {
+        close (fd);
+        throw Exception ("MappedScratchFile: mmap failed");
+      }
+  }
+
+  MappedScratchFile :: ~MappedScratchFile ()
+  {
+    munmap (ptr, max2(bytes, size_t(1)));
+    close (fd);
+  }
+
+  void MappedScratchFile :: SetZero ()
+  {
+    // truncating punches out the content, the mapping stays valid
+    madvise (ptr, bytes, MADV_DONTNEED);
+    if (ftruncate (fd, 0) != 0 || ftruncate (fd, max2(bytes, size_t(1))) != 0)
+      throw Exception ("MappedScratchFile: resetting file failed");
+  }
+
+  void MappedScratchFile :: Release (size_t first, size_t next) const
+  {
+    // only pages completely inside the range
+    size_t ps = PageSize();
+    size_t begin = (first+ps-1) / ps * ps;
+    size_t end = next / ps * ps;
+    if (end <= begin) return;
+
+    char * base = static_cast<char*> (ptr);
+    msync (base+begin, end-begin, MS_SYNC);
+    madvise (base+begin, end-begin, MADV_DONTNEED);
+#ifdef __linux__
+    posix_fadvise (fd, begin, end-begin, POSIX_FADV_DONTNEED);
+#endif
+  }
+
+  void MappedScratchFile :: Prefetch (size_t first, size_t next) const
+  {
+    size_t ps = PageSize();
+    size_t begin = first / ps * ps;
+    size_t end = min2 ((next+ps-1) / ps * ps, bytes);
+    if (end <= begin) return;
+    madvise (static_cast<char*>(ptr)+begin, end-begin, MADV_WILLNEED);
+  }
+
+  size_t MappedScratchFile :: ResidentBytes () const
+  {
+    size_t ps = PageSize();
+    size_t npages = (bytes+ps-1) / ps;
+#ifdef __APPLE__
+    Array<char> incore(npages);
+#else
+    Array<unsigned char> incore(npages);
+#endif
+    if (mincore (ptr, bytes, incore.Data()) != 0)
+      return bytes;
+    size_t cnt = 0;
+    for (auto c : incore)
+      if (c & 1) cnt++;
+    return min2 (cnt*ps, bytes);
+  }
+
+#else // WIN32
+
+  MappedScratchFile :: MappedScratchFile (string dir, size_t abytes)
+  {
+    throw Exception ("MappedScratchFile: out-of-core factorization not available on Windows");
+  }
+  MappedScratchFile :: ~MappedScratchFile () { ; }
+  void MappedScratchFile :: SetZero () { ; }
+  void MappedScratchFile :: Release (size_t first, size_t next) const { ; }
+  void MappedScratchFile :: Prefetch (size_t first, size_t next) const { ; }
+  size_t MappedScratchFile :: ResidentBytes () const { return 0; }
+#endif
+
 
   template <typename TFUNC>
   void RunParallelDependency (const Table<int> & dag,
@@ -143,7 +251,7 @@ namespace ngla
     GetMemoryTracer().SetName("SparseCholesky");
     GetMemoryTracer().Track(order, "order",
                             inv_order, "inv_order",
-                            lfact, "lfact",
+                            lfact.InMemoryArray(), "lfact",
                             firstinrow, "firstinrow",
                             diag, "diag",
                             rowindex2, "rowindex2",
@@ -262,13 +370,7 @@ namespace ngla
 
     diag.SetSize(nused);
     // lfact.SetSize (nze);
-    lfact = NumaInterleavedArray<TM> (nze);
-
-    // lfact = TM(0.0);     // first touch
-    ParallelForRange (nze, [&] (IntRange r)
-                      {
-                        lfact.Range(r) = TM(0.0);
-                      });
+    AllocateFactor();
     
     endtime = clock();
     if (printstat)
@@ -561,7 +663,7 @@ namespace ngla
 	cout << IM(4) << "SparseCholesky::FactorNew called with matrix of different size." << endl;
 	return;
       }
-    lfact = TM(0.0);
+    lfact.SetZero();
 
     if (!inner && !cluster)
       ParallelFor 
@@ -987,6 +1089,8 @@ namespace ngla
     size_t * hfirstinrow_ri = firstinrow_ri.Addr(0);
     int * hrowindex2 = rowindex2.Addr(0);
     TM * hlfact = lfact.Addr(0);
+    // out-of-core: rows are scaled and written out as soon as their block is done
+    bool scaled_in_blocks = false;
    
     // #define CHOLESKY_ORIGINAL
     // #define CHOLESKY_SIMPLE
@@ -1388,6 +1492,7 @@ namespace ngla
     static Timer tdep3("paralleldep3");
     */
     Array<MyMutex> locks(n);
+    scaled_in_blocks = lfact.IsOutOfCore();
     
     RunParallelDependency
       (block_dependency, block_dep_trans, [&] (int blocknr)
@@ -1497,6 +1602,17 @@ namespace ngla
             }, num_other > 50 ? TasksPerThread(1) : 1);  
           
         }
+
+        if (scaled_in_blocks)
+          {
+            for (auto i : block)
+              {
+                TM ai = diag[i];
+                for (auto j : Range(hfirstinrow[i], hfirstinrow[i+1]))
+                  hlfact[j] = hlfact[j] * ai;
+              }
+            this->ReleaseBlock (blocknr);
+          }
         
        });
 #endif
@@ -1516,12 +1632,13 @@ namespace ngla
           lfact[j] = lfact[j] * ai;
       }
     */
-    ParallelFor (n, [&] (size_t i)
-      {
-        TM ai = diag[i];
-        for (auto j : Range(hfirstinrow[i], hfirstinrow[i+1]))
-          lfact[j] = lfact[j] * ai;
-      }, TasksPerThread(5));
+    if (!scaled_in_blocks)
+      ParallelFor (n, [&] (size_t i)
+        {
+          TM ai = diag[i];
+          for (auto j : Range(hfirstinrow[i], hfirstinrow[i+1]))
+            lfact[j] = lfact[j] * ai;
+        }, TasksPerThread(5));
 
     if (n > 2000){
       cout << IM(4) << endl;
@@ -1675,7 +1792,7 @@ namespace ngla
 
   template <class TM, class TV_ROW, class TV_COL>
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
-  SolveReordered (FlatVector<TVX> hy) const
+  SolveReordered (FlatVector<TVX> hy, TM * lower, TM * upper) const
   {
     static Timer timer1("SparseCholesky<d,d,d>::MultAdd fac1");
     static Timer timer2("SparseCholesky<d,d,d>::MultAdd fac2");
@@ -1751,11 +1868,16 @@ namespace ngla
     */
     timer1.Start();
 
+    bool outofcore = lfact.IsOutOfCore();
+
     RunParallelDependency (micro_dependency, micro_dependency_trans,
                            [&,hy] (int nr) 
                            {
                              auto task = microtasks[nr];
                              size_t blocknr = task.blocknr;
+                             if (outofcore)
+                               for (int next : micro_dependency[nr])
+                                 this->PrefetchBlock (microtasks[next].blocknr);
                              auto range = BlockDofs (blocknr);
                              if (range.Size()==0) return;
                              
@@ -1774,7 +1896,7 @@ namespace ngla
                                      size_t size = range.end()-i-1;
                                      if (size > 0)
                                        {
-                                         FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                         FlatVector<TM> vlfact(size, &lower[firstinrow[i]]);
                                          
                                          auto hyr = hy.Range(i+1, range.end());
                                          for (size_t j = 0; j < size; j++)
@@ -1786,7 +1908,7 @@ namespace ngla
                                          continue;
                                        }
                                      size_t first = firstinrow[i] + range.end()-i-1;
-                                     FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                     FlatVector<TM> ext_lfact (extdofs.Size(), &lower[first]);
                                      for (size_t j = 0; j < temp.Size(); j++)
                                        temp(j) += Trans(ext_lfact(j)) * hyi;
                                    }
@@ -1802,7 +1924,7 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TM> vlfact(size, &lower[firstinrow[i]]);
 
                                      TVX hyi = hy(i);
                                      auto hyr = hy.Range(i+1, range.end());
@@ -1828,7 +1950,7 @@ namespace ngla
                                        {
                                          size_t first = firstinrow[i] + range.end()-i-1;
                                          
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lower[first]);
  
                                          TVX hyi = hy(i);
                                          for (size_t j = 0; j < temp.Size(); j++)
@@ -1868,6 +1990,9 @@ namespace ngla
                            {
                              auto task = microtasks[nr];
                              int blocknr = task.blocknr;
+                             if (outofcore)
+                               for (int next : micro_dependency_trans[nr])
+                                 this->PrefetchBlock (microtasks[next].blocknr);
                              auto range = BlockDofs (blocknr);
                              if (range.Size()==0) return;
                              
@@ -1884,7 +2009,7 @@ namespace ngla
                                    for (auto i : range)
                                      {
                                        size_t first = firstinrow[i] + range.end()-i-1;
-                                       FlatVector<TM> ext_lfact (extdofs.Size(), &lfact[first]);
+                                       FlatVector<TM> ext_lfact (extdofs.Size(), &upper[first]);
                                        
                                        TVX val(0.0);
                                        for (auto j : Range(extdofs))
@@ -1895,7 +2020,7 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TM> vlfact(size, &upper[firstinrow[i]]);
                                      auto hyr = hy.Range(i+1, range.end());
 
                                      TVX hyi = hy(i);
@@ -1913,7 +2038,7 @@ namespace ngla
                                    {
                                      size_t size = range.end()-i-1;
                                      if (size == 0) continue;
-                                     FlatVector<TM> vlfact(size, &lfact[firstinrow[i]]);
+                                     FlatVector<TM> vlfact(size, &upper[firstinrow[i]]);
                                      auto hyr = hy.Range(i+1, range.end());
 
                                      TVX hyi = hy(i);
@@ -1940,7 +2065,7 @@ namespace ngla
                                      for (auto i : range)
                                        {
                                          size_t first = firstinrow[i] + range.end()-i-1;
-                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &lfact[first]);
+                                         FlatVector<TM> ext_lfact (all_extdofs.Size(), &upper[first]);
     
                                          TVX val(0.0);
                                          for (auto j : Range(extdofs))
@@ -1949,6 +2074,10 @@ namespace ngla
                                        }
                                    }
                                }
+
+                             // the block is not needed anymore after its L-task
+                             if (outofcore && task.type != MicroTask::B_BLOCK)
+                               this->ReleaseBlock (blocknr);
                            });
 
     timer2.Stop();
@@ -2017,6 +2146,204 @@ namespace ngla
   
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const
+  {
+    if constexpr (!is_same<TM,TVX>::value || !(is_same<TM,double>::value || is_same<TM,Complex>::value))
+      {
+        BaseMatrix::MultAdd (alpha, x, y);
+      }
+    else
+      {
+        static Timer timer("SparseCholesky::MultAdd Multivec");
+        RegionTimer reg (timer);
+        size_t k = x.Size();
+        timer.AddFlops (2.0*k*lfact.Size());
+
+        Array<TM*> fx(k), fy(k);
+        for (size_t j = 0; j < k; j++)
+          {
+            fx[j] = x[j]->FV<TM>().Data();
+            fy[j] = y[j]->FV<TM>().Data();
+          }
+
+        Matrix<TM> hy(this->nused, k);
+        ParallelFor (Range(height), [&] (int i)
+                     {
+                       if (order[i] != -1)
+                         for (size_t j = 0; j < k; j++)
+                           hy(order[i], j) = fx[j][i];
+                     });
+
+        SolveReorderedMulti<TM> (hy);
+
+        ParallelFor (Range(height), [&] (int i)
+                     {
+                       if (order[i] != -1)
+                         for (size_t j = 0; j < k; j++)
+                           fy[j][i] += alpha(j) * hy(order[i], j);
+                     });
+      }
+  }
+
+
+  template <class TM, class TV_ROW, class TV_COL> template <typename T>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  SolveReorderedMulti (SliceMatrix<T> hy) const
+  {
+    static Timer timer1("SparseCholesky::MultAdd Multivec fac1");
+    static Timer timer2("SparseCholesky::MultAdd Multivec fac2");
+
+    size_t k = hy.Width();
+
+    // external part of the factor rows of the block, columns extrange
+    auto get_ext = [this] (IntRange range, size_t next, IntRange extrange, FlatMatrix<T> ext)
+      {
+        for (auto i : range)
+          {
+            size_t first = firstinrow[i] + range.end()-i-1;
+            ext.Row(i-range.First()) = FlatVector<T>(next, &lfact[first]).Range(extrange);
+          }
+      };
+
+    // unit lower triangular part of the block
+    auto solve_diag_block = [this] (IntRange range, SliceMatrix<T> hy)
+      {
+        for (auto i : range)
+          {
+            size_t size = range.end()-i-1;
+            FlatVector<T> vlfact(size, &lfact[firstinrow[i]]);
+            for (size_t j = 0; j < size; j++)
+              hy.Row(i+1+j) -= vlfact(j) * hy.Row(i);
+          }
+      };
+
+    auto solve_diag_blockT = [this] (IntRange range, SliceMatrix<T> hy)
+      {
+        if (range.Size() > 0)
+          for (size_t i = range.end()-1; i-- > range.begin(); )
+            {
+              size_t size = range.end()-i-1;
+              FlatVector<T> vlfact(size, &lfact[firstinrow[i]]);
+              for (size_t j = 0; j < size; j++)
+                hy.Row(i) -= vlfact(j) * hy.Row(i+1+j);
+            }
+      };
+
+    // forward: y_ext -= E^T y_block
+    auto update_ext = [&] (int blocknr, IntRange extrange)
+      {
+        auto range = BlockDofs (blocknr);
+        auto all_extdofs = BlockExtDofs (blocknr);
+        auto extdofs = all_extdofs.Range(extrange);
+        if (extdofs.Size() == 0) return;
+
+        ArrayMem<T,2000> extmem(range.Size()*extdofs.Size());
+        ArrayMem<T,2000> tempmem(extdofs.Size()*k);
+        FlatMatrix<T> ext(range.Size(), extdofs.Size(), extmem.Data());
+        FlatMatrix<T> temp(extdofs.Size(), k, tempmem.Data());
+
+        get_ext (range, all_extdofs.Size(), extrange, ext);
+        temp = Trans(ext) * hy.Rows(range);
+
+        for (size_t j : Range(extdofs))
+          for (size_t l = 0; l < k; l++)
+            AtomicAdd (hy(extdofs[j], l), -temp(j,l));
+      };
+
+    // backward: y_block -= E y_ext
+    auto update_block = [&] (int blocknr, IntRange extrange, bool atomic)
+      {
+        auto range = BlockDofs (blocknr);
+        auto all_extdofs = BlockExtDofs (blocknr);
+        auto extdofs = all_extdofs.Range(extrange);
+        if (extdofs.Size() == 0) return;
+
+        ArrayMem<T,2000> extmem(range.Size()*extdofs.Size());
+        ArrayMem<T,2000> tempmem(extdofs.Size()*k);
+        ArrayMem<T,2000> valmem(range.Size()*k);
+        FlatMatrix<T> ext(range.Size(), extdofs.Size(), extmem.Data());
+        FlatMatrix<T> temp(extdofs.Size(), k, tempmem.Data());
+        FlatMatrix<T> val(range.Size(), k, valmem.Data());
+
+        get_ext (range, all_extdofs.Size(), extrange, ext);
+        for (size_t j : Range(extdofs))
+          temp.Row(j) = hy.Row(extdofs[j]);
+        val = ext * temp;
+
+        if (atomic)
+          {
+            for (size_t i : Range(range))
+              for (size_t l = 0; l < k; l++)
+                AtomicAdd (hy(range.First()+i, l), -val(i,l));
+          }
+        else
+          hy.Rows(range) -= val;
+      };
+
+    bool outofcore = lfact.IsOutOfCore();
+
+    timer1.Start();
+    RunParallelDependency (micro_dependency, micro_dependency_trans,
+                           [&] (int nr)
+                           {
+                             auto task = microtasks[nr];
+                             if (outofcore)
+                               for (int next : micro_dependency[nr])
+                                 this->PrefetchBlock (microtasks[next].blocknr);
+                             auto range = BlockDofs (task.blocknr);
+                             if (range.Size()==0) return;
+                             size_t next = BlockExtDofs (task.blocknr).Size();
+
+                             if (task.type == MicroTask::LB_BLOCK)
+                               {
+                                 solve_diag_block (range, hy);
+                                 update_ext (task.blocknr, Range(next));
+                               }
+                             else if (task.type == MicroTask::L_BLOCK)
+                               solve_diag_block (range, hy);
+                             else
+                               update_ext (task.blocknr, Range(next).Split (task.bblock, task.nbblocks));
+                           });
+    timer1.Stop();
+
+    // solve with the diagonal
+    ParallelFor (hy.Height(), [&] (size_t i)
+                 {
+                   hy.Row(i) *= diag[i];
+                 });
+
+    timer2.Start();
+    RunParallelDependency (micro_dependency_trans, micro_dependency,
+                           [&] (int nr)
+                           {
+                             auto task = microtasks[nr];
+                             if (outofcore)
+                               for (int next : micro_dependency_trans[nr])
+                                 this->PrefetchBlock (microtasks[next].blocknr);
+                             auto range = BlockDofs (task.blocknr);
+                             if (range.Size()==0) return;
+                             size_t next = BlockExtDofs (task.blocknr).Size();
+
+                             if (task.type == MicroTask::LB_BLOCK)
+                               {
+                                 update_block (task.blocknr, Range(next), false);
+                                 solve_diag_blockT (range, hy);
+                               }
+                             else if (task.type == MicroTask::L_BLOCK)
+                               solve_diag_blockT (range, hy);
+                             else
+                               update_block (task.blocknr, Range(next).Split (task.bblock, task.nbblocks), true);
+
+                             if (outofcore && task.type != MicroTask::B_BLOCK)
+                               this->ReleaseBlock (task.blocknr);
+                           });
+    timer2.Stop();
+  }
+
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
   Smooth (BaseVector & u, const BaseVector & f, BaseVector & y) const
@@ -2224,6 +2551,49 @@ namespace ngla
   }
 
 
+  template <class TM>
+  SparseCholeskyTM<TM> ::
+  SparseCholeskyTM (const SparseCholeskyTM<TM> & symbolic,
+                    shared_ptr<const SparseMatrixTM<TM>> a)
+    : SparseFactorization (a, symbolic.inner, symbolic.cluster),
+      height(symbolic.height), nused(symbolic.nused), nze(symbolic.nze),
+      order(symbolic.order), inv_order(symbolic.inv_order),
+      firstinrow(symbolic.firstinrow),
+      rowindex2(symbolic.rowindex2), firstinrow_ri(symbolic.firstinrow_ri),
+      blocknrs(symbolic.blocknrs), blocks(symbolic.blocks),
+      block_dependency(symbolic.block_dependency),
+      microtasks(symbolic.microtasks), micro_dependency(symbolic.micro_dependency),
+      micro_dependency_trans(symbolic.micro_dependency_trans),
+      mdo(nullptr), maxrow(symbolic.maxrow)
+  {
+    static Timer t("SparseCholesky - numeric only");
+    RegionTimer reg(t);
+    diag.SetSize(nused);
+    AllocateFactor();
+    FactorNew(*a);
+  }
+
+  template <class TM>
+  void SparseCholeskyTM<TM> :: AllocateFactor ()
+  {
+    if (sparsecholesky_scratchdir != "" && nze*sizeof(TM) > sparsecholesky_outofcore_threshold)
+      {
+        cout << IM(3) << "SparseCholesky: factor of " << nze*sizeof(TM)
+             << " bytes out-of-core in " << sparsecholesky_scratchdir << endl;
+        lfact.Allocate (nze, sparsecholesky_scratchdir);   // file is zero
+      }
+    else
+      {
+        lfact.Allocate (nze);
+
+        // lfact = TM(0.0);     // first touch
+        ParallelForRange (nze, [&] (IntRange r)
+                          {
+                            lfact.Range(r) = TM(0.0);
+                          });
+      }
+  }
+
   template <class TM>
   SparseCholeskyTM<TM> :: ~SparseCholeskyTM()
   {
@@ -2233,6 +2603,475 @@ namespace ngla
 
 
 
+  template <class TM>
+  SparseLU<TM> :: SparseLU (shared_ptr<const SparseMatrix<TM>> a,
+                            shared_ptr<BitArray> ainner)
+  {
+    static Timer t("SparseLU - total");
+    static Timer tm("SparseLU - matching");
+    static Timer to("SparseLU - ordering");
+    RegionTimer reg(t);
+
+    this->matrix = a;
+    this->inner = ainner;
+    this->smooth_is_projection = true;
+    mdo = nullptr;
+    num_perturbed = 0;
+
+    int n = a->Height();
+    height = n;
+    auto is_used = [&] (int i) { return !inner || inner->Test(i); };
+
+    tm.Start();
+    ComputeRowMatching (*a);
+    tm.Stop();
+
+    // minimum degree ordering of the symmetrized pattern of P A
+    to.Start();
+    mdo = new MinimumDegreeOrdering (n);
+    for (int i = 0; i < n; i++)
+      if (!is_used(i))
+        mdo->SetUnusedVertex(i);
+
+    TableCreator<int> creator(n);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < n; i++)
+        if (is_used(i))
+          for (int col : a->GetRowIndices(rowperm[i]))
+            if (col != i && is_used(col))
+              creator.Add (max2(i,col), min2(i,col));
+    Table<int> graph = creator.MoveTable();
+
+    for (int i = 0; i < n; i++)
+      {
+        QuickSort (graph[i]);
+        for (int j : Range(graph[i]))
+          if (j == 0 || graph[i][j] != graph[i][j-1])
+            mdo->AddEdge (i, graph[i][j]);
+      }
+    mdo->Order();
+    nused = mdo->nused;
+    to.Stop();
+
+    this->Allocate (mdo->order,  mdo->vertices, mdo->blocknr.Data());
+    delete mdo;
+    mdo = nullptr;
+
+    diag.SetSize(nused);
+    lfact.Allocate (nze);
+    ufact.Allocate (nze);
+    ParallelForRange (nze, [&] (IntRange r)
+                      {
+                        lfact.Range(r) = TM(0.0);
+                        ufact.Range(r) = TM(0.0);
+                      });
+
+    FactorNew (*a);
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: ComputeRowMatching (const SparseMatrix<TM> & a)
+  {
+    int n = a.Height();
+    auto is_used = [&] (int i) { return !inner || inner->Test(i); };
+
+    // rowperm[col] is the row matched with column col
+    rowperm.SetSize(n);
+    rowperm = -1;
+    Array<int> matched_col(n);
+    matched_col = -1;
+
+    // keep the diagonal if it is not small compared to the row
+    ParallelFor (n, [&] (size_t i)
+                 {
+                   if (!is_used(i)) return;
+                   auto cols = a.GetRowIndices(i);
+                   auto vals = a.GetRowValues(i);
+                   double rowmax = 0, diagabs = 0;
+                   for (auto j : Range(cols))
+                     if (is_used(cols[j]))
+                       {
+                         double v = abs(vals[j]);
+                         rowmax = max2(rowmax, v);
+                         if (cols[j] == i) diagabs = v;
+                       }
+                   if (diagabs > 0 && diagabs >= 1e-2 * rowmax)
+                     {
+                       rowperm[i] = i;
+                       matched_col[i] = i;
+                     }
+                 });
+
+    // remaining rows by depth-first search for augmenting paths (MC21 with look-ahead)
+    Array<int> visited(n);
+    visited = -1;
+    Array<int> path, via, next;
+    size_t num_unmatched = 0, num_augmented = 0;
+
+    for (int root = 0; root < n; root++)
+      {
+        if (!is_used(root) || matched_col[root] != -1) continue;
+
+        path.SetSize0(); via.SetSize0(); next.SetSize0();
+        path.Append(root); via.Append(-1); next.Append(0);
+        int freecol = -1;
+
+        while (path.Size())
+          {
+            int r = path.Last();
+            auto cols = a.GetRowIndices(r);
+            auto vals = a.GetRowValues(r);
+
+            // look-ahead: largest entry in a free column
+            double best = 0;
+            for (auto j : Range(cols))
+              if (is_used(cols[j]) && rowperm[cols[j]] == -1 && abs(vals[j]) > best)
+                {
+                  best = abs(vals[j]);
+                  freecol = cols[j];
+                }
+            if (freecol != -1) break;
+
+            int j = next.Last();
+            while (j < cols.Size() && (!is_used(cols[j]) || visited[cols[j]] == root || abs(vals[j]) == 0))
+              j++;
+            next.Last() = j+1;
+
+            if (j >= cols.Size())
+              {
+                path.DeleteLast(); via.DeleteLast(); next.DeleteLast();
+                continue;
+              }
+
+            int c = cols[j];
+            visited[c] = root;
+            via.Last() = c;
+            path.Append(rowperm[c]); via.Append(-1); next.Append(0);
+          }
+
+        if (freecol == -1)
+          {
+            num_unmatched++;
+            continue;
+          }
+
+        // flip the matching along the path
+        int c = freecol;
+        for (int l = path.Size()-1; l >= 0; l--)
+          {
+            rowperm[c] = path[l];
+            matched_col[path[l]] = c;
+            if (l > 0) c = via[l-1];
+          }
+        num_augmented++;
+      }
+
+    if (num_unmatched)
+      {
+        cout << IM(3) << "SparseLU: matrix is structurally singular, "
+             << num_unmatched << " rows without matching" << endl;
+        int c = 0;
+        for (int r = 0; r < n; r++)
+          if (is_used(r) && matched_col[r] == -1)
+            {
+              while (!is_used(c) || rowperm[c] != -1) c++;
+              rowperm[c] = r;
+              matched_col[r] = c;
+            }
+      }
+
+    for (int i = 0; i < n; i++)
+      if (!is_used(i))
+        rowperm[i] = i;
+
+    cout << IM(5) << "SparseLU: " << num_augmented << " rows permuted by matching" << endl;
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: FactorNew (const SparseMatrix<TM> & a)
+  {
+    static Timer tf("SparseLU - fill factor");
+    tf.Start();
+    if (height != a.Height())
+      throw Exception ("SparseLU::FactorNew called with matrix of different size");
+
+    lfact = TM(0.0);
+    ufact = TM(0.0);
+    diag = TM(0.0);
+
+    double maxabs =
+      ParallelReduce (height,
+                      [&] (size_t i)
+                      {
+                        double rowmax = 0;
+                        if (order[i] != -1)
+                          for (auto j : Range(a.GetRowIndices(i)))
+                            if (order[a.GetRowIndices(i)[j]] != -1)
+                              rowmax = max2 (rowmax, double(abs(a.GetRowValues(i)[j])));
+                        return rowmax;
+                      },
+                      [] (double x, double y) { return max2(x,y); },
+                      0.0);
+    pivot_tol = sqrt(numeric_limits<double>::epsilon()) * maxabs;
+
+    // i < j goes to U, i > j to L
+    auto set = [&] (int i, int j, const TM & val)
+      {
+        if (i == j)
+          {
+            diag[i] = val;
+            return;
+          }
+        auto & fact = (i < j) ? ufact : lfact;
+        int row = min2(i,j), col = max2(i,j);
+        size_t first = firstinrow[row];
+        size_t first_ri = firstinrow_ri[row];
+        size_t last = firstinrow[row+1];
+        for ( ; first < last; first++, first_ri++)
+          if (rowindex2[first_ri] == col)
+            {
+              fact[first] = val;
+              return;
+            }
+        cerr << "SparseLU: position " << i << ", " << j << " not found" << endl;
+      };
+
+    ParallelFor (nused, [&] (size_t i)
+                 {
+                   int row = rowperm[inv_order[i]];
+                   auto cols = a.GetRowIndices(row);
+                   auto vals = a.GetRowValues(row);
+                   for (auto j : Range(cols))
+                     if (order[cols[j]] != -1)
+                       set (i, order[cols[j]], vals[j]);
+                 }, TasksPerThread(5));
+    tf.Stop();
+
+    FactorLU();
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: FactorLU ()
+  {
+    if (!task_manager)
+      {
+        RunWithTaskManager ([&] ()
+                            {
+                              FactorLU();
+                            });
+        return;
+      }
+
+    static Timer factor_timer("SparseLU::Factor");
+    RegionTimer reg (factor_timer);
+
+    size_t * hfirstinrow = firstinrow.Addr(0);
+    size_t * hfirstinrow_ri = firstinrow_ri.Addr(0);
+    int * hrowindex2 = rowindex2.Addr(0);
+    TM * hlfact = lfact.Addr(0);
+    TM * hufact = ufact.Addr(0);
+    TM * hdiag = diag.Addr(0);
+    double tol = pivot_tol;
+    num_perturbed = 0;
+
+    TableCreator<int> creator_trans(block_dependency.Size());
+    for ( ; !creator_trans.Done(); creator_trans++)
+      ParallelFor (block_dependency.Size(), [&] (int i)
+                   {
+                     for (int j : block_dependency[i])
+                       creator_trans.Add(j, i);
+                   });
+    auto block_dep_trans = creator_trans.MoveTable();
+
+    Array<MyMutex> locks(nused);
+
+    RunParallelDependency
+      (block_dependency, block_dep_trans, [&] (int blocknr)
+       {
+         IntRange block = BlockDofs(blocknr);
+         size_t i1 = block.First();
+         size_t mi = block.Size();
+         size_t nk = hfirstinrow[i1+1] - hfirstinrow[i1] + 1;
+
+         ArrayMem<TM,1000> tmpmem(nk*nk);
+         FlatMatrix<TM> tmp(nk, nk, tmpmem.Addr(0));
+         tmp = TM(0.0);
+
+         for (size_t j = 0; j < mi; j++)
+           {
+             tmp(j,j) = hdiag[i1+j];
+             tmp.Col(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]);
+             tmp.Row(j).Range(j+1,nk) = FlatVector<TM>(nk-j-1, hufact+hfirstinrow[i1+j]);
+           }
+
+         // dense LU of the block rows and columns, static pivots
+         for (size_t k = 0; k < mi; k++)
+           {
+             TM piv = tmp(k,k);
+             if (abs(piv) < tol)
+               {
+                 piv = (abs(piv) > 0) ? TM(tol/abs(piv) * piv) : TM(tol);
+                 num_perturbed++;
+               }
+             tmp(k,k) = piv;
+
+             auto colk = tmp.Col(k).Range(k+1,nk);
+             colk *= TM(1.0) / piv;
+             for (size_t j = k+1; j < mi; j++)
+               tmp.Col(j).Range(k+1,nk) -= tmp(k,j) * colk;
+             for (size_t i = k+1; i < mi; i++)
+               tmp.Row(i).Range(mi,nk) -= tmp(i,k) * tmp.Row(k).Range(mi,nk);
+           }
+
+         // Schur complement for the external dofs
+         if (mi < nk)
+           tmp.Rows(mi,nk).Cols(mi,nk) -= tmp.Rows(mi,nk).Cols(0,mi) * tmp.Rows(0,mi).Cols(mi,nk);
+
+         for (size_t j = 0; j < mi; j++)
+           {
+             TM invd = TM(1.0) / tmp(j,j);
+             hdiag[i1+j] = invd;
+             FlatVector<TM>(nk-j-1, hlfact+hfirstinrow[i1+j]) = tmp.Col(j).Range(j+1,nk);
+             FlatVector<TM>(nk-j-1, hufact+hfirstinrow[i1+j]) = invd * tmp.Row(j).Range(j+1,nk);
+           }
+
+         // merge into rows of external dofs
+         size_t ne = nk-mi;
+         size_t firsti_ri = hfirstinrow_ri[i1] + mi-1;
+
+         ParallelFor (ne, [=,&locks] (size_t j)
+           {
+             auto other_row = hrowindex2[firsti_ri+j];
+             locks[other_row].lock();
+
+             hdiag[other_row] += tmp(mi+j, mi+j);
+
+             size_t firstj = hfirstinrow[other_row];
+             size_t firstj_ri = hfirstinrow_ri[other_row];
+
+             for (size_t k = j+1; k < ne; k++)
+               {
+                 size_t kk = hrowindex2[firsti_ri+k];
+                 while (hrowindex2[firstj_ri] != kk)
+                   {
+                     firstj++;
+                     firstj_ri++;
+                   }
+
+                 hlfact[firstj] += tmp(mi+k, mi+j);
+                 hufact[firstj] += tmp(mi+j, mi+k);
+                 firstj++;
+                 firstj_ri++;
+               }
+             locks[other_row].unlock();
+           }, ne > 50 ? TasksPerThread(1) : 1);
+       });
+
+    if (num_perturbed)
+      cout << IM(3) << "SparseLU: " << num_perturbed << " tiny pivots perturbed" << endl;
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: SolveOnce (FlatVector<TM> b, FlatVector<TM> x, bool trans) const
+  {
+    Vector<TM> hy(nused);
+    x = TM(0.0);
+
+    // P A = L D U   and   A^T = (L D U)^T P
+    if (!trans)
+      {
+        ParallelFor (nused, [&] (size_t i) { hy(i) = b(rowperm[inv_order[i]]); });
+        this->SolveReordered (hy, lfact.Addr(0), ufact.Addr(0));
+        ParallelFor (nused, [&] (size_t i) { x(inv_order[i]) = hy(i); });
+      }
+    else
+      {
+        ParallelFor (nused, [&] (size_t i) { hy(i) = b(inv_order[i]); });
+        this->SolveReordered (hy, ufact.Addr(0), lfact.Addr(0));
+        ParallelFor (nused, [&] (size_t i) { x(rowperm[inv_order[i]]) = hy(i); });
+      }
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: Solve (FlatVector<TM> b, FlatVector<TM> x, bool trans) const
+  {
+    SolveOnce (b, x, trans);
+    if (max_refinement == 0) return;
+
+    static Timer t("SparseLU - iterative refinement");
+    RegionTimer reg(t);
+
+    auto mat = this->matrix.lock();
+    if (!mat)
+      throw Exception("A matrix not available any more, needed for iterative refinement!");
+
+    Vector<TM> res(height), w(height);
+    VFlatVector<TM> vx(x), vres(res);
+
+    double normb = 0;
+    for (int i = 0; i < height; i++)
+      if (order[i] != -1)
+        normb += L2Norm2 (b(i));
+    normb = sqrt(normb);
+
+    for (int step = 0; step < max_refinement; step++)
+      {
+        res = b;
+        if (trans)
+          mat->MultTransAdd (-1, vx, vres);
+        else
+          mat->MultAdd (-1, vx, vres);
+
+        double normr = 0;
+        for (int i = 0; i < height; i++)
+          {
+            if (order[i] == -1)
+              res(i) = TM(0.0);
+            else
+              normr += L2Norm2 (res(i));
+          }
+        normr = sqrt(normr);
+        if (normr <= refinement_tol * normb) break;
+
+        SolveOnce (res, w, trans);
+        x += w;
+      }
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer timer("SparseLU::MultAdd");
+    RegionTimer reg (timer);
+    timer.AddFlops (4.0*nze);
+
+    Vector<TM> sol(height);
+    Solve (x.FV<TM>(), sol, false);
+    y.FV<TM>() += s * sol;
+  }
+
+
+  template <class TM>
+  void SparseLU<TM> :: MultTransAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer timer("SparseLU::MultTransAdd");
+    RegionTimer reg (timer);
+    timer.AddFlops (4.0*nze);
+
+    Vector<TM> sol(height);
+    Solve (x.FV<TM>(), sol, true);
+    y.FV<TM>() += s * sol;
+  }
+
+
+
+
   static RegisterClassForArchive<SparseCholesky<double>, SparseCholeskyTM<double>> regscd;
   static RegisterClassForArchive<SparseCholesky<Complex>, SparseCholeskyTM<Complex>> regscc;
 
@@ -2241,6 +3080,9 @@ namespace ngla
   template class SparseCholesky<Complex>;
   template class SparseCholesky<double, Complex, Complex>;
 
+  template class SparseLU<double>;
+  template class SparseLU<Complex>;
+
   template class SparseCholeskyTM<double>;
   template class SparseCholeskyTM<Complex>;
 
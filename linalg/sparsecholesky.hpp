@@ -14,6 +14,103 @@
 namespace ngla
 {
 
+  /// if not empty, SparseCholesky factors larger than the threshold (in bytes) go to a scratch file in this directory
+  NGS_DLL_HEADER extern string sparsecholesky_scratchdir;
+  NGS_DLL_HEADER extern size_t sparsecholesky_outofcore_threshold;
+
+
+  /// scratch file mapped into memory, removed when closed
+  class NGS_DLL_HEADER MappedScratchFile
+  {
+    int fd = -1;
+    void * ptr = nullptr;
+    size_t bytes = 0;
+  public:
+    MappedScratchFile (string dir, size_t abytes);
+    ~MappedScratchFile ();
+    void * Data () const { return ptr; }
+    size_t Size () const { return bytes; }
+    /// drop the content without writing it
+    void SetZero ();
+    /// write the pages in the byte range to disk and drop them from memory
+    void Release (size_t first, size_t next) const;
+    /// start reading the pages in the byte range
+    void Prefetch (size_t first, size_t next) const;
+    size_t ResidentBytes () const;
+  };
+
+
+  /*
+    Storage of factor entries, either in memory, or in a mapped
+    scratch file (out-of-core). Out-of-core, finished parts are
+    released from memory and prefetched again for the solve.
+  */
+  template <typename T>
+  class FactorStorage : public FlatArray<T,size_t>
+  {
+    NumaInterleavedArray<T> mem;
+    unique_ptr<MappedScratchFile> file;
+  public:
+    FactorStorage () : FlatArray<T,size_t> (0, nullptr) { ; }
+    using FlatArray<T,size_t>::operator=;
+
+    void Allocate (size_t n, string scratchdir = "")
+    {
+      file.reset();
+      if (scratchdir == "")
+        {
+          mem = NumaInterleavedArray<T> (n);
+          this->data = mem.Data();
+        }
+      else
+        {
+          mem = NumaInterleavedArray<T> (0);
+          file = make_unique<MappedScratchFile> (scratchdir, n*sizeof(T));
+          this->data = static_cast<T*> (file->Data());
+        }
+      this->size = n;
+    }
+
+    bool IsOutOfCore () const { return bool(file); }
+    void SetZero ()
+    {
+      if (file)
+        file->SetZero();
+      else
+        FlatArray<T,size_t>::operator= (T(0.0));
+    }
+    void Release (size_t first, size_t next) const
+    { if (file) file->Release (first*sizeof(T), next*sizeof(T)); }
+    void Prefetch (size_t first, size_t next) const
+    { if (file) file->Prefetch (first*sizeof(T), next*sizeof(T)); }
+
+    size_t ResidentBytes () const { return file ? file->ResidentBytes() : this->Size()*sizeof(T); }
+    size_t DiskBytes () const { return file ? file->Size() : 0; }
+    NumaInterleavedArray<T> & InMemoryArray () { return mem; }
+
+    void DoArchive (Archive & ar)
+    {
+      if (ar.Output() && file)
+        {
+          NumaInterleavedArray<T> hmem(this->Size());
+          for (size_t i = 0; i < this->Size(); i++)
+            hmem[i] = (*this)[i];
+          ar & hmem;
+        }
+      else
+        {
+          ar & mem;
+          if (ar.Input())
+            {
+              file.reset();
+              this->data = mem.Data();
+              this->size = mem.Size();
+            }
+        }
+    }
+  };
+
+
   class NGS_DLL_HEADER SparseFactorization : public BaseMatrix
   { 
   protected:
@@ -41,6 +138,19 @@ namespace ngla
     
     auto GetAMatrix() const { return matrix.lock(); }
     virtual bool SupportsUpdate() const { return false; } 
+
+    /// factorization of a matrix with the same non-zero pattern, reusing
+    /// ordering and symbolic factorization. nullptr if not supported
+    virtual shared_ptr<SparseFactorization> CreateSameStructure (shared_ptr<const BaseSparseMatrix> amatrix) const
+    { return nullptr; }
+
+  protected:
+    /// amatrix has the non-zero pattern of the factorized matrix
+    bool SameGraph (const BaseSparseMatrix & amatrix) const
+    {
+      auto mat = GetAMatrix();
+      return mat && mat->SameGraph (amatrix);
+    }
   };
 
 
@@ -78,7 +188,7 @@ namespace ngla
     
     // L-factor in compressed storage
     // Array<TM, size_t> lfact;
-    NumaInterleavedArray<TM> lfact;
+    FactorStorage<TM> lfact;
 
     // index-array to lfact
     Array<size_t> firstinrow;
@@ -140,6 +250,9 @@ namespace ngla
                       shared_ptr<BitArray> ainner = nullptr,
                       shared_ptr<const Array<int>> acluster = nullptr,
                       bool allow_refactor = 0);
+    /// numeric factorization of a, the pattern is the one of symbolic
+    SparseCholeskyTM (const SparseCholeskyTM<TM> & symbolic,
+                      shared_ptr<const SparseMatrixTM<TM>> a);
     SparseCholeskyTM() {}
     ///
     virtual ~SparseCholeskyTM ();
@@ -155,6 +268,8 @@ namespace ngla
     void DoArchive(Archive& ar) override;
     ///
     void Factor (); 
+    /// allocates and zeros lfact, out-of-core if requested
+    void AllocateFactor ();
 #ifdef LAPACK
     void FactorSPD (); 
     template <typename T>
@@ -184,6 +299,9 @@ namespace ngla
 
     virtual Array<MemoryUsage> GetMemoryUsage () const override
     {
+      if (lfact.IsOutOfCore())
+        return { MemoryUsage ("SparseChol (resident)", lfact.ResidentBytes(), 1),
+                 MemoryUsage ("SparseChol (on disk)", lfact.DiskBytes(), 1) };
       return { MemoryUsage ("SparseChol", nze*sizeof(TM), 1) };
     }
 
@@ -208,6 +326,12 @@ namespace ngla
       auto ext_size =  firstinrow[range.First()+1]-firstinrow[range.First()] - range.Size()+1;
       return rowindex2.Range(base, base+ext_size);
     }
+
+    // out-of-core: read ahead the factor of block bnr, or drop it from memory
+    void PrefetchBlock (int bnr) const
+    { lfact.Prefetch (firstinrow[blocks[bnr]], firstinrow[blocks[bnr+1]]); }
+    void ReleaseBlock (int bnr) const
+    { lfact.Release (firstinrow[blocks[bnr]], firstinrow[blocks[bnr+1]]); }
   };
 
 
@@ -250,8 +374,18 @@ namespace ngla
 		    shared_ptr<const Array<int>> acluster = nullptr,
 		    bool allow_refactor = 0)
       : SparseCholeskyTM<TM> (a, ainner, acluster, allow_refactor) { ; }
+    SparseCholesky (const SparseCholesky & symbolic, shared_ptr<const SparseMatrixTM<TM>> a)
+      : SparseCholeskyTM<TM> (symbolic, a) { ; }
     SparseCholesky() {}
 
+    shared_ptr<SparseFactorization> CreateSameStructure (shared_ptr<const BaseSparseMatrix> amatrix) const override
+    {
+      auto castmatrix = dynamic_pointer_cast<const SparseMatrixTM<TM>> (amatrix);
+      if (!castmatrix || !this->SameGraph (*castmatrix))
+        return nullptr;
+      return make_shared<SparseCholesky> (*this, castmatrix);
+    }
+
     ///
     virtual ~SparseCholesky () { ; }
     
@@ -262,6 +396,8 @@ namespace ngla
     {
       MultAdd (s, x, y);
     }
+    /// all right hand sides pass the factor together
+    void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override;
 
     AutoVector CreateRowVector () const override { return make_unique<VVector<TV>> (height); }
     AutoVector CreateColVector () const override { return make_unique<VVector<TV>> (height); }
@@ -270,8 +406,104 @@ namespace ngla
 
     void SolveBlock (int i, FlatVector<TV> hy) const;
     void SolveBlockT (int i, FlatVector<TV> hy) const;
+  protected:
+    void SolveReordered(FlatVector<TVX> hy) const
+    { SolveReordered (hy, lfact.Addr(0), lfact.Addr(0)); }
+    // forward substitution with lower, diagonal, backward substitution with upper
+    void SolveReordered(FlatVector<TVX> hy, TM * lower, TM * upper) const;
+    // rows of hy are the dofs, columns the right hand sides
+    template <typename T>
+    void SolveReorderedMulti(SliceMatrix<T> hy) const;
+  };
+
+
+
+
+  /**
+     A sparse LU factorization for unsymmetric and indefinite matrices.
+
+     Rows are statically permuted by a matching which puts large entries
+     onto the diagonal, then the unknowns are reordered by the minimum
+     degree ordering of the symmetrized pattern.  The block structure
+     and the task dependency graph are shared with the Cholesky
+     factorization.  There is no dynamic pivoting: tiny pivots are
+     replaced by sqrt(eps) max|a_ij|, and the solution is improved by
+     iterative refinement.
+
+     computes P A = L D U,
+     L is stored column-wise in lfact, U row-wise in ufact
+  */
+  template<class TM>
+  class NGS_DLL_HEADER SparseLU : public SparseCholesky<TM>
+  {
+    typedef SparseCholesky<TM> BASE;
+    using BASE::height;
+    using BASE::nused;
+    using BASE::nze;
+    using BASE::inner;
+    using BASE::lfact;
+    using BASE::diag;
+    using BASE::order;
+    using BASE::inv_order;
+    using BASE::firstinrow;
+    using BASE::firstinrow_ri;
+    using BASE::rowindex2;
+    using BASE::block_dependency;
+    using BASE::mdo;
+    using BASE::BlockDofs;
+
+    // U-factor, same layout as lfact
+    FactorStorage<TM> ufact;
+    // row of A which becomes row i of the permuted matrix
+    Array<int> rowperm;
+    // pivots smaller are perturbed
+    double pivot_tol;
+    atomic<size_t> num_perturbed;
+    int max_refinement = 3;
+    double refinement_tol = 1e-12;
+
+  public:
+    typedef typename BASE::TSCAL_VEC TSCAL_VEC;
+
+    SparseLU (shared_ptr<const SparseMatrix<TM>> a,
+              shared_ptr<BitArray> ainner = nullptr);
+    virtual ~SparseLU () { ; }
+
+    void FactorNew (const SparseMatrix<TM> & a);
+
+    virtual void Update() override
+    {
+      auto castmatrix = dynamic_pointer_cast<const SparseMatrix<TM>>(this->matrix.lock());
+      FactorNew (*castmatrix);
+    }
+    // the row matching depends on the values
+    shared_ptr<SparseFactorization> CreateSameStructure (shared_ptr<const BaseSparseMatrix> amatrix) const override
+    { return nullptr; }
+
+    void MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const override;
+    void MultTransAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const override;
+    void MultAdd (FlatVector<double> alpha, const MultiVector & x, MultiVector & y) const override
+    { BaseMatrix::MultAdd (alpha, x, y); }
+
+    void Smooth (BaseVector & u, const BaseVector & f, BaseVector & y) const override
+    { SparseFactorization::Smooth (u, f, y); }
+
+    virtual Array<MemoryUsage> GetMemoryUsage () const override
+    {
+      return { MemoryUsage ("SparseLU", 2*nze*sizeof(TM), 1) };
+    }
+    virtual size_t NZE () const override { return 2*nze+nused; }
+
+    /// number of pivots replaced during the last factorization
+    size_t GetNumPerturbedPivots () const { return num_perturbed; }
+    void SetRefinement (int steps, double tol) { max_refinement = steps; refinement_tol = tol; }
+
   private:
-    void SolveReordered(FlatVector<TVX> hy) const;
+    void ComputeRowMatching (const SparseMatrix<TM> & a);
+    void FactorLU ();
+    // x = A^{-1} b, or A^{-T} b, including iterative refinement
+    void Solve (FlatVector<TM> b, FlatVector<TM> x, bool trans) const;
+    void SolveOnce (FlatVector<TM> b, FlatVector<TM> x, bool trans) const;
   };
 
 
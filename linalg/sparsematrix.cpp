@@ -1009,6 +1009,20 @@ namespace ngla
   }
   
 
+  bool MatrixGraph :: SameGraph (const MatrixGraph & graph) const
+  {
+    if (size != graph.size || width != graph.width || nze != graph.nze)
+      return false;
+    // shadow graphs share the arrays
+    if (firsti.Data() == graph.firsti.Data() && colnr.Data() == graph.colnr.Data())
+      return true;
+    for (size_t i = 0; i <= size_t(size); i++)
+      if (firsti[i] != graph.firsti[i]) return false;
+    for (size_t i = 0; i < nze; i++)
+      if (colnr[i] != graph.colnr[i]) return false;
+    return true;
+  }
+
   /// returns position of Element (i, j), exception for unused
   size_t MatrixGraph :: GetPosition (int i, int j) const
   {
@@ -1268,10 +1282,12 @@ namespace ngla
     else if (ainversetype == "masterinverse") SetInverseType ( MASTERINVERSE );
     else if (ainversetype == "sparsecholesky") SetInverseType ( SPARSECHOLESKY );
     else if (ainversetype == "umfpack")       SetInverseType ( UMFPACK );
+    else if (ainversetype == "sparselu")      SetInverseType ( SPARSELU );
+    else if (ainversetype == "agglomeratedinverse") SetInverseType ( AGGLOMERATEDINVERSE );
     else
       {
         throw Exception (ToString("undefined inverse ")+ainversetype+
-                         "\nallowed is: 'sparsecholesky', 'pardiso', 'pardisospd', 'mumps', 'masterinverse', 'umfpack'");
+                         "\nallowed is: 'sparsecholesky', 'pardiso', 'pardisospd', 'mumps', 'masterinverse', 'umfpack', 'sparselu', 'agglomeratedinverse'");
       }
     return old_invtype;
   }
@@ -1938,6 +1954,8 @@ namespace ngla
 	throw Exception ("SparseMatrix::InverseMatrix:  UmfpackInverse not available");
 #endif
       }
+    else if ( BaseSparseMatrix :: GetInverseType()  == SPARSELU )
+      throw Exception ("SparseMatrix::InverseMatrix:  SparseLU needs non-symmetric storage");
     else if ( BaseSparseMatrix :: GetInverseType()  == MUMPS )
       {
 #ifdef USE_MUMPS
@@ -1979,6 +1997,8 @@ namespace ngla
 	throw Exception ("SparseMatrix::InverseMatrix:  UmfpackInverse not available");
 #endif
       }
+    else if ( BaseSparseMatrix :: GetInverseType()  == SPARSELU )
+      throw Exception ("SparseMatrix::InverseMatrix:  SparseLU needs non-symmetric storage");
     else if (  BaseSparseMatrix :: GetInverseType()  == MUMPS )
       {
 #ifdef USE_MUMPS
@@ -1999,7 +2019,11 @@ namespace ngla
     // BaseMatrix::MultAdd (alpha, x, y);
 
     static Timer t("SparseMatrix::MultAdd Multivec"); RegionTimer reg(t);
-    t.AddFlops (this->NZE()*x.Size());
+    size_t nvec = x.Size();
+    if (nvec == 0) return;
+    // matrix is streamed once for all vectors
+    AddWork (t, nvec*MultFlops(),
+             MultBytes() + (nvec-1) * (this->Width()+2*this->Height()) * sizeof(double));
 
     /*
     task_manager -> CreateJob
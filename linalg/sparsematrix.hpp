@@ -144,6 +144,9 @@ namespace ngla
     size_t First (int i) const { return firsti[i]; }
     FlatArray<size_t> GetFirstArray () const  { return firsti; } 
 
+    /// same row pointers and column indices
+    bool SameGraph (const MatrixGraph & graph) const;
+
     void FindSameNZE();
     void CalcBalancing ();
     const Partitioning & GetBalancing() const { return balance; } 
@@ -604,6 +607,23 @@ namespace ngla
     }
 
     virtual shared_ptr<BaseSparseMatrix> DeleteZeroElements(double tol) const override;
+
+    /// flops of one matrix-vector product, 2*nze for scalar entries (a multiply-add counts 2).
+    /// Timer flops of SpMV used to be nze, numbers are twice as large now
+    double MultFlops () const
+    {
+      typedef typename mat_traits<TVY>::TSCAL TTSCAL;
+      double fac = (is_same<TSCAL,Complex>::value ? 2 : 1) * (is_same<TTSCAL,Complex>::value ? 2 : 1);
+      return 2 * fac * mat_traits<TM>::HEIGHT * mat_traits<TM>::WIDTH * double(this->NZE());
+    }
+
+    /// minimal memory traffic of one matrix-vector product y += A x
+    double MultBytes () const
+    {
+      return double(this->NZE()) * (sizeof(TM)+sizeof(int))
+        + (this->Height()+1) * sizeof(size_t)
+        + this->Width() * sizeof(TVX) + 2 * this->Height() * sizeof(TVY);
+    }
     
     ///
     inline TVY RowTimesVector (int row, const FlatVector<TVX> vec) const
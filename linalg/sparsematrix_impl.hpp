@@ -155,7 +155,7 @@ namespace ngla
   MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
     static Timer t("SparseMatrix::MultAdd"); RegionTimer reg(t);
-    t.AddFlops (this->NZE()*sizeof(TV_ROW)*sizeof(TV_COL)/sqr(sizeof(double)));
+    AddWork (t, MultFlops(), MultBytes());
 
     ParallelForRange
       (balance, [&] (IntRange myrange)
@@ -243,7 +243,7 @@ namespace ngla
     for (int i = 0; i < this->Height(); i++)
       AddRowTransToVector (i, s*fx(i), fy);
 
-    timer.AddFlops (this->NZE());
+    AddWork (timer, MultFlops(), MultBytes());
   }
 
 
@@ -253,6 +253,7 @@ namespace ngla
   {
     static Timer timer("SparseMatrix::MultAdd Complex");
     RegionTimer reg (timer);
+    AddWork (timer, MultFlops(), MultBytes());
 
     FlatVector<TVX> fx = x.FV<TVX> (); //  (x.Size(), x.Memory());
     FlatVector<TVY> fy = y.FV<TVY> (); // (y.Size(), y.Memory());
@@ -269,6 +270,7 @@ namespace ngla
   {
     static Timer timer("SparseMatrix::MultTransAdd Complex");
     RegionTimer reg (timer);
+    AddWork (timer, MultFlops(), MultBytes());
 
     FlatVector<TVY> fx = x.FV<TVY>(); //  (x.Size(), x.Memory());
     FlatVector<TVX> fy = y.FV<TVX>(); // (y.Size(), y.Memory());
@@ -283,6 +285,7 @@ namespace ngla
   {
     static Timer timer("SparseMatrix::MultTransAdd Complex");
     RegionTimer reg (timer);
+    AddWork (timer, MultFlops(), MultBytes());
 
     FlatVector<TVY> fx = x.FV<TVY>(); //  (x.Size(), x.Memory());
     FlatVector<TVX> fy = y.FV<TVX>(); // (y.Size(), y.Memory());
@@ -354,6 +357,14 @@ namespace ngla
 	  throw Exception ("SparseMatrix::InverseMatrix:  UmfpackInverse not available");
 #endif
 	}
+      else if (  BaseSparseMatrix :: GetInverseType()  == SPARSELU)
+	{
+	  if constexpr (is_same<TM,TV_ROW>::value && is_same<TM,TV_COL>::value &&
+			(is_same<TM,double>::value || is_same<TM,Complex>::value))
+	    return make_shared<SparseLU<TM>> (dynamic_pointer_cast<const SparseMatrix<TM>>(this->shared_from_this()), subset);
+	  else
+	    throw Exception ("SparseMatrix::InverseMatrix:  SparseLU only available for scalar matrices");
+	}
       else if (  BaseSparseMatrix :: GetInverseType()  == MUMPS)
 	{
 #ifdef USE_MUMPS
@@ -423,6 +434,8 @@ namespace ngla
 	  throw Exception ("SparseMatrix::InverseMatrix:  UmfpackInverse not available");
 #endif
 	}
+      else if ( BaseSparseMatrix :: GetInverseType()  == SPARSELU )
+	throw Exception ("SparseMatrix::InverseMatrix:  SparseLU does not support clusters");
       else if ( BaseSparseMatrix :: GetInverseType()  == MUMPS )
 	{
 #ifdef USE_MUMPS
@@ -835,7 +848,8 @@ namespace ngla
   {
     static Timer timer("SparseMatrixSymmetric::MultAdd");
     RegionTimer reg (timer);
-    timer.AddFlops (2*this->nze);
+    // upper triangle is used twice, data is loaded once
+    AddWork (timer, 2*this->MultFlops(), this->MultBytes());
 
     const FlatVector<TV_ROW> fx = x.FV<TV_ROW>();
     FlatVector<TV_COL> fy = y.FV<TV_COL>();
@@ -30,7 +30,7 @@ namespace ngla
     {
       this->size = as;
       es = aes;
-      pdata = new TSCAL[as*aes];
+      pdata = AllocFirstTouch<TSCAL> (as*aes);
       ownmem = true;
       GetMemoryTracer().Alloc(sizeof(TSCAL) * as * aes);
       this->entrysize = es * sizeof(TSCAL) / sizeof(double);
@@ -41,10 +41,10 @@ namespace ngla
       if (ownmem)
         {
           GetMemoryTracer().Free(sizeof(TSCAL) * this->size * es);
-          delete [] pdata;
+          FreeFirstTouch (pdata);
         }
       this->size = as;
-      pdata = new TSCAL[as*es];
+      pdata = AllocFirstTouch<TSCAL> (as*es);
       ownmem = true;
       GetMemoryTracer().Alloc(sizeof(TSCAL) * as * es);
     }
@@ -155,6 +155,66 @@ namespace ngmg
 
 
 
+  ChebyshevJacobiSmoother :: 
+  ChebyshevJacobiSmoother  (const MeshAccess & ama,
+                            const BilinearForm & abiform, const Flags & aflags)
+    : Smoother(aflags), biform(abiform)
+  {
+    degree = int(flags.GetNumFlag ("chebyshevdegree", 3));
+    ratio = flags.GetNumFlag ("chebyshevratio", 30);
+    lanczos_steps = int(flags.GetNumFlag ("lanczossteps", 10));
+    Update();
+  }
+
+  void ChebyshevJacobiSmoother :: Update (bool force_update)
+  {
+    static Timer t("ChebyshevJacobiSmoother::Update"); RegionTimer reg(t);
+    cheby.SetSize (biform.GetNLevels());
+    for (int i = 0; i < biform.GetNLevels(); i++)
+      {
+        auto mat = biform.GetMatrixPtr(i);
+        if (!mat)
+          {
+            cheby[i] = nullptr;
+            continue;
+          }
+        auto dinv = CreateInverseDiagonal (dynamic_cast<const BaseSparseMatrix&> (*mat),
+                                           biform.GetFESpace()->GetFreeDofs());
+        cheby[i] = make_shared<ChebyshevSmoother> (mat, dinv, degree, ratio, lanczos_steps);
+        cout << IM(4) << "Chebyshev smoother level " << i << ", lmax = " << cheby[i]->GetLMax() << endl;
+      }
+  }
+
+  void ChebyshevJacobiSmoother :: PreSmooth (int level, BaseVector & u, 
+                                             const BaseVector & f, int steps) const
+  {
+    cheby[level]->Smooth (u, f, steps);
+  }
+
+  void ChebyshevJacobiSmoother :: PostSmooth (int level, BaseVector & u, 
+                                              const BaseVector & f, int steps) const
+  {
+    // the polynomial smoother is symmetric
+    cheby[level]->Smooth (u, f, steps);
+  }
+
+  void ChebyshevJacobiSmoother :: 
+  Residuum (int level, BaseVector & u, 
+	    const BaseVector & f, BaseVector & d) const
+  {
+    d = f - biform.GetMatrix(level) * u;
+  }
+  
+  AutoVector ChebyshevJacobiSmoother :: CreateVector(int level) const
+  {
+    return biform.GetMatrix(level).CreateColVector();
+  }
+
+
+
+
+
+
   AnisotropicSmoother :: 
   AnisotropicSmoother  (const MeshAccess & ama,
 			const BilinearForm & abiform)
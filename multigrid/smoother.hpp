@@ -227,6 +227,43 @@ namespace ngmg
 
 
 
+  /**
+     Chebyshev-Jacobi polynomial smoother.
+     Needs only matrix-vector products and diagonal scaling, no coloring.
+     The spectral bounds are estimated for every level.
+  */
+  class ChebyshevJacobiSmoother : public Smoother
+  {
+    ///
+    const BilinearForm & biform;
+    ///
+    Array<shared_ptr<ChebyshevSmoother>> cheby;
+    /// polynomial degree, damped part of the spectrum is [lmax/ratio, lmax]
+    int degree;
+    double ratio;
+    int lanczos_steps;
+  public:
+    ///
+    ChebyshevJacobiSmoother (const MeshAccess & ama,
+                             const BilinearForm & abiform, const Flags & aflags);
+    ///
+    virtual void Update (bool force_update = 0);
+    ///
+    virtual void PreSmooth (int level, ngla::BaseVector & u, 
+			    const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void PostSmooth (int level, ngla::BaseVector & u, 
+			     const ngla::BaseVector & f, int steps) const;
+    ///
+    virtual void Residuum (int level, ngla::BaseVector & u, 
+			   const ngla::BaseVector & f, ngla::BaseVector & d) const;
+    ///
+    virtual AutoVector CreateVector(int level) const;
+  };
+
+
+
+
 #ifdef XXX_OBSOLETE
   /**
      Matrix - vector multiplication by smoothing step.
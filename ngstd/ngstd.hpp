@@ -117,6 +117,8 @@ namespace ngstd
 #include "blockalloc.hpp"
 #include "autoptr.hpp"
 #include "memusage.hpp"
+#include "timerwork.hpp"
+#include "numa.hpp"
 
 #include "evalfunc.hpp"
 #include "sample_sort.hpp"
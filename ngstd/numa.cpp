@@ -0,0 +1,107 @@
+/**************************************************************************/
+/* File:   numa.cpp                                                       */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+#include <ngstd.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ngstd
+{
+  // cpu of worker thread i, set by PinThreads before the workers start
+  static Array<int> pin_cpus;
+  static Array<atomic<bool>> pinned;
+
+  // TaskManager startup function, runs in every worker thread when it starts
+  static void PinWorker ()
+  {
+#ifdef __linux__
+    int nr = TaskManager::GetThreadId();
+    // thread 0 is the main (Python) thread, it is left alone
+    if (nr <= 0 || nr >= pin_cpus.Size()) return;
+
+    cpu_set_t set;
+    CPU_ZERO (&set);
+    CPU_SET (pin_cpus[nr], &set);
+    if (pthread_setaffinity_np (pthread_self(), sizeof(set), &set) == 0)
+      pinned[nr] = true;
+#endif
+  }
+
+  // rank within the node and number of ranks on the node, collective over MPI_COMM_WORLD
+  static void NodeLocalRank (int & rank, int & size)
+  {
+    rank = 0;
+    size = 1;
+#ifdef PARALLEL
+    int initialized = 0;
+    MPI_Initialized (&initialized);
+    if (!initialized) return;
+
+    MPI_Comm node;
+    MPI_Comm_split_type (MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+    MPI_Comm_rank (node, &rank);
+    MPI_Comm_size (node, &size);
+    MPI_Comm_free (&node);
+#endif
+  }
+
+  void PinThreads (bool pin)
+  {
+    if (task_manager)
+      throw Exception ("PinThreads: call it before the TaskManager is started");
+
+    if (!pin)
+      {
+        TaskManager::SetStartupFunction();
+        pin_cpus.SetSize0();
+        return;
+      }
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO (&allowed);
+    if (sched_getaffinity (0, sizeof(allowed), &allowed) != 0)
+      throw Exception ("PinThreads: cannot get process affinity");
+
+    Array<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; c++)
+      if (CPU_ISSET (c, &allowed))
+        cpus.Append (c);
+    if (cpus.Size() == 0) return;
+
+    int local_rank, local_size;
+    NodeLocalRank (local_rank, local_size);
+
+    // ranks bound by the launcher pin within their own cpus, unbound ranks
+    // on the same node take consecutive blocks of cpus
+    int nthreads = TaskManager::GetMaxThreads();
+    bool bound = cpus.Size() < std::thread::hardware_concurrency();
+    size_t offset = bound ? 0 : size_t(local_rank) * nthreads;
+    if (!bound && size_t(local_size) * nthreads > cpus.Size())
+      cout << IM(1) << "PinThreads: " << local_size << " ranks with " << nthreads
+           << " threads oversubscribe " << cpus.Size() << " cpus" << endl;
+
+    // compact pinning: thread i goes to the i-th cpu of the rank
+    pin_cpus.SetSize (nthreads);
+    for (int i = 0; i < nthreads; i++)
+      pin_cpus[i] = cpus[(offset+i) % cpus.Size()];
+    pinned = Array<atomic<bool>> (nthreads);
+    for (auto & p : pinned) p = false;
+
+    TaskManager::SetStartupFunction (PinWorker);
+#endif
+  }
+
+  int NumPinnedThreads ()
+  {
+    int cnt = 0;
+    for (auto & p : pinned)
+      if (p) cnt++;
+    return cnt;
+  }
+}
@@ -0,0 +1,52 @@
+#ifndef FILE_NUMA
+#define FILE_NUMA
+
+/**************************************************************************/
+/* File:   numa.hpp                                                       */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+  First-touch placement and thread pinning.
+
+  Linux places a memory page on the NUMA node of the thread touching
+  it first. AllocFirstTouch touches with one contiguous range per
+  thread (TasksPerThread(1)), as the vector operations using this
+  partition do. Loops with a different partition, like the blocked
+  MultiVector kernels, find only part of their data local. This only
+  pays off if workers do not migrate between sockets, see PinThreads.
+*/
+
+namespace ngstd
+{
+  /// allocates n uninitialized values, free with FreeFirstTouch
+  template <typename T>
+  inline T * AllocFirstTouch (size_t n)
+  {
+    static_assert (std::is_trivially_destructible<T>::value,
+                   "AllocFirstTouch needs trivial types");
+    T * data = static_cast<T*> (::operator new (n*sizeof(T)));
+    ParallelForRange (n, [data] (IntRange r)
+                      {
+                        for (auto i : r)
+                          new (data+i) T(0);
+                      }, TasksPerThread(1), TotalCosts(n));
+    return data;
+  }
+
+  template <typename T>
+  inline void FreeFirstTouch (T * data)
+  {
+    ::operator delete (data);
+  }
+
+  /// TaskManager workers pin themselves to the cpus of the process when they start,
+  /// offset by the node-local MPI rank. Call before the TaskManager is started,
+  /// collective over MPI_COMM_WORLD. The main thread is not pinned
+  NGS_DLL_HEADER void PinThreads (bool pin = true);
+
+  /// number of workers which pinned themselves since PinThreads
+  NGS_DLL_HEADER int NumPinnedThreads ();
+}
+
+#endif
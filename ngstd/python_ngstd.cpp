@@ -125,12 +125,30 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
                  timer["counts"] = py::int_(NgProfiler::GetCounts(i));
                  timer["flops"] = py::float_(NgProfiler::GetFlops(i));
                  timer["Gflop/s"] = py::float_(NgProfiler::GetFlops(i)/NgProfiler::GetTime(i)*1e-9);
+                 timer["bytes"] = py::float_(GetTimerBytes(i));
+                 timer["GB/s"] = py::float_(GetTimerBytes(i)/NgProfiler::GetTime(i)*1e-9);
                  timers.append(timer);
                }
 	     return timers;
-	   }, "Returns list of timers"
+	   }, "Returns list of timers. A multiply-add counts as 2 flops, sparse matrix-vector products report 2*nze flops"
 	   );
-  m.def("ResetTimers", &NgProfiler::Reset);
+  m.def("ResetTimers", []()
+        {
+          NgProfiler::Reset();
+          ResetTimerBytes();
+        });
+
+  m.def("PrintTimerWork", []()
+        {
+          PrintTimerWork(cout);
+        }, "Prints achieved GFlop/s, GB/s and flop/byte of timers with work counters");
+
+  m.def("PinThreads", &PinThreads, py::arg("pin")=true,
+        "TaskManager workers pin themselves to the cpus of the process when they start,\n"
+        "offset by the node-local MPI rank. The main thread is not pinned.\n"
+        "Call it before entering the TaskManager, on all MPI ranks. pin=False switches it off");
+  m.def("NumPinnedThreads", &NumPinnedThreads,
+        "Number of TaskManager workers which pinned themselves since PinThreads");
 
   
   py::class_<Archive, shared_ptr<Archive>> (m, "Archive")
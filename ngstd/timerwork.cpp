@@ -0,0 +1,43 @@
+/**************************************************************************/
+/* File:   timerwork.cpp                                                  */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+#include <ngstd.hpp>
+
+namespace ngstd
+{
+  double timer_bytes[NgProfiler::SIZE] = { 0 };
+
+  void ResetTimerBytes ()
+  {
+    for (auto & b : timer_bytes)
+      b = 0;
+  }
+
+  void PrintTimerWork (ostream & ost)
+  {
+    ost << setw(40) << left << "timer" << right
+        << setw(10) << "calls"
+        << setw(12) << "time"
+        << setw(12) << "GFlop/s"
+        << setw(12) << "GB/s"
+        << setw(12) << "flop/byte" << endl;
+
+    for (int i = 0; i < NgProfiler::SIZE; i++)
+      {
+        if (NgProfiler::timers[i].name.empty()) continue;
+        double flops = NgProfiler::GetFlops(i);
+        double bytes = timer_bytes[i];
+        if (flops == 0 && bytes == 0) continue;
+        double time = NgProfiler::GetTime(i);
+        
+        ost << setw(40) << left << NgProfiler::timers[i].name << right
+            << setw(10) << NgProfiler::GetCounts(i)
+            << setw(12) << setprecision(4) << time
+            << setw(12) << (time > 0 ? flops/time*1e-9 : 0.0)
+            << setw(12) << (time > 0 ? bytes/time*1e-9 : 0.0)
+            << setw(12) << (bytes > 0 ? flops/bytes : 0.0) << endl;
+      }
+  }
+}
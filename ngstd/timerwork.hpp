@@ -0,0 +1,52 @@
+#ifndef FILE_TIMERWORK
+#define FILE_TIMERWORK
+
+/**************************************************************************/
+/* File:   timerwork.hpp                                                  */
+/* Date:   Oct. 2026                                                      */
+/**************************************************************************/
+
+/*
+  Work counters for profiler timers.
+
+  The ngcore profiler counts time, calls and flops per timer. Here we
+  add the number of bytes moved, such that regions can report the
+  achieved bandwidth and the arithmetic intensity (flop/byte), i.e.
+  the position in the roofline model.
+
+  Counters are registered once per call, outside of parallel loops:
+
+     static Timer t("SparseMatrix::MultAdd"); RegionTimer reg(t);
+     AddWork (t, 2*nze, nze*(sizeof(TM)+sizeof(int)));
+
+  A multiply-add counts as 2 flops. Sparse matrix-vector products
+  therefore report 2*nze flops per call, twice the nze which the
+  SparseMatrix timers used to count.
+*/
+
+namespace ngstd
+{
+  NGS_DLL_HEADER extern double timer_bytes[NgProfiler::SIZE];
+
+  inline void AddTimerBytes (int nr, double bytes)
+  {
+    AtomicAdd (timer_bytes[nr], bytes);
+  }
+
+  inline double GetTimerBytes (int nr) { return timer_bytes[nr]; }
+  
+  NGS_DLL_HEADER void ResetTimerBytes ();
+
+  /// register flops and bytes moved for one call of the timed region
+  template <typename TTIMER>
+  inline void AddWork (TTIMER & t, double flops, double bytes)
+  {
+    t.AddFlops (flops);
+    AddTimerBytes (int(t), bytes);
+  }
+
+  /// table of timers with work counters: time, GFlop/s, GB/s, flop/byte
+  NGS_DLL_HEADER void PrintTimerWork (ostream & ost);
+}
+
+#endif
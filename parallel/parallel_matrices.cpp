@@ -12,38 +12,26 @@
 
 namespace ngla
 {
+  int agglomeration_groupsize = 0;
+  int agglomeration_minranks = 0;
 
 #ifdef PARALLEL
-  
-  template <typename TM> AutoVector MasterInverse<TM> :: CreateRowVector () const
-  { return make_unique<ParallelVVector<double>> (paralleldofs->GetNDofLocal(), paralleldofs); }
-  template <typename TM> AutoVector MasterInverse<TM> :: CreateColVector () const
-  { return make_unique<ParallelVVector<double>> (paralleldofs->GetNDofLocal(), paralleldofs); }
-  
-  template <typename TM>
-  MasterInverse<TM> :: MasterInverse (const SparseMatrixTM<TM> & mat, 
-				      shared_ptr<BitArray> subset, 
-				      shared_ptr<ParallelDofs> hpardofs)
-    
-    : BaseMatrix(hpardofs), loc2glob(hpardofs -> GetCommunicator().Size())
+
+  // consistent global enumeration of the dofs in subset, -1 for the others
+  static int GlobalSubsetNumbering (const ParallelDofs & pardofs, shared_ptr<BitArray> subset,
+                                    Array<int> & global_nums)
   {
-    inv = nullptr;
-    
-    auto & comm = paralleldofs->GetCommunicator();
+    auto & comm = pardofs.GetCommunicator();
     int id = comm.Rank();
     int ntasks = comm.Size();
+    int ndof = pardofs.GetNDofLocal();
 
-    // consistent enumeration
-    
-    int ndof = paralleldofs->GetNDofLocal();
-
-    Array<int> global_nums(ndof);
+    global_nums.SetSize(ndof);
     global_nums = -1;
     int num_master_dofs = 0;
     for (int i = 0; i < ndof; i++)
-      if (paralleldofs -> IsMasterDof (i) && (!subset || (subset && subset->Test(i))))
+      if (pardofs.IsMasterDof (i) && (!subset || (subset && subset->Test(i))))
 	global_nums[i] = num_master_dofs++;
-    
 
     Array<int> first_master_dof(ntasks);
     comm.AllGather (num_master_dofs, first_master_dof);
@@ -60,7 +48,31 @@ namespace ngla
       if (global_nums[i] != -1)
 	global_nums[i] += first_master_dof[id];
 
-    paralleldofs -> ScatterDofData (global_nums);
+    pardofs.ScatterDofData (global_nums);
+    return num_glob_dofs;
+  }
+  
+  template <typename TM> AutoVector MasterInverse<TM> :: CreateRowVector () const
+  { return make_unique<ParallelVVector<double>> (paralleldofs->GetNDofLocal(), paralleldofs); }
+  template <typename TM> AutoVector MasterInverse<TM> :: CreateColVector () const
+  { return make_unique<ParallelVVector<double>> (paralleldofs->GetNDofLocal(), paralleldofs); }
+  
+  template <typename TM>
+  MasterInverse<TM> :: MasterInverse (const SparseMatrixTM<TM> & mat, 
+				      shared_ptr<BitArray> subset, 
+				      shared_ptr<ParallelDofs> hpardofs)
+    
+    : BaseMatrix(hpardofs), loc2glob(hpardofs -> GetCommunicator().Size())
+  {
+    inv = nullptr;
+    
+    auto & comm = paralleldofs->GetCommunicator();
+    int id = comm.Rank();
+    int ntasks = comm.Size();
+
+    // consistent enumeration
+    Array<int> global_nums;
+    int num_glob_dofs = GlobalSubsetNumbering (*paralleldofs, subset, global_nums);
 
 
     /*
@@ -358,6 +370,428 @@ namespace ngla
 
 
 
+  template <typename TSCAL>
+  static shared_ptr<SparseMatrix<TSCAL>> MatrixFromTriplets (int n, FlatArray<int> rows, FlatArray<int> cols,
+                                                              FlatArray<TSCAL> vals, bool symmetric)
+  {
+    DynamicTable<int> graph(n);
+    for (size_t i = 0; i < rows.Size(); i++)
+      {
+	int r = rows[i], c = cols[i];
+	if (symmetric && (r < c)) swap (r, c);
+	graph.AddUnique (r, c);
+      }
+
+    Array<int> els_per_row(n);
+    for (int i = 0; i < n; i++)
+      els_per_row[i] = graph[i].Size();
+
+    auto matrix = symmetric ? make_shared<SparseMatrixSymmetric<TSCAL>> (els_per_row)
+      : make_shared<SparseMatrix<TSCAL>> (els_per_row);
+
+    for (size_t i = 0; i < rows.Size(); i++)
+      {
+	int r = rows[i], c = cols[i];
+	if (symmetric && (r < c) ) swap (r, c);
+	matrix->CreatePosition(r, c);
+      }
+    matrix->AsVector() = 0.0;
+
+    for (size_t i = 0; i < rows.Size(); i++)
+      {
+	int r = rows[i], c = cols[i];
+	if (symmetric && (r < c)) swap (r, c);
+	(*matrix)(r,c) += vals[i];
+      }
+
+    matrix->SetInverseType (symmetric ? SPARSECHOLESKY : SPARSELU);
+    return matrix;
+  }
+
+  static void SortUnique (Array<int> & a)
+  {
+    QuickSort (a);
+    size_t n = 0;
+    for (size_t i = 0; i < a.Size(); i++)
+      if (i == 0 || a[i] != a[i-1])
+        a[n++] = a[i];
+    a.SetSize(n);
+  }
+
+  static int PosInSorted (FlatArray<int> a, int val)
+  {
+    return std::lower_bound (a.Data(), a.Data()+a.Size(), val) - a.Data();
+  }
+
+
+  template <typename TSCAL> AutoVector AgglomeratedInverse<TSCAL> :: CreateRowVector () const
+  { return make_unique<ParallelVVector<TSCAL>> (paralleldofs->GetNDofLocal(), paralleldofs); }
+  template <typename TSCAL> AutoVector AgglomeratedInverse<TSCAL> :: CreateColVector () const
+  { return make_unique<ParallelVVector<TSCAL>> (paralleldofs->GetNDofLocal(), paralleldofs); }
+
+  template <typename TSCAL>
+  AgglomeratedInverse<TSCAL> :: AgglomeratedInverse (const SparseMatrixTM<TSCAL> & mat,
+                                                     shared_ptr<BitArray> asubset,
+                                                     shared_ptr<ParallelDofs> hpardofs)
+    : BaseMatrix(hpardofs), subset(asubset), member_dofs(0), leader_dofs(0)
+  {
+    static Timer t("AgglomeratedInverse");
+    static Timer tgrp("AgglomeratedInverse - group elimination");
+    static Timer tcoarse("AgglomeratedInverse - coarse factorization");
+    RegionTimer reg(t);
+
+    auto & comm = paralleldofs->GetCommunicator();
+    int id = comm.Rank();
+    int ntasks = comm.Size();
+    bool symmetric = (dynamic_cast<const SparseMatrixSymmetric<TSCAL>*>(&mat) != NULL);
+
+    Array<int> global_nums;
+    GlobalSubsetNumbering (*paralleldofs, subset, global_nums);
+
+    // rank 0 has no dofs, ranks 1,2,... are grouped consecutively
+    int gs = agglomeration_groupsize > 0 ? agglomeration_groupsize
+      : max(1, int(ceil(sqrt(double(ntasks-1)))));
+    auto leader_of = [gs] (int rank) { return 1 + ((rank-1)/gs)*gs; };
+    for (int r = 1; r < ntasks; r += gs)
+      leaders.Append (r);
+
+    if (id == 0)
+      {
+        // assemble the Schur complements of the groups
+        RegionTimer reg(tcoarse);
+        leader_dofs = DynamicTable<int> (leaders.Size());
+        Array<Array<int>> lgdofs(leaders.Size());
+        Array<Array<TSCAL>> lschur(leaders.Size());
+        Array<int> coarse_dofs;
+        for (size_t k = 0; k < leaders.Size(); k++)
+          {
+            comm.Recv (lgdofs[k], leaders[k], MPI_TAG_SOLVE);
+            comm.Recv (lschur[k], leaders[k], MPI_TAG_SOLVE);
+            coarse_dofs.Append (lgdofs[k]);
+          }
+        SortUnique (coarse_dofs);
+
+        Array<int> rows, cols;
+        Array<TSCAL> vals;
+        for (size_t k = 0; k < leaders.Size(); k++)
+          {
+            size_t nk = lgdofs[k].Size();
+            for (auto g : lgdofs[k])
+              leader_dofs.Add (k, PosInSorted (coarse_dofs, g));
+            auto dofs = leader_dofs[k];
+            for (size_t i = 0; i < nk; i++)
+              for (size_t j = 0; j < nk; j++)
+                {
+                  if (symmetric && dofs[i] < dofs[j]) continue;
+                  rows.Append (dofs[i]);
+                  cols.Append (dofs[j]);
+                  vals.Append (lschur[k][i*nk+j]);
+                }
+          }
+
+        cout << IM(3) << "AgglomeratedInverse: " << leaders.Size() << " groups, "
+             << coarse_dofs.Size() << " coarse dofs" << endl;
+        if (coarse_dofs.Size())
+          {
+            mat_schur = MatrixFromTriplets<TSCAL> (coarse_dofs.Size(), rows, cols, vals, symmetric);
+            inv_schur = mat_schur->InverseMatrix();
+          }
+        return;
+      }
+
+    leader = leader_of(id);
+
+    // my part of the matrix in global numbering
+    Array<int> gnums, interior;
+    for (int i = 0; i < paralleldofs->GetNDofLocal(); i++)
+      if (!subset || subset->Test(i))
+        {
+          select.Append (i);
+          gnums.Append (global_nums[i]);
+          // not shared with ranks of other groups
+          bool inner = true;
+          for (auto p : paralleldofs->GetDistantProcs(i))
+            if (p == 0 || leader_of(p) != leader)
+              inner = false;
+          interior.Append (inner);
+        }
+
+    Array<int> rows, cols;
+    Array<TSCAL> vals;
+    for (int row = 0; row < mat.Height(); row++)
+      if (!subset || subset->Test(row))
+        {
+          FlatArray<int> rcols = mat.GetRowIndices(row);
+          FlatVector<TSCAL> rvals = mat.GetRowValues(row);
+          for (int j = 0; j < rcols.Size(); j++)
+            if (!subset || subset->Test(rcols[j]))
+              {
+                rows.Append (global_nums[row]);
+                cols.Append (global_nums[rcols[j]]);
+                vals.Append (rvals[j]);
+              }
+        }
+
+    if (id != leader)
+      {
+        comm.Send (gnums, leader, MPI_TAG_SOLVE);
+        comm.Send (interior, leader, MPI_TAG_SOLVE);
+        comm.Send (rows, leader, MPI_TAG_SOLVE);
+        comm.Send (cols, leader, MPI_TAG_SOLVE);
+        comm.Send (vals, leader, MPI_TAG_SOLVE);
+        return;
+      }
+
+    // group leader: collect the group matrix
+    RegionTimer rgrp(tgrp);
+    for (int r = leader; r < min(leader+gs, ntasks); r++)
+      members.Append (r);
+
+    Array<Array<int>> mgnums(members.Size());
+    Array<int> allrows, allcols, idofs, bdofs;
+    Array<TSCAL> allvals;
+    for (size_t k = 0; k < members.Size(); k++)
+      {
+        Array<int> hinterior, hrows, hcols;
+        Array<TSCAL> hvals;
+        if (members[k] == id)
+          {
+            mgnums[k] = std::move(gnums);
+            hinterior = std::move(interior);
+            hrows = std::move(rows);
+            hcols = std::move(cols);
+            hvals = std::move(vals);
+          }
+        else
+          {
+            comm.Recv (mgnums[k], members[k], MPI_TAG_SOLVE);
+            comm.Recv (hinterior, members[k], MPI_TAG_SOLVE);
+            comm.Recv (hrows, members[k], MPI_TAG_SOLVE);
+            comm.Recv (hcols, members[k], MPI_TAG_SOLVE);
+            comm.Recv (hvals, members[k], MPI_TAG_SOLVE);
+          }
+        for (size_t i = 0; i < mgnums[k].Size(); i++)
+          (hinterior[i] ? idofs : bdofs).Append (mgnums[k][i]);
+        allrows.Append (hrows);
+        allcols.Append (hcols);
+        allvals.Append (hvals);
+      }
+
+    // group numbering: interior dofs first, then boundary dofs
+    SortUnique (idofs);
+    SortUnique (bdofs);
+    ninterior = idofs.Size();
+    nbnd = bdofs.Size();
+    auto grpnum = [&] (int g) -> int
+      {
+        int pos = PosInSorted (idofs, g);
+        if (pos < ninterior && idofs[pos] == g) return pos;
+        return ninterior + PosInSorted (bdofs, g);
+      };
+
+    member_dofs = DynamicTable<int> (members.Size());
+    for (size_t k = 0; k < members.Size(); k++)
+      for (auto g : mgnums[k])
+        member_dofs.Add (k, grpnum(g));
+
+    // split into blocks, the boundary block goes to the dense Schur complement
+    Array<int> ii_rows, ii_cols;
+    Array<TSCAL> ii_vals;
+    Matrix<TSCAL> schur(nbnd);
+    schur = TSCAL(0.0);
+    auto add_entry = [&] (int r, int c, TSCAL v)
+      {
+        if (r < ninterior && c < ninterior)
+          {
+            ii_rows.Append (r); ii_cols.Append (c); ii_vals.Append (v);
+          }
+        else if (r < ninterior)
+          {
+            ib_rows.Append (r); ib_cols.Append (c-ninterior); ib_vals.Append (v);
+          }
+        else if (c < ninterior)
+          {
+            bi_rows.Append (r-ninterior); bi_cols.Append (c); bi_vals.Append (v);
+          }
+        else
+          schur(r-ninterior, c-ninterior) += v;
+      };
+
+    for (size_t i = 0; i < allrows.Size(); i++)
+      {
+        int r = grpnum(allrows[i]), c = grpnum(allcols[i]);
+        add_entry (r, c, allvals[i]);
+        // symmetric storage has only the lower part, the interior block stays symmetric
+        if (symmetric && r != c && (r >= ninterior || c >= ninterior))
+          add_entry (c, r, allvals[i]);
+      }
+
+    if (ninterior)
+      {
+        mat_interior = MatrixFromTriplets<TSCAL> (ninterior, ii_rows, ii_cols, ii_vals, symmetric);
+        inv_interior = mat_interior->InverseMatrix();
+      }
+
+    // schur -= A_BI A_II^{-1} A_IB, for blocks of columns
+    if (ninterior && nbnd)
+      {
+        constexpr size_t bs = 32;
+        for (size_t j0 = 0; j0 < nbnd; j0 += bs)
+          {
+            size_t j1 = min(j0+bs, nbnd);
+            MultiVector x(ninterior, j1-j0, is_same<TSCAL,Complex>::value);
+            MultiVector y(ninterior, j1-j0, is_same<TSCAL,Complex>::value);
+            x = 0.0;
+            y = 0.0;
+            for (size_t t = 0; t < ib_rows.Size(); t++)
+              if (ib_cols[t] >= j0 && ib_cols[t] < j1)
+                x[ib_cols[t]-j0]->FV<TSCAL>()(ib_rows[t]) += ib_vals[t];
+
+            Vector<double> ones(j1-j0);
+            ones = 1;
+            inv_interior->MultAdd (ones, x, y);
+
+            for (size_t t = 0; t < bi_rows.Size(); t++)
+              for (size_t j = j0; j < j1; j++)
+                schur(bi_rows[t], j) -= bi_vals[t] * y[j-j0]->FV<TSCAL>()(bi_cols[t]);
+          }
+      }
+
+    cout << IM(5) << "AgglomeratedInverse: group of rank " << id << " has "
+         << ninterior << " interior and " << nbnd << " boundary dofs" << endl;
+    comm.Send (bdofs, 0, MPI_TAG_SOLVE);
+    comm.Send (FlatArray<TSCAL> (nbnd*nbnd, schur.Data()), 0, MPI_TAG_SOLVE);
+  }
+
+  template <typename TSCAL>
+  void AgglomeratedInverse<TSCAL> :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("AgglomeratedInverse::MultAdd");
+    RegionTimer reg(t);
+
+    NgMPI_Comm comm = paralleldofs->GetCommunicator();
+    int id = comm.Rank();
+
+    bool is_x_cum = (dynamic_cast_ParallelBaseVector(x) . Status() == CUMULATED);
+    y.Cumulate();
+
+    if (id == 0)
+      {
+        // coarse problem on the dofs shared between groups
+        size_t n = mat_schur ? mat_schur->Height() : 0;
+        VVector<TSCAL> g(n), u(n);
+        g = 0.0;
+        for (size_t k = 0; k < leaders.Size(); k++)
+          {
+            Array<TSCAL> lg;
+            comm.Recv (lg, leaders[k], MPI_TAG_SOLVE);
+            for (size_t i = 0; i < lg.Size(); i++)
+              g.FV()(leader_dofs[k][i]) += lg[i];
+          }
+        if (inv_schur)
+          u = (*inv_schur) * g;
+
+        Array<Array<TSCAL>> lu(leaders.Size());
+        Array<MPI_Request> requ;
+        for (size_t k = 0; k < leaders.Size(); k++)
+          {
+            auto dofs = leader_dofs[k];
+            lu[k].SetSize (dofs.Size());
+            for (size_t i = 0; i < dofs.Size(); i++)
+              lu[k][i] = u.FV()(dofs[i]);
+            requ.Append (comm.ISend (lu[k], leaders[k], MPI_TAG_SOLVE));
+          }
+        MyMPI_WaitAll (requ);
+        return;
+      }
+
+    FlatVector<TSCAL> fx = x.FV<TSCAL> ();
+    FlatVector<TSCAL> fy = y.FV<TSCAL> ();
+
+    // the group adds up the contributions, so cumulated values count on the master only
+    Array<TSCAL> lx (select.Size());
+    for (size_t i = 0; i < select.Size(); i++)
+      lx[i] = (is_x_cum && !paralleldofs->IsMasterDof(select[i])) ? TSCAL(0.0) : fx(select[i]);
+
+    if (id != leader)
+      {
+        Array<TSCAL> lu (select.Size());
+        MPI_Request request = comm.ISend (lx, leader, MPI_TAG_SOLVE);
+        comm.Recv (lu, leader, MPI_TAG_SOLVE);
+        MPI_Wait (&request, MPI_STATUS_IGNORE);
+        for (size_t i = 0; i < select.Size(); i++)
+          fy(select[i]) += s * lu[i];
+        return;
+      }
+
+    // group leader: right hand side of the group
+    Vector<TSCAL> f(ninterior+nbnd);
+    f = TSCAL(0.0);
+    for (size_t k = 0; k < members.Size(); k++)
+      {
+        Array<TSCAL> hx;
+        if (members[k] == id)
+          hx = lx;
+        else
+          comm.Recv (hx, members[k], MPI_TAG_SOLVE);
+        auto dofs = member_dofs[k];
+        for (size_t i = 0; i < dofs.Size(); i++)
+          f(dofs[i]) += hx[i];
+      }
+
+    // eliminate the interior dofs: g_B = f_B - A_BI A_II^{-1} f_I
+    VVector<TSCAL> hi(ninterior), ui(ninterior);
+    Array<TSCAL> gb(nbnd);
+    for (size_t i = 0; i < nbnd; i++)
+      gb[i] = f(ninterior+i);
+    if (ninterior)
+      {
+        hi.FV() = f.Range(0, ninterior);
+        ui = (*inv_interior) * hi;
+        for (size_t t = 0; t < bi_rows.Size(); t++)
+          gb[bi_rows[t]] -= bi_vals[t] * ui.FV()(bi_cols[t]);
+      }
+
+    comm.Send (gb, 0, MPI_TAG_SOLVE);
+    Array<TSCAL> ub(nbnd);
+    comm.Recv (ub, 0, MPI_TAG_SOLVE);
+
+    // back substitution: u_I = A_II^{-1} (f_I - A_IB u_B)
+    Vector<TSCAL> u(ninterior+nbnd);
+    if (ninterior)
+      {
+        hi.FV() = f.Range(0, ninterior);
+        for (size_t t = 0; t < ib_rows.Size(); t++)
+          hi.FV()(ib_rows[t]) -= ib_vals[t] * ub[ib_cols[t]];
+        ui = (*inv_interior) * hi;
+        u.Range(0, ninterior) = ui.FV();
+      }
+    for (size_t i = 0; i < nbnd; i++)
+      u(ninterior+i) = ub[i];
+
+    Array<Array<TSCAL>> lu(members.Size());
+    Array<MPI_Request> requ;
+    for (size_t k = 0; k < members.Size(); k++)
+      {
+        auto dofs = member_dofs[k];
+        if (members[k] == id)
+          for (size_t i = 0; i < dofs.Size(); i++)
+            fy(select[i]) += s * u(dofs[i]);
+        else
+          {
+            lu[k].SetSize (dofs.Size());
+            for (size_t i = 0; i < dofs.Size(); i++)
+              lu[k][i] = u(dofs[i]);
+            requ.Append (comm.ISend (lu[k], members[k], MPI_TAG_SOLVE));
+          }
+      }
+    MyMPI_WaitAll (requ);
+  }
+
+  template class AgglomeratedInverse<double>;
+  template class AgglomeratedInverse<Complex>;
+
+
   template class MasterInverse<double>;
   template class MasterInverse<Complex>;
 
@@ -679,11 +1113,19 @@ namespace ngla
     bool symmetric = dynamic_cast<const SparseMatrixSymmetric<TM>*> (mat.get()) != NULL;
     if (mat->GetInverseType() == MUMPS)
       return make_shared<ParallelMumpsInverse<TM>> (*dmat, subset, nullptr, paralleldofs, symmetric);
-    else 
 #endif
 
 #ifdef PARALLEL
-      return make_shared<MasterInverse<TM>> (*dmat, subset, paralleldofs);
+    if constexpr (is_same<TM,double>::value || is_same<TM,Complex>::value)
+      {
+        auto invtype = mat->GetInverseType();
+        int ntasks = paralleldofs->GetCommunicator().Size();
+        if (ntasks > 2 &&
+            (invtype == AGGLOMERATEDINVERSE ||
+             (invtype != MASTERINVERSE && agglomeration_minranks > 0 && ntasks >= agglomeration_minranks)))
+          return make_shared<AgglomeratedInverse<TM>> (*dmat, subset, paralleldofs);
+      }
+    return make_shared<MasterInverse<TM>> (*dmat, subset, paralleldofs);
 #endif
     throw Exception ("ParallelMatrix: don't know how to invert");
   }
@@ -152,7 +152,11 @@ namespace ngla
 
 
   
-
+  /// number of ranks per group of the AgglomeratedInverse, 0 for sqrt(ranks)
+  NGS_DLL_HEADER extern int agglomeration_groupsize;
+  /// from this number of ranks on, distributed matrices are inverted by the
+  /// AgglomeratedInverse unless 'masterinverse' is requested, 0 for never
+  NGS_DLL_HEADER extern int agglomeration_minranks;
   
 #ifdef PARALLEL
 
@@ -181,6 +185,51 @@ namespace ngla
   };
 
 
+  /**
+     Direct solver for distributed matrices, agglomerated on groups of ranks.
+
+     The leader of every group collects the matrix of its group and
+     eliminates the dofs not shared with other groups. Rank 0 factorizes
+     the assembled Schur complements on the dofs shared between groups.
+     This is one level of nested dissection with the groups as subtrees,
+     rank 0 receives only one message per group.
+   */
+  template <typename TSCAL>
+  class AgglomeratedInverse : public BaseMatrix
+  {
+    shared_ptr<BitArray> subset;
+    // local dofs in the subset
+    Array<int> select;
+    int leader;
+
+    // group leader: ranks of the group, and the group dofs of their selected dofs
+    Array<int> members;
+    DynamicTable<int> member_dofs;
+    // group dofs are numbered interior first
+    size_t ninterior = 0, nbnd = 0;
+    shared_ptr<BaseMatrix> mat_interior, inv_interior;
+    // interior-boundary couplings as triplets (row, col, value)
+    Array<int> ib_rows, ib_cols, bi_rows, bi_cols;
+    Array<TSCAL> ib_vals, bi_vals;
+
+    // rank 0: group leaders, and their boundary dofs in the Schur complement
+    Array<int> leaders;
+    DynamicTable<int> leader_dofs;
+    shared_ptr<BaseMatrix> mat_schur, inv_schur;
+  public:
+    AgglomeratedInverse (const SparseMatrixTM<TSCAL> & mat, shared_ptr<BitArray> asubset,
+                         shared_ptr<ParallelDofs> apardofs);
+    virtual bool IsComplex() const override { return is_same<TSCAL,Complex>::value; }
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual int VHeight() const override { return paralleldofs->GetNDofLocal(); }
+    virtual int VWidth() const override { return paralleldofs->GetNDofLocal(); }
+
+    AutoVector CreateRowVector() const override;
+    AutoVector CreateColVector() const override;
+  };
+
+
   
   class FETI_Jump_Matrix : public BaseMatrix
   {
@@ -26,6 +26,8 @@ namespace ngla
     
     Array<MPI_Request> sreqs;
     Array<MPI_Request> rreqs;
+    /// messages of StartCumulate are pending
+    mutable bool cumulate_started = false;
 
   public:
     ParallelBaseVector ()
@@ -82,6 +84,11 @@ namespace ngla
     { return local_vec; }
     
     virtual void Cumulate () const override; 
+
+    /// posts the messages of Cumulate, the exchange dofs must not change until FinishCumulate
+    void StartCumulate () const;
+    /// adds the received values, the vector is cumulated afterwards
+    void FinishCumulate () const;
     
     virtual void Distribute() const override = 0;
     // { cerr << "ERROR -- Distribute called for BaseVector, is not parallel" << endl; }
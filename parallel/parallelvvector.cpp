@@ -224,8 +224,15 @@ namespace ngla
     static Timer t("ParallelVector - Cumulate");
     RegionTimer reg(t);
     
-    // #ifdef PARALLEL
     if (status != DISTRIBUTED) return;
+    StartCumulate();
+    FinishCumulate();
+  }
+
+  void ParallelBaseVector :: StartCumulate () const
+  {
+    // #ifdef PARALLEL
+    if (status != DISTRIBUTED || cumulate_started) return;
     
     // int ntasks = paralleldofs->GetNTasks();
     auto exprocs = paralleldofs->GetDistantProcs();
@@ -244,6 +251,18 @@ namespace ngla
     //   MPI_Startall(sreqs.Size(), &sreqs[0]);
     // }
 
+    cumulate_started = true;
+    // #endif
+  }
+
+  void ParallelBaseVector :: FinishCumulate () const
+  {
+    if (!cumulate_started) return;
+
+    auto exprocs = paralleldofs->GetDistantProcs();
+    int nexprocs = exprocs.Size();
+    ParallelBaseVector * constvec = const_cast<ParallelBaseVector * > (this);
+
     MyMPI_WaitAll (sreqs);
     
     // cumulate
@@ -253,13 +272,12 @@ namespace ngla
 	constvec->AddRecvValues(exprocs[isender]);
       } 
 
+    cumulate_started = false;
     SetStatus(CUMULATED);
-    // #endif
   }
   
 
 
-
   void ParallelBaseVector :: ISend ( int dest, MPI_Request & request ) const
   {
 #ifdef PARALLEL
@@ -925,6 +925,7 @@ int NGS_PrintTiming (ClientData clientData,
 		     int argc, const char *argv[])
 {
   ngstd::NgProfiler::Print (stdout);
+  ngfem::SIMDFallbacks::Print (cout);
   return NG_TCL_OK;
 }
 
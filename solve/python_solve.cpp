@@ -865,6 +865,7 @@ void ExportVisFunctions(py::module &m) {
               });
 
               bool use_simd = true;
+              SIMDFallbackCounter simd_fallback("_GetValues");
               ma->IterateElements(vb, lh,[&](auto el, LocalHeap& mlh) {
                   FlatArray<float> min_local(ncomps, mlh);
                   FlatArray<float> max_local(ncomps, mlh);
@@ -896,10 +897,12 @@ void ExportVisFunctions(py::module &m) {
                       catch(const ExceptionNOSIMD& e)
                         {
                           use_simd = false;
+                          simd_fallback.Fallback (e);
                         }
                     }
                   if(!use_simd)
                     {
+                      simd_fallback.CountScalarElement();
                       auto & mir = GetMappedIR(ma, el, ir, mlh);
                       if(cf->IsComplex())
                         GetValues<Complex>( *cf, mlh, mir, vals_real.Range(first,next), vals_imag.Range(first,next), min_local, max_local, covariant);
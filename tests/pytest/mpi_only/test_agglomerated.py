@@ -0,0 +1,33 @@
+from ngsolve import *
+
+
+def Solve(a, f, fes, inverse):
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse=inverse) * f.vec
+    return gfu
+
+
+def test_agglomerated_inverse():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    mesh.Refine()
+
+    fes = H1(mesh, order=2, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*dx).Assemble()
+    f = LinearForm(x*v*dx).Assemble()
+
+    gfref = Solve(a, f, fes, "masterinverse")
+
+    minranks, groupsize = ngsglobals.agglomeration_minranks, ngsglobals.agglomeration_groupsize
+    try:
+        # the default inverse switches to the agglomerated solver
+        ngsglobals.agglomeration_minranks = 2
+        ngsglobals.agglomeration_groupsize = 2
+        for inverse in ["sparsecholesky", "agglomeratedinverse"]:
+            gfu = Solve(a, f, fes, inverse)
+            gfu.vec.data -= gfref.vec
+            assert Norm(gfu.vec) < 1e-10 * Norm(gfref.vec)
+    finally:
+        ngsglobals.agglomeration_minranks = minranks
+        ngsglobals.agglomeration_groupsize = groupsize
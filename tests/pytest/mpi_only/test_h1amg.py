@@ -0,0 +1,23 @@
+from ngsolve import *
+
+def test_h1amg_mpi():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    for i in range(2):
+        mesh.Refine()
+
+    fes = H1(mesh, order=1, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    pre = Preconditioner(a, "h1amg")
+    a.Assemble()
+    f = LinearForm(1*v*dx).Assemble()
+
+    gfu = GridFunction(fes)
+    inv = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-8, maxsteps=200)
+    gfu.vec.data = inv * f.vec
+
+    r = f.vec.CreateVector()
+    r.data = f.vec - a.mat * gfu.vec
+    assert Norm(r) < 1e-6 * Norm(f.vec)
+    assert inv.GetSteps() < 100
@@ -0,0 +1,42 @@
+from ngsolve import *
+
+
+def test_linearform_overlap():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    mesh.Refine()
+
+    fes = H1(mesh, order=3)
+    v = fes.TestFunction()
+    f = LinearForm(x*v*dx + y*v*ds).Assemble()
+    fo = LinearForm(x*v*dx + y*v*ds, overlap=True).Assemble()
+
+    # the overlapped form is cumulated during assembly
+    f.vec.Cumulate()
+    diff = f.vec.CreateVector()
+    diff.data = fo.vec - f.vec
+    assert Norm(diff) < 1e-12 * Norm(f.vec)
+
+
+def test_dg_mpi_facets_apply():
+    comm = MPI_Init()
+    mesh = Mesh('square.vol.gz', comm)
+    mesh.Refine()
+
+    fes = L2(mesh, order=2, dgjumps=True)
+    u,v = fes.TnT()
+    jump_u = u-u.Other()
+    jump_v = v-v.Other()
+    a = BilinearForm(u*v*dx + 10*jump_u*jump_v*dx(skeleton=True)
+                     + (u-u.Other())*v*dx(element_boundary=True), nonassemble=True)
+    m = BilinearForm(u*v*dx, nonassemble=True)
+
+    # jumps of a constant vanish, also across the subdomain interfaces
+    gfu = GridFunction(fes)
+    gfu.Set(1)
+    r1 = gfu.vec.CreateVector()
+    r2 = gfu.vec.CreateVector()
+    a.Apply(gfu.vec, r1)
+    m.Apply(gfu.vec, r2)
+    r1 -= r2
+    assert Norm(r1) < 1e-10 * Norm(r2)
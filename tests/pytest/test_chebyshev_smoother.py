@@ -0,0 +1,44 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+
+def Setup(maxh=0.2):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=maxh))
+    fes = H1(mesh, order=1, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx)
+    f = LinearForm(v*dx)
+    return mesh, fes, a, f
+
+
+def Solve(fes, a, f, pre):
+    a.Assemble()
+    f.Assemble()
+    gfu = GridFunction(fes)
+    inv = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-8, maxsteps=500)
+    gfu.vec.data = inv * f.vec
+    r = f.vec.CreateVector()
+    r.data = f.vec - a.mat * gfu.vec
+    return inv.GetSteps(), Norm(r) / Norm(f.vec)
+
+
+def test_multigrid_chebyshev():
+    mesh, fes, a, f = Setup()
+    pre = Preconditioner(a, "multigrid", smoother="chebyshev", chebyshevdegree=3)
+    steps = []
+    for l in range(3):
+        if l > 0:
+            mesh.Refine()
+            fes.Update()
+        steps.append(Solve(fes, a, f, pre)[0])
+    # h-independent iteration counts
+    assert steps[-1] < steps[0] + 5
+    assert steps[-1] < 30
+
+
+def test_h1amg_chebyshev():
+    mesh, fes, a, f = Setup(maxh=0.05)
+    pre = Preconditioner(a, "h1amg", smoother="chebyshev")
+    steps, res = Solve(fes, a, f, pre)
+    assert res < 1e-6
+    assert steps < 60
@@ -0,0 +1,74 @@
+from math import pi
+from netgen.geom2d import unit_square
+from ngsolve import *
+from ngsolve.la import LOBPCG, KrylovSchur, ShiftedInverseCache, RationalArnoldiSolver
+import pytest
+
+
+def LaplaceEVP():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=4, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx, symmetric=True).Assemble()
+    m = BilinearForm(u*v*dx, symmetric=True).Assemble()
+    return fes, a.mat, m.mat
+
+
+exact = [pi**2*(i*i+j*j) for (i,j) in [(1,1),(1,2),(2,1),(2,2),(1,3),(3,1)]]
+
+
+def CheckEigenpairs(lam, evecs, a, m, freedofs):
+    assert len(lam) == len(evecs)
+    r = evecs[0].CreateVector()
+    me = evecs[0].CreateVector()
+    for l, e in zip(lam, evecs):
+        me.data = m * e
+        r.data = a * e - l * me
+        for i in range(len(r)):
+            if not freedofs[i]:
+                r[i] = 0
+        assert Norm(r) < 1e-6 * l * Norm(me)
+    # M-orthonormality
+    gram = InnerProduct(evecs, m * evecs)
+    for i in range(len(lam)):
+        for j in range(len(lam)):
+            assert abs(gram[i,j] - (1 if i == j else 0)) < 1e-8
+
+
+def test_krylovschur():
+    fes, a, m = LaplaceEVP()
+    lam, evecs = KrylovSchur(a, m, fes.FreeDofs(), num=6, shift=1, ncv=14)
+    for l, ex in zip(lam, exact):
+        assert abs(l-ex) < 1e-4 * ex
+    CheckEigenpairs(lam, evecs, a, m, fes.FreeDofs())
+
+
+def test_lobpcg():
+    fes, a, m = LaplaceEVP()
+    pre = a.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+    lam, evecs = LOBPCG(a, m, pre, num=6, maxit=200, tol=1e-9)
+    for l, ex in zip(lam, exact):
+        assert abs(l-ex) < 1e-4 * ex
+    CheckEigenpairs(lam, evecs, a, m, fes.FreeDofs())
+
+    # the Krylov-Schur eigenvalues agree
+    lamks, _ = KrylovSchur(a, m, fes.FreeDofs(), num=6)
+    for l1, l2 in zip(lam, lamks):
+        assert abs(l1-l2) < 1e-8 * l1
+
+
+def test_rational_arnoldi():
+    fes, a, m = LaplaceEVP()
+    fesc = H1(fes.mesh, order=4, dirichlet=".*", complex=True)
+    gfu = GridFunction(fesc, multidim=6)
+
+    cache = ShiftedInverseCache(a, m, fes.FreeDofs(), inverse="sparsecholesky")
+    lam = RationalArnoldiSolver(a, m, fes.FreeDofs(), list(gfu.vecs), [20, 100, 170], cache=cache)
+    assert len(cache) == 3
+    expected = sorted([exact[0], exact[4], exact[5], 17*pi**2, 17*pi**2, 18*pi**2])
+    assert sorted(l.real for l in lam) == pytest.approx(expected, rel=1e-4)
+
+    # a second call reuses the factorization
+    lam2 = RationalArnoldiSolver(a, m, fes.FreeDofs(), list(gfu.vecs)[:2], [100], cache=cache)
+    assert len(cache) == 3
+    assert sorted(l.real for l in lam2) == pytest.approx(sorted([exact[4], exact[5]]), rel=1e-4)
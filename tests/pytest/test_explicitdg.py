@@ -0,0 +1,59 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+def test_explicitdg():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = L2(mesh, order=3)
+    u,v = fes.TnT()
+
+    b = CoefficientFunction( (1,0.3) )
+    bn = b*specialcf.normal(2)
+
+    igls = -u*b*grad(v)*dx \
+        + bn*IfPos(bn, u, u.Other()) * (v-v.Other()) * dx(skeleton=True) \
+        + IfPos(bn, bn*u, 0) * v * ds(skeleton=True)
+
+    a = BilinearForm(fes)
+    a += igls
+
+    gfu = GridFunction(fes)
+    gfu.Set(exp(-20*((x-0.5)**2+(y-0.5)**2)))
+
+    w1 = gfu.vec.CreateVector()
+    w2 = gfu.vec.CreateVector()
+
+    with TaskManager():
+        a.Apply(gfu.vec, w1)
+        fes.SolveM(vec=w1)
+
+        op = ExplicitDGOperator(fes, igls)
+        w2.data = op * gfu.vec
+
+    w2.data -= w1
+    assert Norm(w2) < 1e-10 * Norm(w1)
+
+    op = ExplicitDGOperator(fes, igls, invmass=False)
+    a.Apply(gfu.vec, w1)
+    w2.data = op * gfu.vec - w1
+    assert Norm(w2) < 1e-10 * Norm(w1)
+
+
+def test_explicitdg_nondiagonal_mass():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    # element-local, but without orthogonal shapes
+    fes = Discontinuous(H1(mesh, order=2))
+    u,v = fes.TnT()
+    igls = grad(u)*grad(v)*dx + u*v*dx
+
+    a = BilinearForm(igls).Assemble()
+    m = BilinearForm(u*v*dx).Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.Set(x*y)
+    w1 = gfu.vec.CreateVector()
+    w2 = gfu.vec.CreateVector()
+    w1.data = m.mat.Inverse(inverse="sparsecholesky") * (a.mat * gfu.vec)
+
+    op = ExplicitDGOperator(fes, igls)
+    w2.data = op * gfu.vec - w1
+    assert Norm(w2) < 1e-10 * Norm(w1)
@@ -0,0 +1,41 @@
+import pytest
+from netgen.geom2d import unit_square
+from netgen.csg import unit_cube
+from ngsolve import *
+from ngsolve.fem import SIMDFallbacks, ResetSIMDFallbacks
+
+
+def BoundaryMass(fes, simd):
+    u,v = fes.TnT()
+    bfi = SymbolicBFI(InnerProduct(u,v), BND)
+    bfi.simd_evaluate = simd
+    a = BilinearForm(fes)
+    a += bfi
+    a.Assemble()
+    return a
+
+
+@pytest.mark.parametrize("space", [FacetFESpace, TangentialFacetFESpace, NormalFacetFESpace])
+@pytest.mark.parametrize("geom", [unit_square, unit_cube])
+def test_facet_ds_simd(space, geom):
+    mesh = Mesh(geom.GenerateMesh(maxh=0.4))
+    fes = space(mesh, order=2)
+
+    ResetSIMDFallbacks()
+    a = BoundaryMass(fes, True)
+    # the boundary terms stay on the vectorized path
+    assert len(SIMDFallbacks()) == 0
+
+    aref = BoundaryMass(fes, False)
+    diff = a.mat.AsVector() - aref.mat.AsVector()
+    assert Norm(diff) < 1e-10 * Norm(aref.mat.AsVector())
+
+    # matrix-free application uses the SIMD apply/addtrans
+    u,v = fes.TnT()
+    af = BilinearForm(InnerProduct(u,v)*ds, nonassemble=True)
+    x = a.mat.CreateColVector()
+    x.SetRandom()
+    y = x.CreateVector()
+    af.Apply(x, y)
+    y -= aref.mat * x
+    assert Norm(y) < 1e-10 * Norm(x)
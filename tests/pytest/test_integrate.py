@@ -25,3 +25,24 @@ def test_integrate_xy():
     intC = Integrate(1j*x*y,mesh)
     assert abs(intR-1./4) < 1e-14
     assert abs(intC- 1j*1./4) < 1e-14
+
+def test_integrate_batch():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3)
+    gfu = GridFunction(fes)
+    gfu.Set(sin(3*x)*y)
+    cfs = [gfu, gfu*gfu, grad(gfu), x*y, 1j*x]
+    with TaskManager():
+        res = IntegrateBatch(cfs + [gfu*dx(definedon=mesh.Materials(".*")), x*ds(bonus_intorder=2)],
+                             mesh, order=6)
+    for cf, val in zip(cfs, res):
+        ref = Integrate(cf, mesh, order=6)
+        if isinstance(val, (float, complex)):
+            assert abs(val-ref) < 1e-12
+        else:
+            for a,b in zip(val, ref):
+                assert abs(a-b) < 1e-12
+    assert isinstance(res[0], float)
+    assert isinstance(res[4], complex)
+    assert abs(res[5]-Integrate(gfu, mesh)) < 1e-12
+    assert abs(res[6]-Integrate(x*ds, mesh)) < 1e-12
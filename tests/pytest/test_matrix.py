@@ -99,7 +99,28 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_sparsecholesky_multivector():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    for cplx in [False, True]:
+        fes = H1(mesh, order=3, dirichlet="left", complex=cplx)
+        u,v = fes.TnT()
+        a = BilinearForm(grad(u)*grad(v)*dx+u*v*dx).Assemble()
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+
+        rhs = MultiVector(a.mat.CreateColVector(), 7)
+        for r in rhs:
+            r.SetRandom()
+        sol = MultiVector(a.mat.CreateColVector(), 7)
+        sol[:] = inv * rhs
+
+        hv = a.mat.CreateColVector()
+        for r, s in zip(rhs, sol):
+            hv.data = inv * r
+            hv.data -= s
+            assert Norm(hv) < 1e-10 * Norm(s)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_sparsecholesky_multivector()
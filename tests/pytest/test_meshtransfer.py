@@ -0,0 +1,80 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+
+def Meshes():
+    return Mesh(unit_square.GenerateMesh(maxh=0.2)), Mesh(unit_square.GenerateMesh(maxh=0.13))
+
+
+def test_meshtransfer_polynomial():
+    mesha, meshb = Meshes()
+    fesa = H1(mesha, order=2)
+    fesb = H1(meshb, order=2)
+    gfa = GridFunction(fesa)
+    gfa.Set(x*y)
+    gfb = GridFunction(fesb)
+
+    transfer = ConvertOperator(fesa, fesb)
+    assert transfer.height == fesb.ndof and transfer.width == fesa.ndof
+    gfb.vec.data = transfer * gfa.vec
+    assert Integrate((gfb-x*y)**2, meshb) < 1e-20
+
+    # Set with cache uses the same transfer
+    gfc = GridFunction(fesb)
+    gfc.Set(gfa, cache=True)
+    gfc.vec.data -= gfb.vec
+    assert Norm(gfc.vec) < 1e-12
+
+
+def test_meshtransfer_conservative():
+    mesha, meshb = Meshes()
+    fesa = L2(mesha, order=1)
+    fesb = H1(meshb, order=2)
+    gfa = GridFunction(fesa)
+    gfa.Set(sin(3*x)*y)
+    gfb = GridFunction(fesb)
+    transfer = MeshTransferOperator(fesa, fesb, conservative=True, bonus_intorder=2)
+    gfb.vec.data = transfer * gfa.vec
+    assert abs(Integrate(gfb, meshb) - Integrate(gfa, mesha)) < 1e-3
+
+
+def test_meshtransfer_deformed():
+    mesha, meshb = Meshes()
+    fesa = H1(mesha, order=2)
+    fesb = H1(meshb, order=2)
+    gfa = GridFunction(fesa)
+    gfa.Set(x*x)
+    gfb = GridFunction(fesb)
+    gfb.Set(gfa, cache=True)
+
+    # same mesh timestamp, the cached transfer must be rebuilt anyway
+    deform = GridFunction(VectorH1(meshb, order=1))
+    deform.Set((-0.1*x, 0))
+    meshb.SetDeformation(deform)
+    gfb.Set(gfa, cache=True)
+    assert Integrate((gfb-x*x)**2, meshb) < 1e-20
+    meshb.UnSetDeformation()
+
+
+def test_meshtransfer_uncovered_dofs():
+    from netgen.geom2d import SplineGeometry
+    geo = SplineGeometry()
+    p = [geo.AppendPoint(*xy) for xy in [(0,0), (0.5,0), (1,0), (1,1), (0.5,1), (0,1)]]
+    for i, j, dom in [(0,1,1), (1,2,2), (2,3,2), (3,4,2), (4,5,1), (5,0,1)]:
+        geo.Append(["line", p[i], p[j]], leftdomain=dom, rightdomain=0)
+    geo.Append(["line", p[1], p[4]], leftdomain=1, rightdomain=2)
+    geo.SetMaterial(1, "left")
+    geo.SetMaterial(2, "right")
+    mesha = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    meshb = Mesh(geo.GenerateMesh(maxh=0.13))
+    fesa = H1(mesha, order=2)
+    fesb = H1(meshb, order=2, definedon="left")
+    gfa = GridFunction(fesa)
+    gfa.Set(x*y)
+    gfb = GridFunction(fesb)
+    gfb.vec[:] = 7
+    gfb.Set(gfa, cache=True)
+    # dofs outside of the elements are left alone
+    used = fesb.FreeDofs()
+    assert all(gfb.vec[i] == 7 for i in range(fesb.ndof) if not used[i])
+    assert Integrate((gfb-x*y)**2, meshb, definedon=meshb.Materials("left")) < 1e-20
@@ -0,0 +1,124 @@
+from itertools import permutations
+import numpy as np
+from netgen.geom2d import unit_square
+import netgen.meshing as ngm
+from ngsolve import *
+
+
+def Assemble(fes):
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*ds)
+    a.Assemble()
+    f = LinearForm(x*v*dx)
+    f.Assemble()
+    return a.mat.AsVector(), f.vec
+
+
+def test_mixed_mesh_assembly():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2, quad_dominated=True))
+    fes = H1(mesh, order=2)
+    # mixed orders within the colors
+    for el in mesh.Elements(VOL):
+        if el.nr % 3 == 0:
+            fes.SetOrder(NodeId(ELEMENT, el.nr), 4)
+    fes.Update()
+
+    aref, fref = Assemble(fes)
+    with TaskManager():
+        a, f = Assemble(fes)
+
+    # sorting within a color does not change the result
+    da = aref.CreateVector()
+    da.data = a - aref
+    df = fref.CreateVector()
+    df.data = f - fref
+    assert Norm(da) < 1e-12 * Norm(aref)
+    assert Norm(df) < 1e-12 * Norm(fref)
+
+
+def MixedCubes(n=2):
+    """three disjoint cubes of tets, prisms and hexes, elements added interleaved"""
+    ngmesh = ngm.Mesh(dim=3)
+    names = ["tets", "prisms", "hexes"]
+    for name in names:
+        ngmesh.AddRegion(name, 3)
+
+    def Oriented(pnts):
+        # netgen volume elements are negatively oriented
+        p = [np.array(ngmesh[pi].p) for pi in pnts]
+        if np.linalg.det(np.array([p[1]-p[0], p[2]-p[0], p[-1]-p[0]])) > 0:
+            pnts = pnts[:]
+            pnts[1], pnts[2] = pnts[2], pnts[1]
+        return pnts
+
+    cells = [[] for name in names]
+    for block in range(3):
+        pnum = {}
+        for i in range(n+1):
+            for j in range(n+1):
+                for k in range(n+1):
+                    pnum[i,j,k] = ngmesh.Add(ngm.MeshPoint(ngm.Pnt(2*block+i/n, j/n, k/n)))
+        for i in range(n):
+            for j in range(n):
+                for k in range(n):
+                    p = lambda a,b,c: pnum[i+a,j+b,k+c]
+                    if block == 0:
+                        # Kuhn triangulation of the cube
+                        for perm in permutations(range(3)):
+                            corner, pnts = [0,0,0], [p(0,0,0)]
+                            for d in perm[:2]:
+                                corner[d] = 1
+                                pnts.append(p(*corner))
+                            pnts.append(p(1,1,1))
+                            cells[block].append(Oriented(pnts))
+                    elif block == 1:
+                        cells[block].append([p(0,0,0), p(1,1,0), p(1,0,0), p(0,0,1), p(1,1,1), p(1,0,1)])
+                        cells[block].append([p(0,0,0), p(0,1,0), p(1,1,0), p(0,0,1), p(0,1,1), p(1,1,1)])
+                    else:
+                        cells[block].append([p(0,0,0), p(0,1,0), p(1,1,0), p(1,0,0),
+                                             p(0,0,1), p(0,1,1), p(1,1,1), p(1,0,1)])
+
+    # interleave types, such that colors mix them unless they are sorted
+    for nr in range(max(len(c) for c in cells)):
+        for block in range(3):
+            if nr < len(cells[block]):
+                ngmesh.Add(ngm.Element3D(block+1, cells[block][nr]))
+    return Mesh(ngmesh)
+
+
+def test_mixed_3d_assembly():
+    mesh = MixedCubes()
+    assert set(el.type for el in mesh.Elements(VOL)) == { ET.TET, ET.PRISM, ET.HEX }
+
+    fes = H1(mesh, order=2)
+    # mixed orders within regions
+    for el in mesh.Elements(VOL):
+        if el.nr % 4 == 0:
+            fes.SetOrder(NodeId(ELEMENT, el.nr), 3)
+    fes.Update()
+
+    u,v = fes.TnT()
+    form = grad(u)*grad(v) + (1+x)*u*v
+    with TaskManager():
+        a = BilinearForm(form*dx).Assemble()
+
+    # reference: sum of element matrices
+    bfi = SymbolicBFI(form)
+    ref = np.zeros((fes.ndof, fes.ndof))
+    for el in fes.Elements(VOL):
+        elmat = bfi.CalcElementMatrix(el.GetFE(), el.GetTrafo()).NumPy()
+        dofs = el.dofs
+        ref[np.ix_(dofs, dofs)] += elmat
+    dense = a.mat.ToDense().NumPy()
+    assert np.linalg.norm(dense - ref) < 1e-12 * np.linalg.norm(ref)
+
+    # every element is in one color, each color groups (type, region, ndof)
+    coloring = fes.ElementColoring(VOL)
+    assert sorted(nr for color in coloring for nr in color) == list(range(mesh.ne))
+    for color in coloring:
+        keys = []
+        for nr in color:
+            ei = ElementId(VOL, nr)
+            keys.append((mesh[ei].type, mesh[ei].mat, len(fes.GetDofNrs(ei))))
+        runs = [key for i, key in enumerate(keys) if i == 0 or keys[i-1] != key]
+        assert len(runs) == len(set(runs))
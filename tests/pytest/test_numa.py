@@ -0,0 +1,50 @@
+import numpy as np
+from netgen.geom2d import unit_square
+from ngsolve import *
+from ngsolve.ngstd import PinThreads, NumPinnedThreads
+
+
+def test_vector_first_touch():
+    with TaskManager():
+        for n, cplx in [(1, False), (1000, False), (100000, True)]:
+            v = BaseVector(n, complex=cplx)
+            # first touch initializes the data
+            assert Norm(v) == 0
+            v[:] = 1
+            assert abs(InnerProduct(v, v) - n) < 1e-10
+
+
+def test_pin_threads():
+    PinThreads()
+    try:
+        with TaskManager():
+            v = BaseVector(10000)
+            v[:] = 2
+            assert abs(InnerProduct(v, v) - 40000) < 1e-8
+            # workers only, the main thread stays unpinned
+            assert 0 <= NumPinnedThreads() < ngsglobals.numthreads
+    finally:
+        PinThreads(False)
+
+
+def test_blockjacobi_colored_storage():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet="left")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*dx, symmetric=False).Assemble()
+    f = LinearForm(v*dx).Assemble()
+    free = fes.FreeDofs()
+    blocks = [[d for d in fes.GetDofNrs(el) if free[d]] for el in fes.Elements()]
+
+    with TaskManager():
+        pre = a.mat.CreateBlockSmoother(blocks)
+        x = f.vec.CreateVector()
+        x.data = pre * f.vec
+
+    # additive block Jacobi with explicitly inverted blocks
+    dense = a.mat.ToDense().NumPy()
+    fv = f.vec.FV().NumPy()
+    y = np.zeros(len(fv))
+    for block in blocks:
+        y[block] += np.linalg.solve(dense[np.ix_(block, block)], fv[block])
+    assert np.linalg.norm(y - x.FV().NumPy()) < 1e-10 * np.linalg.norm(y)
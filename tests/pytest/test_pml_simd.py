@@ -0,0 +1,47 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+from ngsolve.comp import pml
+
+
+def Assemble(fes, cf, simd):
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(cf(u,v), simd_evaluate=simd)
+    a.Assemble()
+    return a.mat
+
+
+def test_pml_cf_simd():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, complex=True)
+    for p in [pml.Radial(origin=(0.5,0.5), rad=0.2, alpha=1j),
+              pml.Cartesian(mins=(0.2,0.2), maxs=(0.8,0.8), alpha=0.5j),
+              pml.HalfSpace(point=(0.4,0.4), normal=(0.6,0.8), alpha=1j),
+              pml.BrickRadial(mins=(0.3,0.2), maxs=(0.7,0.8), origin=(0.5,0.5), alpha=1+1j),
+              pml.Radial(origin=(0.5,0.5), rad=0.3) + pml.Cartesian(mins=(0.1,0.1), maxs=(0.9,0.9)),
+              pml.Custom(trafo=CF((x+1j*x*x, y)), jac=CF((1+2j*x, 0, 0, 1), dims=(2,2)))]:
+        jinv, det = p.JacInv_CF, p.Det_CF
+        form = lambda u,v: det * InnerProduct(jinv*grad(u), jinv*grad(v)) + p.PML_CF[0]*u*v
+        asimd = Assemble(fes, form, True)
+        ascal = Assemble(fes, form, False)
+        asimd.AsVector().data -= ascal.AsVector()
+        assert Norm(asimd.AsVector()) < 1e-10 * Norm(ascal.AsVector())
+
+
+def test_pml_mesh_trafo():
+    from netgen.geom2d import SplineGeometry
+    geo = SplineGeometry()
+    geo.AddCircle((0,0), 1.4, leftdomain=2, bc="outer")
+    geo.AddCircle((0,0), 1, leftdomain=1, rightdomain=2)
+    geo.SetMaterial(1, "inner")
+    geo.SetMaterial(2, "pml")
+    mesh = Mesh(geo.GenerateMesh(maxh=0.2))
+    mesh.SetPML(pml.Radial(origin=(0,0), rad=1, alpha=1j), "pml")
+    fes = H1(mesh, order=3, complex=True)
+    form = lambda u,v: grad(u)*grad(v) - 10*u*v
+    # there are no complex SIMD mapped rules, PML elements are assembled by the scalar path
+    asimd = Assemble(fes, form, True)
+    ascal = Assemble(fes, form, False)
+    asimd.AsVector().data -= ascal.AsVector()
+    assert Norm(asimd.AsVector()) < 1e-10 * Norm(ascal.AsVector())
+    mesh.UnSetPML("pml")
@@ -0,0 +1,53 @@
+from netgen.geom2d import unit_square
+from netgen.csg import unit_cube
+from ngsolve import *
+
+
+def Solve(fes, a, f, pre):
+    a.Assemble()
+    f.Assemble()
+    gfu = GridFunction(fes)
+    inv = CGSolver(a.mat, pre.mat, printrates=False, precision=1e-8, maxsteps=500)
+    gfu.vec.data = inv * f.vec
+    r = f.vec.CreateVector()
+    r.data = f.vec - a.mat * gfu.vec
+    return inv.GetSteps(), Norm(r) / Norm(f.vec)
+
+
+def test_pmultigrid_h1():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    steps = {}
+    for order in [4, 8]:
+        fes = H1(mesh, order=order, dirichlet="left|bottom")
+        u,v = fes.TnT()
+        a = BilinearForm(grad(u)*grad(v)*dx)
+        f = LinearForm(x*v*dx)
+        pre = Preconditioner(a, "pmultigrid")
+        steps[order], res = Solve(fes, a, f, pre)
+        assert res < 1e-6
+    # order robust up to a mild growth
+    assert steps[8] < 2*steps[4] + 5
+
+
+def test_pmultigrid_h1amg_coarse():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=6, dirichlet="left")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*dx)
+    f = LinearForm(v*dx)
+    pre = Preconditioner(a, "pmultigrid", coarsetype="h1amg", orderstep=2)
+    steps, res = Solve(fes, a, f, pre)
+    assert res < 1e-6
+    assert steps < 60
+
+
+def test_pmultigrid_hcurl():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    fes = HCurl(mesh, order=4, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(curl(u)*curl(v)*dx + u*v*dx)
+    f = LinearForm(CoefficientFunction((1,0,0))*v*dx)
+    pre = Preconditioner(a, "pmultigrid")
+    steps, res = Solve(fes, a, f, pre)
+    assert res < 1e-6
+    assert steps < 100
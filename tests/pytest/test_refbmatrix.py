@@ -0,0 +1,52 @@
+from netgen.geom2d import unit_square
+from netgen.csg import unit_cube
+from ngsolve import *
+
+
+def Assemble(fes, form, refb):
+    u,v = fes.TnT()
+    bfi = SymbolicBFI(form(u,v))
+    bfi.reference_bmatrices = refb
+    a = BilinearForm(fes)
+    a += bfi
+    a.Assemble()
+    return a.mat.AsVector()
+
+
+def Compare(fes, form):
+    aref = Assemble(fes, form, False)
+    with TaskManager():
+        a = Assemble(fes, form, True)
+    a.data -= aref
+    assert Norm(a) < 1e-10 * Norm(aref)
+
+
+def test_refb_elasticity():
+    mu = CoefficientFunction([1, 1])
+    lam = 10
+    def elasticity(u,v):
+        eps = lambda w: Sym(grad(w))
+        return 2*mu*InnerProduct(eps(u), eps(v)) + lam*div(u)*div(v)
+
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    for order in [1, 2, 3]:
+        Compare(VectorH1(mesh, order=order), elasticity)
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    Compare(VectorH1(mesh, order=2), elasticity)
+
+
+def test_refb_mixed_forms():
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    # non-symmetric coefficient and different proxies
+    Compare(H1(mesh, order=3), lambda u,v: InnerProduct(CF((1,2,0, 0,1,0, 1,0,3), dims=(3,3))*grad(u), grad(v)) + u*v)
+    Compare(HCurl(mesh, order=2), lambda u,v: curl(u)*curl(v) + u*v)
+    Compare(HDiv(mesh, order=1), lambda u,v: div(u)*div(v) + u*v)
+
+
+def test_refb_fallback():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3)
+    # non-constant coefficient and curved elements take the standard path
+    Compare(fes, lambda u,v: (1+x*y)*grad(u)*grad(v))
+    mesh.Curve(3)
+    Compare(fes, lambda u,v: grad(u)*grad(v))
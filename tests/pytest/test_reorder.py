@@ -0,0 +1,31 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+
+def SolveEnergy(fes):
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+    f = LinearForm(v*dx).Assemble()
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    return InnerProduct(gfu.vec, f.vec), a.mat
+
+
+def Bandwidth(mat):
+    rows, cols, vals = mat.COO()
+    return max(abs(r-c) for r,c in zip(rows, cols))
+
+
+def test_reorder_orderings():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    energy, mat = SolveEnergy(fes)
+    for ordering in ["clusters", "rcm", "hilbert", "morton"]:
+        refes = Reorder(fes, ordering=ordering)
+        assert refes.ndof == fes.ndof
+        clusters = refes.GetClusters()
+        assert sum(len(c) for c in clusters) == fes.ndof
+        renergy, rmat = SolveEnergy(refes)
+        assert abs(renergy-energy) < 1e-10*abs(energy)
+        if ordering == "rcm":
+            assert Bandwidth(rmat) < Bandwidth(mat)
@@ -0,0 +1,63 @@
+import pytest
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+
+@pytest.mark.parametrize("space,cf", [(lambda m: H1(m, order=3), sin(3*x)*y),
+                                      (lambda m: HCurl(m, order=2), CF((y*x, -x*x))),
+                                      (lambda m: H1(m, order=2, dim=2), CF((x, y*y))),
+                                      (lambda m: L2(m, order=2, complex=True), 1j*x+y)])
+def test_set_cache(space, cf):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = space(mesh)
+    gfref = GridFunction(fes)
+    gf = GridFunction(fes)
+    for t in [0, 0.5, 1]:
+        gfref.Set(t*cf)
+        gf.Set(t*cf, cache=True)
+        diff = gf.vec.CreateVector()
+        diff.data = gf.vec - gfref.vec
+        assert Norm(diff) < 1e-10 * (1 + Norm(gfref.vec))
+
+
+def test_set_cache_boundary():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet="left|top")
+    gfref = GridFunction(fes)
+    gf = GridFunction(fes)
+    gfref.Set(x*x+y, BND)
+    gf.Set(x*x+y, BND, cache=True)
+    diff = gf.vec.CreateVector()
+    diff.data = gf.vec - gfref.vec
+    assert Norm(diff) < 1e-10 * Norm(gfref.vec)
+
+    gfref.Set(x*x+y, definedon=mesh.Boundaries("bottom"))
+    gf.Set(x*x+y, definedon=mesh.Boundaries("bottom"), cache=True)
+    diff.data = gf.vec - gfref.vec
+    assert Norm(diff) < 1e-10 * Norm(gfref.vec)
+
+
+def test_set_cache_refined():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=2, autoupdate=True)
+    gf = GridFunction(fes, autoupdate=True)
+    gf.Set(x*y, cache=True)
+    mesh.Refine()
+    # the cached operator is rebuilt for the refined mesh
+    gf.Set(x*y, cache=True)
+    assert abs(Integrate(gf-x*y, mesh)) < 1e-10
+
+
+def test_set_cache_released():
+    from ngsolve.comp import InterpolationCacheSize
+    import gc
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    before = InterpolationCacheSize()
+    fes = H1(mesh, order=2)
+    gf = GridFunction(fes)
+    gf.Set(x*y, cache=True)
+    assert InterpolationCacheSize() == before + 1
+    # the cache must not keep the space alive
+    del gf, fes
+    gc.collect()
+    assert InterpolationCacheSize() == before
@@ -0,0 +1,40 @@
+from netgen.csg import unit_cube
+from netgen.geom2d import unit_square
+from ngsolve import *
+import pytest
+
+
+def Evaluate(mesh, fes):
+    gfu = GridFunction(fes)
+    gfu.Set(sin(3*x)*cos(2*y)*(1+z))
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*dx)
+    a.Assemble()
+    f = LinearForm((gfu + grad(gfu)[0])*v*dx).Assemble()
+    res = gfu.vec.CreateVector()
+    res.data = a.mat * gfu.vec
+    return Integrate(gfu*gfu+grad(gfu)*grad(gfu), mesh), Norm(res), Norm(f.vec)
+
+
+@pytest.mark.parametrize("space", [H1, L2])
+@pytest.mark.parametrize("dim", [2, 3])
+def test_shapecache(space, dim):
+    if dim == 2:
+        mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    else:
+        mesh = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    fes = space(mesh, order=4)
+
+    oldsize = ngsglobals.shape_cache_max_bytes
+    try:
+        ngsglobals.shape_cache_max_bytes = 0
+        ref = Evaluate(mesh, fes)
+        ngsglobals.shape_cache_max_bytes = 1 << 28
+        cached = Evaluate(mesh, fes)
+        cached2 = Evaluate(mesh, fes)
+    finally:
+        ngsglobals.shape_cache_max_bytes = oldsize
+
+    for r, c, c2 in zip(ref, cached, cached2):
+        assert abs(r-c) < 1e-10 * abs(r)
+        assert abs(r-c2) < 1e-10 * abs(r)
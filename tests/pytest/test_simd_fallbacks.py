@@ -0,0 +1,48 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+from ngsolve.fem import SIMDFallbacks, ResetSIMDFallbacks
+
+
+def Fallbacks(where):
+    return [f for f in SIMDFallbacks() if f["where"].startswith(where)]
+
+
+def test_fallback_integrate():
+    mesh1 = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    mesh2 = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    gf = GridFunction(H1(mesh1, order=1))
+    gf.Set(x)
+
+    ResetSIMDFallbacks()
+    # a GridFunction on another mesh has no SIMD evaluation
+    val = Integrate(gf, mesh2)
+    assert abs(val - 0.5) < 1e-2
+    fallbacks = Fallbacks("Integrate")
+    assert len(fallbacks) == 1
+    assert fallbacks[0]["elements"] == mesh2.ne
+    assert "different meshes" in fallbacks[0]["what"]
+
+    ResetSIMDFallbacks()
+    assert len(Fallbacks("Integrate")) == 0
+
+
+def test_fallback_integrator():
+    mesh1 = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    mesh2 = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    gf = GridFunction(H1(mesh1, order=1))
+    gf.Set(1)
+
+    ResetSIMDFallbacks()
+    fes = H1(mesh2, order=1)
+    v = fes.TestFunction()
+    f = LinearForm(gf*v*dx).Assemble()
+    assert abs(sum(f.vec) - 1) < 1e-8
+    fallbacks = Fallbacks("Symbolic LFI")
+    assert len(fallbacks) == 1
+    assert fallbacks[0]["elements"] == mesh2.ne
+    assert "SIMD fallback" in str(f)
+
+    # SIMD capable forms are not reported
+    ResetSIMDFallbacks()
+    LinearForm(x*v*dx).Assemble()
+    assert len(SIMDFallbacks()) == 0
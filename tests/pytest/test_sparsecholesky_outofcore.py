@@ -0,0 +1,44 @@
+import os
+import pytest
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+
+def MappedScratchFiles(path):
+    # the scratch file is unlinked right after creation, the mapping keeps its name
+    with open("/proc/self/maps") as f:
+        return [l for l in f if os.path.join(str(path), "ngs_factor_") in l]
+
+
+@pytest.mark.skipif(not os.path.exists("/proc/self/maps"), reason="needs /proc/self/maps")
+def test_sparsecholesky_outofcore(tmp_path):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx + u*v*dx, symmetric=True).Assemble()
+    f = LinearForm(x*v*dx).Assemble()
+
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f.vec
+
+    ngsglobals.sparsecholesky_scratchdir = str(tmp_path)
+    try:
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+        assert len(MappedScratchFiles(tmp_path)) > 0
+        gfu2 = GridFunction(fes)
+        gfu2.vec.data = inv * f.vec
+        # refactor into the same scratch file
+        a.Assemble()
+        inv.Update()
+        gfu3 = GridFunction(fes)
+        gfu3.vec.data = inv * f.vec
+        assert len(MappedScratchFiles(tmp_path)) > 0
+        del inv
+        assert len(MappedScratchFiles(tmp_path)) == 0
+    finally:
+        ngsglobals.sparsecholesky_scratchdir = ""
+
+    for g in (gfu2, gfu3):
+        diff = g.vec.CreateVector()
+        diff.data = g.vec - gfu.vec
+        assert Norm(diff) < 1e-10 * Norm(gfu.vec)
@@ -0,0 +1,56 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+
+def RelResidual(mat, inv, f, freedofs, trans=False):
+    u = f.CreateVector()
+    r = f.CreateVector()
+    if trans:
+        u.data = inv.T * f
+        r.data = f - mat.T * u
+    else:
+        u.data = inv * f
+        r.data = f - mat * u
+    for i in range(len(r)):
+        if not freedofs[i]:
+            r[i] = 0
+    return Norm(r) / Norm(f)
+
+
+def test_sparselu_convection():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    a = BilinearForm(0.01*grad(u)*grad(v)*dx + (CF((1,0.5))*grad(u))*v*dx).Assemble()
+    f = LinearForm(v*dx).Assemble()
+
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparselu")
+    assert RelResidual(a.mat, inv, f.vec, fes.FreeDofs()) < 1e-10
+    assert RelResidual(a.mat, inv, f.vec, fes.FreeDofs(), trans=True) < 1e-10
+
+
+def test_sparselu_stokes():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    V = VectorH1(mesh, order=2, dirichlet=".*")
+    Q = H1(mesh, order=1)
+    N = NumberSpace(mesh)
+    X = V*Q*N
+    (u,p,lam), (v,q,mu) = X.TnT()
+    a = BilinearForm(InnerProduct(grad(u),grad(v))*dx - div(u)*q*dx - div(v)*p*dx
+                     + p*mu*dx + q*lam*dx).Assemble()
+    f = LinearForm(CF((x,y))*v*dx).Assemble()
+
+    inv = a.mat.Inverse(X.FreeDofs(), inverse="sparselu")
+    assert RelResidual(a.mat, inv, f.vec, X.FreeDofs()) < 1e-10
+
+
+def test_sparselu_helmholtz():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    fes = H1(mesh, order=3, complex=True)
+    u,v = fes.TnT()
+    k = 20
+    a = BilinearForm(grad(u)*grad(v)*dx - k*k*u*v*dx - 1j*k*u*v*ds).Assemble()
+    f = LinearForm(exp(-100*((x-0.5)**2+(y-0.5)**2))*v*dx).Assemble()
+
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparselu")
+    assert RelResidual(a.mat, inv, f.vec, fes.FreeDofs()) < 1e-10
@@ -0,0 +1,23 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+def test_timerwork():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(grad(u)*grad(v)*dx).Assemble()
+
+    x = a.mat.CreateColVector()
+    y = a.mat.CreateColVector()
+    x[:] = 1
+
+    ResetTimers()
+    for i in range(10):
+        y.data = a.mat * x
+
+    timer = [t for t in Timers() if t["name"] == "SparseMatrix::MultAdd"][0]
+    nze = a.mat.nze
+    assert timer["counts"] == 10
+    assert timer["flops"] == 10 * 2 * nze
+    assert timer["bytes"] >= 10 * nze * 12
+    assert "GB/s" in timer
@@ -0,0 +1,440 @@
+/*
+  Micro-benchmarks for the hot kernels.
+
+  All inputs are generated deterministically, results are written in the
+  same json format as timings.py, such that compare.py can be used to
+  compare two runs.
+
+  usage:  ngs_benchmarks [-o results.json] [-p nthreads] [-t mintime] [category ...]
+*/
+
+#include <comp.hpp>
+#include <thread>
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+using namespace ngcomp;
+
+namespace ngs_benchmarks
+{
+  struct Results
+  {
+    // category -> list of entries, entries are (key, json-value) pairs
+    std::map<string, std::vector<std::vector<std::pair<string,string>>>> timings;
+    int nthreads = 1;
+    double mintime = 0.2;
+    Array<string> categories;
+
+    bool Enabled (const string & category) const
+    {
+      return categories.Size() == 0 || categories.Contains(category);
+    }
+
+    void Add (const string & category, std::vector<std::pair<string,string>> entry, double time)
+    {
+      entry.push_back ( { "time", ToString(time) } );
+      entry.push_back ( { "taskmanager", ToString(int(nthreads > 1)) } );
+      entry.push_back ( { "nthreads", ToString(nthreads) } );
+      cout << category;
+      for (auto & [key,val] : entry)
+        cout << ", " << key << " = " << val;
+      cout << endl;
+      timings[category].push_back(entry);
+    }
+  };
+
+  // JSON string literal, escapes quotes, backslashes and control characters
+  string Quote (const string & s)
+  {
+    const char * hex = "0123456789abcdef";
+    string res = "\"";
+    for (unsigned char c : s)
+      switch (c)
+        {
+        case '"':  res += "\\\""; break;
+        case '\\': res += "\\\\"; break;
+        case '\n': res += "\\n"; break;
+        case '\r': res += "\\r"; break;
+        case '\t': res += "\\t"; break;
+        default:
+          if (c < 0x20)
+            {
+              res += "\\u00";
+              res += hex[c >> 4];
+              res += hex[c & 15];
+            }
+          else
+            res += c;
+        }
+    return res + "\"";
+  }
+
+  // time per call, minimum over three runs of at least mintime/3 each
+  template <typename FUNC>
+  double TimeIt (FUNC f, double mintime)
+  {
+    f();
+    size_t runs = 1;
+    while (true)
+      {
+        double start = WallTime();
+        for (size_t i = 0; i < runs; i++) f();
+        double time = WallTime()-start;
+        if (time > mintime/3) break;
+        runs *= 2;
+      }
+
+    double best = 1e99;
+    for (int k = 0; k < 3; k++)
+      {
+        double start = WallTime();
+        for (size_t i = 0; i < runs; i++) f();
+        best = min(best, (WallTime()-start) / runs);
+      }
+    return best;
+  }
+
+  void SetValues (SliceMatrix<> mat)
+  {
+    for (size_t i = 0; i < mat.Height(); i++)
+      for (size_t j = 0; j < mat.Width(); j++)
+        mat(i,j) = sin(2+3*i+5*j);
+  }
+
+
+
+  void BenchNgblas (Results & res)
+  {
+    // all sizes handled by the dispatch tables, plus some larger ones
+    Array<int> sizes;
+    for (int i = 1; i <= 24; i++) sizes.Append(i);
+    for (int i : { 32, 48, 64, 128, 256 }) sizes.Append(i);
+
+    for (int n : sizes)
+      {
+        Matrix<> a(n,n), b(n,n), c(n,n);
+        Vector<> d(n);
+        SetValues (a); SetValues (b);
+        for (int i = 0; i < n; i++) d(i) = 1+0.1*i;
+
+        auto entry = [&] (string name)
+          {
+            return std::vector<std::pair<string,string>>
+              { { "name", Quote(name) }, { "n", ToString(n) }, { "flops", ToString(2.0*n*n*n) } };
+          };
+
+        res.Add ("ngblas", entry("MultMatMat"),
+                 TimeIt ([&] () { MultMatMat (a, b, c); }, res.mintime));
+        res.Add ("ngblas", entry("AddABt"),
+                 TimeIt ([&] () { AddABt (a, b, c); }, res.mintime));
+        res.Add ("ngblas", entry("SubAtDB"),
+                 TimeIt ([&] () { SubAtDB (a, d, b, c); }, res.mintime));
+      }
+
+    // thin matrices as they appear in element matrix computation
+    for (int n : { 4, 10, 20, 35, 56, 84 })
+      for (int k : { 16, 64, 256 })
+        {
+          Matrix<> a(n,k), b(n,k), c(n,n);
+          SetValues (a); SetValues (b);
+          res.Add ("ngblas", { { "name", Quote("AddABt") }, { "n", ToString(n) }, { "k", ToString(k) },
+                               { "flops", ToString(2.0*n*n*k) } },
+                   TimeIt ([&] () { AddABt (a, b, c); }, res.mintime));
+        }
+  }
+
+
+
+  template <typename TM> TM DiagEntry (double val)
+  {
+    if constexpr (mat_traits<TM>::HEIGHT == 1)
+      return TM(val);
+    else
+      {
+        TM m = 0.0;
+        for (int i = 0; i < mat_traits<TM>::HEIGHT; i++)
+          m(i,i) = val;
+        return m;
+      }
+  }
+
+  // 7-point stencil on a n^3 grid, diagonal dominant
+  template <typename TM>
+  shared_ptr<SparseMatrix<TM>> CreateLaplace3D (int n)
+  {
+    int N = n*n*n;
+    auto index = [n] (int i, int j, int k) { return i+n*(j+n*k); };
+    auto neighbours = [&] (int i, int j, int k, auto f)
+      {
+        f (index(i,j,k));
+        if (i > 0) f (index(i-1,j,k));
+        if (i < n-1) f (index(i+1,j,k));
+        if (j > 0) f (index(i,j-1,k));
+        if (j < n-1) f (index(i,j+1,k));
+        if (k > 0) f (index(i,j,k-1));
+        if (k < n-1) f (index(i,j,k+1));
+      };
+
+    Array<int> cnt(N);
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+          {
+            cnt[index(i,j,k)] = 0;
+            neighbours (i, j, k, [&] (int col) { cnt[index(i,j,k)]++; });
+          }
+
+    auto mat = make_shared<SparseMatrix<TM>> (cnt, N);
+    for (int k = 0; k < n; k++)
+      for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+          neighbours (i, j, k, [&] (int col) { mat->CreatePosition (index(i,j,k), col); });
+
+    for (int row = 0; row < N; row++)
+      for (int col : mat->GetRowIndices(row))
+        (*mat)(row, col) = DiagEntry<TM> (row == col ? 6.1 : -1);
+    return mat;
+  }
+
+
+  template <typename TM>
+  void BenchSpMV (Results & res, string tname, int n)
+  {
+    auto mat = CreateLaplace3D<TM> (n);
+    auto x = mat->CreateColVector();
+    auto y = mat->CreateRowVector();
+    x = 1.0;
+
+    size_t entrysize = sizeof(TM);
+    double bytes = mat->NZE() * (entrysize + sizeof(int)) + 2.0 * mat->Height() * sizeof(typename mat_traits<TM>::TV_ROW);
+    res.Add ("SpMV", { { "name", Quote("Mult") }, { "type", Quote(tname) },
+                       { "n", ToString(mat->Height()) }, { "nze", ToString(mat->NZE()) },
+                       { "bytes", ToString(bytes) } },
+             TimeIt ([&] () { mat->Mult (*x, *y); }, res.mintime));
+    res.Add ("SpMV", { { "name", Quote("MultTransAdd") }, { "type", Quote(tname) },
+                       { "n", ToString(mat->Height()) }, { "nze", ToString(mat->NZE()) },
+                       { "bytes", ToString(bytes) } },
+             TimeIt ([&] () { mat->MultTransAdd (1.0, *x, *y); }, res.mintime));
+  }
+
+
+  void BenchSparseCholesky (Results & res)
+  {
+    for (int n : { 10, 20, 30 })
+      {
+        auto mat = CreateLaplace3D<double> (n);
+        mat->SetInverseType (SPARSECHOLESKY);
+        auto x = mat->CreateColVector();
+        auto y = mat->CreateRowVector();
+        x = 1.0;
+
+        shared_ptr<BaseMatrix> inv;
+        res.Add ("SparseCholesky", { { "name", Quote("Factor") }, { "n", ToString(mat->Height()) } },
+                 TimeIt ([&] () { inv = mat->InverseMatrix(); }, res.mintime));
+        res.Add ("SparseCholesky", { { "name", Quote("Solve") }, { "n", ToString(mat->Height()) } },
+                 TimeIt ([&] () { inv->Mult (*x, *y); }, res.mintime));
+      }
+  }
+
+
+  void BenchBlockJacobi (Results & res)
+  {
+    int n = 40;
+    auto mat = CreateLaplace3D<double> (n);
+
+    // line blocks in x-direction
+    TableCreator<int> creator(n*n);
+    for ( ; !creator.Done(); creator++)
+      for (int i = 0; i < n*n*n; i++)
+        creator.Add (i / n, i);
+    auto blocks = make_shared<Table<int>> (creator.MoveTable());
+
+    auto pre = mat->CreateBlockJacobiPrecond (blocks);
+    auto x = mat->CreateColVector();
+    auto b = mat->CreateRowVector();
+    auto y = mat->CreateRowVector();
+    b = 1.0;
+    x = 0.0;
+
+    res.Add ("BlockJacobi", { { "name", Quote("Mult") }, { "n", ToString(mat->Height()) } },
+             TimeIt ([&] () { pre->Mult (*b, *y); }, res.mintime));
+    res.Add ("BlockJacobi", { { "name", Quote("GSSmooth") }, { "n", ToString(mat->Height()) } },
+             TimeIt ([&] () { pre->GSSmooth (*x, *b); }, res.mintime));
+    res.Add ("BlockJacobi", { { "name", Quote("GSSmoothBack") }, { "n", ToString(mat->Height()) } },
+             TimeIt ([&] () { pre->GSSmoothBack (*x, *b); }, res.mintime));
+  }
+
+
+  void BenchAssembly (Results & res, LocalHeap & lh)
+  {
+    // mesh files are copied from tests/catch, refinement gives fixed sizes
+    for (auto [meshfile, eltype, nref] : { std::tuple("square.vol", "trig", 4),
+                                           std::tuple("cube.vol", "tet", 3) })
+      {
+        auto ma = make_shared<MeshAccess> (meshfile);
+        for (int i = 0; i < nref; i++)
+          ma->Refine(true);
+
+        for (int order : { 1, 2, 4, 6 })
+          for (string fesname : { "h1ho", "hcurlho", "l2ho" })
+            {
+              Flags flags;
+              flags.SetFlag ("order", order);
+              auto fes = CreateFESpace (fesname, ma, flags);
+              fes->Update();
+              fes->FinalizeUpdate();
+
+              auto u = fes->GetTrialFunction();
+              auto v = fes->GetTestFunction();
+              shared_ptr<CoefficientFunction> form = InnerProduct(u, v);
+              if (fesname == "h1ho")
+                form = InnerProduct(u->Deriv(), v->Deriv()) + form;
+              if (fesname == "hcurlho")
+                form = InnerProduct(u->Deriv(), v->Deriv()) + form;
+
+              auto bf = CreateBilinearForm (fes, "a", Flags());
+              bf->AddIntegrator (make_shared<SymbolicBilinearFormIntegrator> (form, VOL, VOL));
+              bf->Assemble(lh);
+
+              res.Add ("Assembly", { { "name", Quote("SymbolicBFI") }, { "element", Quote(eltype) },
+                                     { "fespace", Quote(fesname) }, { "order", ToString(order) },
+                                     { "ne", ToString(ma->GetNE(VOL)) }, { "ndof", ToString(fes->GetNDof()) } },
+                       TimeIt ([&] () { bf->Assemble(lh); }, res.mintime));
+            }
+      }
+  }
+
+
+  void BenchCoefficientFunction (Results & res, LocalHeap & lh)
+  {
+    auto x = MakeCoordinateCoefficientFunction(0);
+    auto y = MakeCoordinateCoefficientFunction(1);
+    auto z = MakeCoordinateCoefficientFunction(2);
+    shared_ptr<CoefficientFunction> c = make_shared<ConstantCoefficientFunction>(3);
+
+    std::vector<std::pair<string, shared_ptr<CoefficientFunction>>> cfs =
+      { { "coordinate", x },
+        { "polynomial", x*y + z*z*x + c*y*z },
+        { "vector", MakeVectorialCoefficientFunction ( { x*y, y*z, z*x } ) } };
+
+    FE_ElementTransformation<3,3> trafo(ET_TET);
+    for (int order : { 2, 6 })
+      {
+        SIMD_IntegrationRule simd_ir(ET_TET, order);
+        SIMD_MappedIntegrationRule<3,3> simd_mir(simd_ir, trafo, lh);
+        IntegrationRule ir(ET_TET, order);
+        MappedIntegrationRule<3,3> mir(ir, trafo, lh);
+
+        for (auto [name, cf] : cfs)
+          {
+            Matrix<SIMD<double>> simd_values(cf->Dimension(), simd_ir.Size());
+            Matrix<> values(ir.Size(), cf->Dimension());
+            res.Add ("CoefficientFunction", { { "name", Quote(name) }, { "simd", "1" },
+                                              { "order", ToString(order) }, { "npoints", ToString(ir.Size()) } },
+                     TimeIt ([&] () { cf->Evaluate (simd_mir, simd_values); }, res.mintime));
+            res.Add ("CoefficientFunction", { { "name", Quote(name) }, { "simd", "0" },
+                                              { "order", ToString(order) }, { "npoints", ToString(ir.Size()) } },
+                     TimeIt ([&] () { cf->Evaluate (mir, values); }, res.mintime));
+          }
+      }
+  }
+
+
+  void WriteJson (const Results & res, ostream & ost)
+  {
+    ost << "{" << endl;
+    if (auto ref = getenv("CI_BUILD_REF"))
+      ost << "  \"commit\": " << Quote(ref) << "," << endl;
+    ost << "  \"version\": -1," << endl;
+
+    char hostname[256] = "unknown";
+#ifndef WIN32
+    gethostname (hostname, sizeof(hostname));
+    hostname[sizeof(hostname)-1] = 0;   // not terminated if truncated
+#endif
+    ost << "  \"build\": { "
+        << "\"compiler\": " << Quote(NGS_BENCHMARK_COMPILER) << ", "
+        << "\"cxx_flags\": " << Quote(NGS_BENCHMARK_CXX_FLAGS) << ", "
+        << "\"hostname\": " << Quote(hostname) << ", "
+        << "\"ncpus\": " << std::thread::hardware_concurrency() << " }," << endl;
+
+    ost << "  \"timings\": {";
+    bool firstcat = true;
+    for (auto & [category, entries] : res.timings)
+      {
+        ost << (firstcat ? "" : ",") << endl << "    " << Quote(category) << ": [";
+        firstcat = false;
+        for (size_t i = 0; i < entries.size(); i++)
+          {
+            ost << (i ? "," : "") << endl << "      {";
+            for (size_t j = 0; j < entries[i].size(); j++)
+              ost << (j ? ", " : " ") << Quote(entries[i][j].first) << ": " << entries[i][j].second;
+            ost << " }";
+          }
+        ost << endl << "    ]";
+      }
+    ost << endl << "  }" << endl << "}" << endl;
+  }
+}
+
+
+int main (int argc, char ** argv)
+{
+  using namespace ngs_benchmarks;
+
+  Results res;
+  string filename = "results_benchmarks.json";
+  for (int i = 1; i < argc; i++)
+    {
+      string arg = argv[i];
+      if (arg == "-o" && i+1 < argc)
+        filename = argv[++i];
+      else if (arg == "-p" && i+1 < argc)
+        res.nthreads = atoi(argv[++i]);
+      else if (arg == "-t" && i+1 < argc)
+        res.mintime = atof(argv[++i]);
+      else
+        res.categories.Append (arg);
+    }
+
+  netgen::printmessage_importance = 0;
+  LocalHeap lh(100*1000*1000, "benchmarks", true);
+
+  auto run = [&] ()
+    {
+      if (res.Enabled("ngblas")) BenchNgblas (res);
+      if (res.Enabled("SpMV"))
+        {
+          BenchSpMV<double> (res, "double", 40);
+          BenchSpMV<Complex> (res, "Complex", 40);
+          BenchSpMV<Mat<2,2>> (res, "Mat<2,2>", 30);
+          BenchSpMV<Mat<3,3>> (res, "Mat<3,3>", 24);
+        }
+      if (res.Enabled("SparseCholesky")) BenchSparseCholesky (res);
+      if (res.Enabled("BlockJacobi")) BenchBlockJacobi (res);
+      if (res.Enabled("Assembly")) BenchAssembly (res, lh);
+      if (res.Enabled("CoefficientFunction")) BenchCoefficientFunction (res, lh);
+    };
+
+  try
+    {
+      if (res.nthreads > 1)
+        {
+          TaskManager::SetNumThreads (res.nthreads);
+          RunWithTaskManager (run);
+        }
+      else
+        run();
+    }
+  catch (Exception & e)
+    {
+      cerr << "Caught exception: " << e.What() << endl;
+      return EXIT_FAILURE;
+    }
+
+  ofstream out(filename);
+  WriteJson (res, out);
+  cout << "results written to " << filename << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+import json
+import argparse
+
+parser = argparse.ArgumentParser(description='Compare two timing results (from timings.py or ngs_benchmarks)')
+parser.add_argument('old', help='reference results file')
+parser.add_argument('new', help='new results file')
+parser.add_argument('-t', '--threshold', type=float, default=0.1, help='relative slowdown reported as regression (default 0.1)')
+parser.add_argument('-a', '--all', action="store_true", help='print all comparisons, not only regressions')
+
+args = parser.parse_args()
+
+# keys which are results, not part of the identification of a measurement
+result_keys = ['time']
+
+def load(filename):
+    timings = json.load(open(filename,'r'))['timings']
+    res = {}
+    for category, entries in timings.items():
+        for entry in entries:
+            key = (category,) + tuple(sorted((k,str(v)) for k,v in entry.items() if k not in result_keys))
+            res[key] = entry['time']
+    return res
+
+def describe(key):
+    return key[0] + ": " + ", ".join(k+"="+v for k,v in key[1:])
+
+old = load(args.old)
+new = load(args.new)
+
+regressions = 0
+for key in sorted(old.keys() & new.keys()):
+    if old[key] <= 0:
+        continue
+    ratio = new[key]/old[key]
+    if ratio > 1+args.threshold:
+        regressions += 1
+        print("REGRESSION  {:6.2f}x  {}".format(ratio, describe(key)))
+    elif args.all:
+        print("            {:6.2f}x  {}".format(ratio, describe(key)))
+
+missing = old.keys() - new.keys()
+if missing:
+    print(len(missing), "measurements missing in", args.new)
+
+print(regressions, "regressions out of", len(old.keys() & new.keys()), "measurements")
+exit(1 if regressions else 0)